@@ -0,0 +1,189 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include "./Game.h"
+#include "./GameParser.h"
+#include "./IslandIndex.h"
+#include "./Solver.h"
+#include "./SatEngine.h"
+
+// _____________________________________________________________________________
+
+// Creates a random board with the given dimensions where roughly
+// the given fraction of the cells contains an Island
+std::vector<Island> createBoard(uint32_t width, uint32_t height,
+  double fillRatio, std::mt19937* random) {
+  std::bernoulli_distribution hasIsland(fillRatio);
+  std::vector<Island> islands;
+  for (uint32_t y = 0; y < height; y++) {
+    for (uint32_t x = 0; x < width; x++) {
+      if (hasIsland(*random)) {
+        islands.push_back(Island(x, y, 1));
+      }
+    }
+  }
+  return islands;
+}
+
+// _____________________________________________________________________________
+
+// Walks over every cell of the board as often as requested and looks up
+// the Island at each position, returns the nanoseconds per lookup
+template<typename Lookup>
+double measure(uint32_t width, uint32_t height, uint32_t rounds,
+  const Lookup &lookup, uint64_t* checksum) {
+  auto start = std::chrono::high_resolution_clock::now();
+  for (uint32_t round = 0; round < rounds; round++) {
+    for (uint32_t y = 0; y < height; y++) {
+      for (uint32_t x = 0; x < width; x++) {
+        Island* island = lookup(x, y);
+        if (island != nullptr) {
+          *checksum += island->_x;
+        }
+      }
+    }
+  }
+  auto time = std::chrono::high_resolution_clock::now() - start;
+  double lookups = static_cast<double>(width) * height * rounds;
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count()
+    / lookups;
+}
+
+// _____________________________________________________________________________
+
+// Compares the island lookup of both IslandIndex layouts against
+// the unordered_map based lookup the Game class used to have
+void benchmarkIslandIndex(uint32_t rounds) {
+  std::mt19937 random(42);
+  std::cout << "Island lookup in ns per cell" << std::endl;
+  std::cout << std::setw(12) << "board" << std::setw(8) << "fill"
+            << std::setw(10) << "auto" << std::setw(12) << "map"
+            << std::setw(10) << "dense" << std::setw(10) << "sparse"
+            << std::endl;
+  for (uint32_t size : { 25, 100, 400 }) {
+    for (double fillRatio : { 0.25, 0.05, 0.01 }) {
+      auto board = createBoard(size, size, fillRatio, &random);
+      Game dense(board, IslandIndex::Layout::DENSE);
+      Game sparse(board, IslandIndex::Layout::SPARSE);
+      std::unordered_map<uint32_t, Island*> map;
+      for (const auto &island : dense.getIslands()) {
+        map[island->_x + island->_y * size] = island;
+      }
+      auto layout = IslandIndex::chooseLayout(board.size(), size, size);
+
+      uint64_t checksum = 0;
+      // scale down the rounds, so every board takes roughly the same time
+      uint32_t boardRounds = std::max(1u, rounds * 100 / size);
+      double mapTime = measure(size, size, boardRounds,
+        [&map, size](uint32_t x, uint32_t y) -> Island* {
+          uint32_t key = x + y * size;
+          if (map.count(key)) {
+            return map.at(key);
+          }
+          return nullptr;
+        }, &checksum);
+      double denseTime = measure(size, size, boardRounds,
+        [&dense](uint32_t x, uint32_t y) { return dense.getIsland(x, y); },
+        &checksum);
+      double sparseTime = measure(size, size, boardRounds,
+        [&sparse](uint32_t x, uint32_t y) { return sparse.getIsland(x, y); },
+        &checksum);
+
+      std::cout << std::setw(12) << std::to_string(size) + "x"
+                   + std::to_string(size)
+                << std::setw(8) << fillRatio
+                << std::setw(10)
+                << (layout == IslandIndex::Layout::DENSE ? "dense" : "sparse")
+                << std::fixed << std::setprecision(2)
+                << std::setw(12) << mapTime << std::setw(10) << denseTime
+                << std::setw(10) << sparseTime
+                << std::defaultfloat << std::setprecision(6)
+                << "  (checksum " << checksum << ")" << std::endl;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+// Solves every given riddle once with every branching strategy and
+// compares the size of the search trees
+void benchmarkBranching(const std::vector<std::string> &files) {
+  std::cout << "Search tree per branching strategy over " << files.size()
+            << " riddles" << std::endl;
+  std::cout << std::setw(12) << "branching" << std::setw(8) << "solved"
+            << std::setw(12) << "nodes" << std::setw(12) << "backtracks"
+            << std::setw(12) << "ms" << std::endl;
+  for (Solver::Branching branching : { Solver::Branching::INPUT,
+    Solver::Branching::MOST_CONSTRAINED, Solver::Branching::FEWEST_OPTIONS,
+    Solver::Branching::MAX_DEGREE }) {
+    uint64_t solved = 0;
+    uint64_t nodes = 0;
+    uint64_t backtracks = 0;
+    std::chrono::nanoseconds time(0);
+    for (const auto &file : files) {
+      Game game = GameParser::autoParse(file);
+      Solver solver(&game, branching);
+      auto start = std::chrono::high_resolution_clock::now();
+      solved += solver.solve();
+      time += std::chrono::high_resolution_clock::now() - start;
+      nodes += solver.statistics().nodes;
+      backtracks += solver.statistics().backtracks;
+    }
+    std::cout << std::setw(12) << Solver::branchingName(branching)
+              << std::setw(8) << solved << std::setw(12) << nodes
+              << std::setw(12) << backtracks << std::setw(12)
+              << std::chrono::duration_cast<std::chrono::milliseconds>(time)
+                 .count()
+              << std::endl;
+  }
+}
+
+// _____________________________________________________________________________
+
+// Solves the riddles with the SAT engine, conflicts are its backtracks
+void benchmarkSat(const std::vector<std::string> &files) {
+  uint64_t solved = 0;
+  uint64_t decisions = 0;
+  uint64_t conflicts = 0;
+  std::chrono::nanoseconds time(0);
+  for (const auto &file : files) {
+    Game game = GameParser::autoParse(file);
+    auto start = std::chrono::high_resolution_clock::now();
+    SatEngine engine(&game);
+    solved += engine.solve();
+    time += std::chrono::high_resolution_clock::now() - start;
+    decisions += engine.statistics().decisions;
+    conflicts += engine.statistics().conflicts;
+  }
+  std::cout << std::setw(12) << "sat" << std::setw(8) << solved
+            << std::setw(12) << decisions << std::setw(12) << conflicts
+            << std::setw(12)
+            << std::chrono::duration_cast<std::chrono::milliseconds>(time)
+               .count()
+            << std::endl;
+}
+
+// _____________________________________________________________________________
+
+// Benchmarks for the performance critical data structures, riddles
+// passed after the rounds are used to compare the branching strategies
+// and the SAT engine
+int main(int argc, char** argv) {
+  uint32_t rounds = 10;
+  if (argc >= 2) {
+    rounds = std::stoi(argv[1]);
+  }
+  benchmarkIslandIndex(rounds);
+  if (argc > 2) {
+    std::cout << std::endl;
+    std::vector<std::string> files(argv + 2, argv + argc);
+    benchmarkBranching(files);
+    benchmarkSat(files);
+  }
+}
@@ -0,0 +1,119 @@
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "./Components.h"
+
+const uint32_t Components::NONE;
+
+// _____________________________________________________________________________
+
+Components::Components(size_t count):
+  _parent(count), _size(count, 1), _ownCapacity(count, 0),
+  _capacity(count, 0), _count(count) {
+  for (size_t i = 0; i < count; i++) {
+    _parent[i] = i;
+  }
+}
+
+// _____________________________________________________________________________
+
+uint32_t Components::find(uint32_t element) const {
+  while (_parent[element] != element) {
+    element = _parent[element];
+  }
+  return element;
+}
+
+// _____________________________________________________________________________
+
+bool Components::unite(uint32_t one, uint32_t two) {
+  one = find(one);
+  two = find(two);
+  if (one == two) {
+    _history.push_back(NONE);
+    return false;
+  }
+  if (_size[one] < _size[two]) {
+    std::swap(one, two);
+  }
+  _parent[two] = one;
+  _size[one] += _size[two];
+  _capacity[one] += _capacity[two];
+  _history.push_back(two);
+  _count--;
+  return true;
+}
+
+// _____________________________________________________________________________
+
+void Components::rollback() {
+  uint32_t child = _history.back();
+  _history.pop_back();
+  if (child == NONE) {
+    return;
+  }
+  uint32_t root = _parent[child];
+  _parent[child] = child;
+  _size[root] -= _size[child];
+  _capacity[root] -= _capacity[child];
+  _count++;
+}
+
+// _____________________________________________________________________________
+
+void Components::reset() {
+  for (size_t i = 0; i < _parent.size(); i++) {
+    _parent[i] = i;
+    _size[i] = 1;
+    _capacity[i] = _ownCapacity[i];
+  }
+  _history.clear();
+  _count = _parent.size();
+}
+
+// _____________________________________________________________________________
+
+void Components::setCapacity(uint32_t element, uint32_t capacity) {
+  // Every tree stores the sum of its subtree, so a rollback can subtract
+  // the subtree of the detached root without recounting anything
+  uint32_t previous = _ownCapacity[element];
+  _ownCapacity[element] = capacity;
+  while (true) {
+    _capacity[element] += capacity;
+    _capacity[element] -= previous;
+    if (_parent[element] == element) {
+      break;
+    }
+    element = _parent[element];
+  }
+}
+
+// _____________________________________________________________________________
+
+uint32_t Components::ownCapacity(uint32_t element) const {
+  return _ownCapacity[element];
+}
+
+// _____________________________________________________________________________
+
+uint64_t Components::capacity(uint32_t element) const {
+  return _capacity[find(element)];
+}
+
+// _____________________________________________________________________________
+
+uint32_t Components::size(uint32_t element) const {
+  return _size[find(element)];
+}
+
+// _____________________________________________________________________________
+
+size_t Components::count() const {
+  return _count;
+}
+
+// _____________________________________________________________________________
+
+size_t Components::historySize() const {
+  return _history.size();
+}
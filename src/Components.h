@@ -0,0 +1,78 @@
+#ifndef COMPONENTS_H_
+#define COMPONENTS_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// Union-find over the elements 0 to n - 1 that can undo its merges in
+// reverse order. There is no path compression, so every merge is a single
+// pointer write and rolling it back is as cheap, the depth of the trees
+// stays logarithmic because the smaller tree is always attached below
+// the larger one.
+// Every element carries a non-negative capacity and every component
+// knows the sum of the capacities of its elements
+class Components {
+  FRIEND_TEST(ComponentsTest, constructor);
+  FRIEND_TEST(ComponentsTest, unite);
+
+ public:
+  // Creates n components with a single element and no capacity each
+  explicit Components(size_t);
+
+  // Returns the representative element of the component of the element
+  uint32_t find(uint32_t) const;
+
+  // Merges the components of both elements, returns false if they
+  // already were in the same component. Every call can be undone
+  // by rollback, even if nothing has been merged
+  bool unite(uint32_t, uint32_t);
+
+  // Undoes the last call of unite that hasn't been undone yet
+  void rollback();
+
+  // Splits all components into single elements again and forgets all
+  // merges, the capacities of the elements are kept
+  void reset();
+
+  // Changes the capacity of the element to the given value
+  void setCapacity(uint32_t, uint32_t);
+
+  // Returns the capacity of the element itself
+  uint32_t ownCapacity(uint32_t) const;
+
+  // Returns the sum of the capacities in the component of the element
+  uint64_t capacity(uint32_t) const;
+
+  // Returns the amount of elements in the component of the element
+  uint32_t size(uint32_t) const;
+
+  // Returns the current amount of components
+  size_t count() const;
+
+  // Returns how many calls of unite can currently be undone
+  size_t historySize() const;
+
+ private:
+  // marks a history entry where nothing has been merged
+  static const uint32_t NONE = UINT32_MAX;
+
+  // the parent of every element, roots are their own parent
+  std::vector<uint32_t> _parent;
+  // elements in the tree below every element, including itself
+  std::vector<uint32_t> _size;
+  // the capacity of every element itself
+  std::vector<uint32_t> _ownCapacity;
+  // sum of the capacities in the tree below every element
+  std::vector<uint64_t> _capacity;
+  // the root that has been attached below another root for every
+  // call of unite, or NONE
+  std::vector<uint32_t> _history;
+  // current amount of components
+  size_t _count;
+};
+
+#endif  // COMPONENTS_H_
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include "./Components.h"
+
+// _____________________________________________________________________________
+
+TEST(ComponentsTest, constructor) {
+  Components components(4);
+  EXPECT_EQ(4, components.count());
+  EXPECT_EQ(0, components.historySize());
+  for (uint32_t i = 0; i < 4; i++) {
+    EXPECT_EQ(i, components.find(i));
+    EXPECT_EQ(1, components.size(i));
+    EXPECT_EQ(0, components.capacity(i));
+    EXPECT_EQ(i, components._parent[i]);
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(ComponentsTest, unite) {
+  Components components(5);
+  EXPECT_TRUE(components.unite(0, 1));
+  EXPECT_TRUE(components.unite(2, 3));
+  EXPECT_TRUE(components.unite(1, 3));
+  EXPECT_FALSE(components.unite(0, 2));
+  EXPECT_EQ(4, components.historySize());
+  EXPECT_EQ(2, components.count());
+  EXPECT_EQ(components.find(0), components.find(3));
+  EXPECT_NE(components.find(0), components.find(4));
+  EXPECT_EQ(4, components.size(2));
+  EXPECT_EQ(1, components.size(4));
+  // Only one pointer per merge, so the trees stay flat
+  uint32_t root = components.find(0);
+  for (uint32_t i = 0; i < 4; i++) {
+    EXPECT_LE(components._parent[components._parent[i]], 3);
+    EXPECT_EQ(root, components.find(i));
+  }
+
+  components.rollback();
+  EXPECT_EQ(2, components.count());
+  components.rollback();
+  EXPECT_EQ(3, components.count());
+  EXPECT_EQ(components.find(0), components.find(1));
+  EXPECT_EQ(components.find(2), components.find(3));
+  EXPECT_NE(components.find(0), components.find(2));
+  EXPECT_EQ(2, components.size(3));
+
+  components.reset();
+  EXPECT_EQ(5, components.count());
+  EXPECT_EQ(0, components.historySize());
+  EXPECT_EQ(1, components.size(0));
+}
+
+// _____________________________________________________________________________
+
+TEST(ComponentsTest, capacity) {
+  Components components(4);
+  components.setCapacity(0, 3);
+  components.setCapacity(1, 1);
+  components.setCapacity(3, 5);
+  EXPECT_EQ(3, components.capacity(0));
+  EXPECT_EQ(3, components.ownCapacity(0));
+
+  components.unite(0, 1);
+  components.unite(1, 2);
+  EXPECT_EQ(4, components.capacity(2));
+  // Changes inside of merged components are visible to the whole component
+  components.setCapacity(1, 0);
+  components.setCapacity(2, 2);
+  EXPECT_EQ(5, components.capacity(0));
+  EXPECT_EQ(0, components.ownCapacity(1));
+
+  // and are kept when the merge is undone
+  components.rollback();
+  EXPECT_EQ(3, components.capacity(0));
+  EXPECT_EQ(2, components.capacity(2));
+  components.rollback();
+  EXPECT_EQ(3, components.capacity(0));
+  EXPECT_EQ(0, components.capacity(1));
+
+  components.unite(0, 3);
+  components.reset();
+  EXPECT_EQ(3, components.capacity(0));
+  EXPECT_EQ(5, components.capacity(3));
+}
+
+// _____________________________________________________________________________
+
+TEST(ComponentsTest, randomized) {
+  // Compare against a naive labelling that is recomputed after every step
+  std::mt19937 generator(11);
+  const uint32_t count = 40;
+  Components components(count);
+  std::vector<std::pair<uint32_t, uint32_t>> edges;
+  std::vector<uint32_t> capacities(count, 0);
+  for (int round = 0; round < 3000; round++) {
+    uint32_t action = generator() % 5;
+    if (action < 2) {
+      uint32_t one = generator() % count;
+      uint32_t two = generator() % count;
+      components.unite(one, two);
+      edges.push_back({ one, two });
+    } else if (action < 4 && !edges.empty()) {
+      components.rollback();
+      edges.pop_back();
+    } else {
+      uint32_t element = generator() % count;
+      capacities[element] = generator() % 9;
+      components.setCapacity(element, capacities[element]);
+    }
+
+    std::vector<uint32_t> labels(count);
+    for (uint32_t i = 0; i < count; i++) {
+      labels[i] = i;
+    }
+    // Relabel until nothing changes anymore
+    bool changed = true;
+    while (changed) {
+      changed = false;
+      for (const auto &edge : edges) {
+        uint32_t label = std::min(labels[edge.first], labels[edge.second]);
+        for (uint32_t i = 0; i < count; i++) {
+          if ((labels[i] == labels[edge.first]
+            || labels[i] == labels[edge.second]) && labels[i] != label) {
+            labels[i] = label;
+            changed = true;
+          }
+        }
+      }
+    }
+    size_t componentCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+      componentCount += labels[i] == i;
+      uint64_t capacity = 0;
+      uint32_t size = 0;
+      for (uint32_t j = 0; j < count; j++) {
+        if (labels[j] == labels[i]) {
+          capacity += capacities[j];
+          size++;
+        }
+      }
+      ASSERT_EQ(capacity, components.capacity(i));
+      ASSERT_EQ(size, components.size(i));
+    }
+    ASSERT_EQ(componentCount, components.count());
+    ASSERT_EQ(edges.size(), components.historySize());
+  }
+}
@@ -0,0 +1,87 @@
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <vector>
+#include "./CutEdges.h"
+
+const uint32_t CutEdges::NONE;
+
+// _____________________________________________________________________________
+
+CutEdges::CutEdges(size_t vertices): _order(vertices, NONE),
+  _low(vertices, 0), _size(vertices, 0) {
+  _stack.reserve(vertices);
+}
+
+// _____________________________________________________________________________
+
+void CutEdges::find(const std::vector<uint32_t> &slots) {
+  std::fill(_order.begin(), _order.end(), NONE);
+  _cuts.clear();
+  _stack.clear();
+  _visited = 0;
+  if (_order.empty()) {
+    return;
+  }
+  _order[0] = _low[0] = _visited++;
+  _size[0] = 1;
+  _stack.push_back({ 0, 0 });
+  while (!_stack.empty()) {
+    uint32_t vertex = _stack.back().first;
+    uint32_t slot = _stack.back().second;
+    if (slot == 4) {
+      // The subtree below the vertex is complete
+      _stack.pop_back();
+      if (_stack.empty()) {
+        break;
+      }
+      uint32_t parent = _stack.back().first;
+      _low[parent] = std::min(_low[parent], _low[vertex]);
+      _size[parent] += _size[vertex];
+      if (_low[vertex] > _order[parent]) {
+        _cuts.push_back({ parent, vertex,
+          parent * 4 + _stack.back().second - 1 });
+      }
+      continue;
+    }
+    _stack.back().second++;
+    uint32_t other = slots[vertex * 4 + slot];
+    if (other == NONE) {
+      continue;
+    }
+    if (_order[other] == NONE) {
+      _order[other] = _low[other] = _visited++;
+      _size[other] = 1;
+      _stack.push_back({ other, 0 });
+    } else if (_stack.size() < 2 || other != _stack[_stack.size() - 2].first) {
+      // Any edge but the one back to the parent, there are no parallel
+      // edges
+      _low[vertex] = std::min(_low[vertex], _order[other]);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+const std::vector<CutEdges::Cut>& CutEdges::cuts() const {
+  return _cuts;
+}
+
+// _____________________________________________________________________________
+
+size_t CutEdges::visited() const {
+  return _visited;
+}
+
+// _____________________________________________________________________________
+
+bool CutEdges::isVisited(uint32_t vertex) const {
+  return _order[vertex] != NONE;
+}
+
+// _____________________________________________________________________________
+
+bool CutEdges::isBelow(const Cut &cut, uint32_t vertex) const {
+  return _order[vertex] != NONE && _order[vertex] >= _order[cut.child]
+    && _order[vertex] < _order[cut.child] + _size[cut.child];
+}
@@ -0,0 +1,70 @@
+#ifndef CUTEDGES_H_
+#define CUTEDGES_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// Finds the cut edges of an undirected graph on the vertices 0 to n - 1,
+// i.e. the edges whose removal disconnects the graph, with the iterative
+// version of Tarjan's algorithm in linear time. Every vertex has up to 4
+// edges, one per slot, which fits the gaps of an Island
+class CutEdges {
+  FRIEND_TEST(CutEdgesTest, constructor);
+
+ public:
+  // marks a slot without edge
+  static const uint32_t NONE = UINT32_MAX;
+
+  // A cut edge between a vertex and its child in the depth-first search
+  // tree, the child's side of the cut is the subtree below it
+  struct Cut {
+    uint32_t parent;
+    uint32_t child;
+    // the slot of the edge at the parent
+    uint32_t slot;
+  };
+
+  // Creates an empty search for graphs with n vertices
+  explicit CutEdges(size_t);
+
+  // Searches the graph given by the other vertex of every slot, slot i
+  // of vertex v is element v * 4 + i, both directions of an edge have to
+  // be given and there must not be 2 edges between the same vertices.
+  // Only the vertices connected to vertex 0 are visited
+  void find(const std::vector<uint32_t>&);
+
+  // Returns the cut edges found by the last search
+  const std::vector<Cut>& cuts() const;
+
+  // Returns the amount of vertices the last search has visited
+  size_t visited() const;
+
+  // Returns true if the last search has visited the vertex
+  bool isVisited(uint32_t) const;
+
+  // Returns true if the vertex is on the child's side of the cut
+  bool isBelow(const Cut&, uint32_t) const;
+
+ private:
+  // the position of every vertex in the depth-first order, NONE if it
+  // hasn't been visited
+  std::vector<uint32_t> _order;
+  // the lowest position reachable from the subtree below every vertex
+  // with a single edge that is not part of the tree
+  std::vector<uint32_t> _low;
+  // the amount of vertices in the subtree below every vertex
+  std::vector<uint32_t> _size;
+  // the vertices of the current path and the next slot to look at
+  std::vector<std::pair<uint32_t, uint32_t>> _stack;
+  // the cut edges of the last search
+  std::vector<Cut> _cuts;
+  // the amount of vertices the last search has visited
+  size_t _visited = 0;
+};
+
+#endif  // CUTEDGES_H_
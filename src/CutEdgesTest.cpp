@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "./CutEdges.h"
+#include "./Components.h"
+
+// _____________________________________________________________________________
+
+// Helper function that connects the vertices in the given slots
+void addEdge(std::vector<uint32_t>* slots, uint32_t one, uint32_t oneSlot,
+  uint32_t two, uint32_t twoSlot) {
+  (*slots)[one * 4 + oneSlot] = two;
+  (*slots)[two * 4 + twoSlot] = one;
+}
+
+// _____________________________________________________________________________
+
+TEST(CutEdgesTest, constructor) {
+  CutEdges cuts(3);
+  EXPECT_EQ(3, cuts._order.size());
+  EXPECT_EQ(0, cuts.visited());
+  EXPECT_TRUE(cuts.cuts().empty());
+
+  CutEdges empty(0);
+  empty.find({});
+  EXPECT_EQ(0, empty.visited());
+}
+
+// _____________________________________________________________________________
+
+TEST(CutEdgesTest, find) {
+  // A square 0 1 2 3 with a tail 3 4 5 and the single vertex 6
+  std::vector<uint32_t> slots(7 * 4, CutEdges::NONE);
+  addEdge(&slots, 0, 1, 1, 3);
+  addEdge(&slots, 1, 2, 2, 0);
+  addEdge(&slots, 2, 3, 3, 1);
+  addEdge(&slots, 3, 0, 0, 2);
+  addEdge(&slots, 3, 2, 4, 0);
+  addEdge(&slots, 4, 1, 5, 3);
+  CutEdges cuts(7);
+  cuts.find(slots);
+  EXPECT_EQ(6, cuts.visited());
+  EXPECT_FALSE(cuts.isVisited(6));
+  ASSERT_EQ(2, cuts.cuts().size());
+  for (const auto &cut : cuts.cuts()) {
+    EXPECT_EQ(slots[cut.slot], cut.child);
+    EXPECT_EQ(cut.parent, cut.slot / 4);
+    EXPECT_TRUE(cuts.isBelow(cut, 5));
+    EXPECT_FALSE(cuts.isBelow(cut, 0));
+    EXPECT_FALSE(cuts.isBelow(cut, 6));
+  }
+  auto first = cuts.cuts()[0];
+  auto second = cuts.cuts()[1];
+  if (first.parent == 3) {
+    std::swap(first, second);
+  }
+  EXPECT_EQ(4, first.parent);
+  EXPECT_EQ(5, first.child);
+  EXPECT_EQ(3, second.parent);
+  EXPECT_EQ(4, second.child);
+  EXPECT_TRUE(cuts.isBelow(second, 4));
+  EXPECT_FALSE(cuts.isBelow(first, 4));
+}
+
+// _____________________________________________________________________________
+
+TEST(CutEdgesTest, randomized) {
+  // An edge is a cut edge if the vertices it connects fall apart
+  // without it
+  std::mt19937 random(99);
+  const uint32_t width = 5;
+  for (int round = 0; round < 200; round++) {
+    std::vector<uint32_t> slots(width * width * 4, CutEdges::NONE);
+    std::vector<std::pair<uint32_t, uint32_t>> edges;
+    for (uint32_t v = 0; v < width * width; v++) {
+      if (v % width + 1 < width && random() % 3 != 0) {
+        addEdge(&slots, v, 1, v + 1, 3);
+        edges.push_back({ v, v + 1 });
+      }
+      if (v + width < width * width && random() % 3 != 0) {
+        addEdge(&slots, v, 2, v + width, 0);
+        edges.push_back({ v, v + width });
+      }
+    }
+    CutEdges cuts(width * width);
+    cuts.find(slots);
+    Components all(width * width);
+    for (const auto &edge : edges) {
+      all.unite(edge.first, edge.second);
+    }
+    EXPECT_EQ(all.size(0), cuts.visited());
+    size_t expected = 0;
+    for (const auto &edge : edges) {
+      if (all.find(edge.first) != all.find(0)) {
+        continue;
+      }
+      Components without(width * width);
+      for (const auto &other : edges) {
+        if (other != edge) {
+          without.unite(other.first, other.second);
+        }
+      }
+      bool cut = without.find(edge.first) != without.find(edge.second);
+      expected += cut;
+      auto found = std::find_if(cuts.cuts().begin(), cuts.cuts().end(),
+        [&edge](const CutEdges::Cut &c) {
+          return std::min(c.parent, c.child) == edge.first
+            && std::max(c.parent, c.child) == edge.second;
+        });
+      EXPECT_EQ(cut, found != cuts.cuts().end());
+      if (cut && found != cuts.cuts().end()) {
+        // The subtree is the side of the child
+        for (uint32_t v = 0; v < width * width; v++) {
+          if (cuts.isVisited(v)) {
+            EXPECT_EQ(without.find(v) == without.find(found->child),
+              cuts.isBelow(*found, v));
+          }
+        }
+      }
+    }
+    EXPECT_EQ(expected, cuts.cuts().size());
+  }
+}
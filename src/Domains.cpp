@@ -0,0 +1,56 @@
+#include <cstdint>
+#include <vector>
+#include "./Domains.h"
+
+const uint8_t Domains::ALL;
+
+// _____________________________________________________________________________
+
+Domains::Domains(size_t edges): _domains(edges, ALL) {}
+
+// _____________________________________________________________________________
+
+void Domains::reset(const Game &game, const EdgeSet &forbidden) {
+  for (uint32_t edge = 0; edge < _domains.size(); edge++) {
+    auto ends = game.edgeIslands(edge);
+    if (ends.second == nullptr) {
+      _domains[edge] = 1;
+      continue;
+    }
+    int8_t bridges = ends.first->isConnected(ends.second);
+    int8_t most = bridges;
+    if (!forbidden.contains(edge) && game.findAccessibleIsland(*ends.first,
+      edge % 2 ? Direction::DOWN : Direction::RIGHT) == ends.second) {
+      most += game.maxBandwidth(ends.first, ends.second);
+    }
+    // The amounts from bridges up to most
+    _domains[edge] = ((1 << (most + 1)) - 1) & ~((1 << bridges) - 1);
+  }
+}
+
+// _____________________________________________________________________________
+
+uint8_t Domains::operator[](uint32_t edge) const {
+  return _domains[edge];
+}
+
+// _____________________________________________________________________________
+
+int8_t Domains::max(uint32_t edge) const {
+  uint8_t domain = _domains[edge];
+  return domain & 4 ? 2 : domain & 2 ? 1 : 0;
+}
+
+// _____________________________________________________________________________
+
+uint8_t Domains::restrict(uint32_t edge, int8_t most) {
+  uint8_t old = _domains[edge];
+  _domains[edge] &= (1 << (most + 1)) - 1;
+  return old;
+}
+
+// _____________________________________________________________________________
+
+void Domains::assign(uint32_t edge, uint8_t domain) {
+  _domains[edge] = domain;
+}
@@ -0,0 +1,52 @@
+#ifndef DOMAINS_H_
+#define DOMAINS_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "./Game.h"
+#include "./EdgeSet.h"
+
+// _____________________________________________________________________________
+
+// The amounts of bridges every gap (see Game::edgeId) may still end up
+// with, one bit per amount: bit v is set if v bridges are still possible.
+// Every constraint on a gap, its Islands running full, a crossing bridge,
+// a forbidden gap or a closed group, only rules out the amounts above some
+// bound, so domains are narrowed from above only. Amounts below the
+// bridges a gap already has are ruled out by those bridges
+class Domains {
+  FRIEND_TEST(DomainsTest, constructor);
+
+ public:
+  // The domain of a gap nothing is known about, { 0, 1, 2 }
+  static const uint8_t ALL = 7;
+
+  // Creates a domain of ALL for the gap ids 0 to n - 1
+  explicit Domains(size_t);
+
+  // Sets the domain of every gap to what the Game allows: the amounts from
+  // its bridges up to Game#maxBandwidth more, no more bridges if the gap is
+  // part of the given forbidden gaps or crossed, { 0 } if there is no gap
+  void reset(const Game&, const EdgeSet&);
+
+  // Returns the domain of the gap with the given id
+  uint8_t operator[](uint32_t) const;
+
+  // Returns the highest amount of bridges the domain of the gap allows
+  int8_t max(uint32_t) const;
+
+  // Removes the amounts above the given one from the domain of the gap,
+  // returns the domain it had before
+  uint8_t restrict(uint32_t, int8_t);
+
+  // Sets the domain of the gap, e.g. to undo restrict
+  void assign(uint32_t, uint8_t);
+
+ private:
+  // the domain of every gap
+  std::vector<uint8_t> _domains;
+};
+
+#endif  // DOMAINS_H_
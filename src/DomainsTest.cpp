@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "./Domains.h"
+#include "./EdgeSet.h"
+#include "./Game.h"
+
+// _____________________________________________________________________________
+
+TEST(DomainsTest, constructor) {
+  Domains domains(5);
+  EXPECT_EQ(5, domains._domains.size());
+  for (uint32_t i = 0; i < 5; i++) {
+    EXPECT_EQ(Domains::ALL, domains[i]);
+    EXPECT_EQ(2, domains.max(i));
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(DomainsTest, reset) {
+  Game game({
+    Island(2, 0, 1),
+    Island(0, 2, 3),
+    Island(2, 2, 2)
+  });
+  auto middleIsland = game.getIsland(2, 2);
+  auto topIsland = game.getIsland(2, 0);
+  auto leftIsland = game.getIsland(0, 2);
+  uint32_t top = Game::edgeId(topIsland, middleIsland);
+  uint32_t left = Game::edgeId(leftIsland, middleIsland);
+
+  Domains domains(game.edgeCount());
+  EdgeSet forbidden(game.edgeCount());
+  domains.reset(game, forbidden);
+  EXPECT_EQ(3, domains[top]);
+  EXPECT_EQ(1, domains.max(top));
+  EXPECT_EQ(7, domains[left]);
+  EXPECT_EQ(2, domains.max(left));
+  // There is no Island to the right of the top one
+  EXPECT_EQ(1, domains[topIsland->index() * 2]);
+
+  forbidden.insert(top);
+  domains.reset(game, forbidden);
+  EXPECT_EQ(1, domains[top]);
+  EXPECT_EQ(7, domains[left]);
+
+  // The bridges of a gap stay possible, the middle Island takes just
+  // one more
+  game.connect(leftIsland, middleIsland, false);
+  domains.reset(game, forbidden);
+  EXPECT_EQ(6, domains[left]);
+  forbidden.insert(left);
+  domains.reset(game, forbidden);
+  EXPECT_EQ(2, domains[left]);
+  EXPECT_EQ(1, domains.max(left));
+
+  // A crossed gap can't take a bridge
+  Game crossed({
+    Island(1, 0, 2),
+    Island(0, 1, 1),
+    Island(2, 1, 1),
+    Island(1, 2, 2)
+  });
+  uint32_t vertical = Game::edgeId(crossed.getIsland(1, 0),
+    crossed.getIsland(1, 2));
+  Domains crossedDomains(crossed.edgeCount());
+  crossedDomains.reset(crossed, EdgeSet(crossed.edgeCount()));
+  EXPECT_EQ(3, crossedDomains[vertical]);
+  crossed.connect(crossed.getIsland(0, 1), crossed.getIsland(2, 1), false);
+  crossedDomains.reset(crossed, EdgeSet(crossed.edgeCount()));
+  EXPECT_EQ(1, crossedDomains[vertical]);
+}
+
+// _____________________________________________________________________________
+
+TEST(DomainsTest, restrict) {
+  Domains domains(2);
+  EXPECT_EQ(Domains::ALL, domains.restrict(1, 1));
+  EXPECT_EQ(3, domains[1]);
+  EXPECT_EQ(1, domains.max(1));
+  // Nothing changes if the amount is allowed anyway
+  EXPECT_EQ(3, domains.restrict(1, 2));
+  EXPECT_EQ(3, domains[1]);
+  EXPECT_EQ(3, domains.restrict(1, 0));
+  EXPECT_EQ(1, domains[1]);
+  EXPECT_EQ(0, domains.max(1));
+  EXPECT_EQ(Domains::ALL, domains[0]);
+
+  domains.assign(1, 3);
+  EXPECT_EQ(3, domains[1]);
+  domains.assign(1, Domains::ALL);
+  EXPECT_EQ(2, domains.max(1));
+}
@@ -0,0 +1,48 @@
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include "./EdgeSet.h"
+
+// _____________________________________________________________________________
+
+EdgeSet::EdgeSet(size_t count):
+  _bits((count + WORD_BITS - 1) / WORD_BITS, 0), _size(0) {}
+
+// _____________________________________________________________________________
+
+bool EdgeSet::contains(uint32_t edge) const {
+  return (_bits[edge / WORD_BITS] >> (edge % WORD_BITS)) & 1;
+}
+
+// _____________________________________________________________________________
+
+bool EdgeSet::insert(uint32_t edge) {
+  if (contains(edge)) {
+    return false;
+  }
+  _bits[edge / WORD_BITS] |= 1ull << (edge % WORD_BITS);
+  _size++;
+  return true;
+}
+
+// _____________________________________________________________________________
+
+void EdgeSet::erase(uint32_t edge) {
+  if (contains(edge)) {
+    _bits[edge / WORD_BITS] &= ~(1ull << (edge % WORD_BITS));
+    _size--;
+  }
+}
+
+// _____________________________________________________________________________
+
+void EdgeSet::clear() {
+  std::fill(_bits.begin(), _bits.end(), 0);
+  _size = 0;
+}
+
+// _____________________________________________________________________________
+
+size_t EdgeSet::size() const {
+  return _size;
+}
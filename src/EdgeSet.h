@@ -0,0 +1,45 @@
+#ifndef EDGESET_H_
+#define EDGESET_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// Set of gap ids (see Game::edgeId) with one bit per possible gap, so
+// adding, removing and looking up a gap is a single bit operation
+class EdgeSet {
+  FRIEND_TEST(EdgeSetTest, constructor);
+
+ public:
+  // Creates an empty set for the gap ids 0 to n - 1
+  explicit EdgeSet(size_t);
+
+  // Returns true if the gap is part of the set
+  bool contains(uint32_t) const;
+
+  // Adds the gap to the set, returns false if it already was part of it
+  bool insert(uint32_t);
+
+  // Removes the gap from the set
+  void erase(uint32_t);
+
+  // Removes all gaps from the set
+  void clear();
+
+  // Returns the amount of gaps in the set
+  size_t size() const;
+
+ private:
+  // amount of bits per word
+  static const size_t WORD_BITS = 64;
+
+  // one bit per gap id
+  std::vector<uint64_t> _bits;
+  // amount of set bits
+  size_t _size;
+};
+
+#endif  // EDGESET_H_
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "./EdgeSet.h"
+
+// _____________________________________________________________________________
+
+TEST(EdgeSetTest, constructor) {
+  EdgeSet set(130);
+  EXPECT_EQ(3, set._bits.size());
+  EXPECT_EQ(0, set.size());
+  for (uint32_t i = 0; i < 130; i++) {
+    EXPECT_FALSE(set.contains(i));
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(EdgeSetTest, insertErase) {
+  EdgeSet set(130);
+  EXPECT_TRUE(set.insert(0));
+  EXPECT_TRUE(set.insert(64));
+  EXPECT_TRUE(set.insert(129));
+  EXPECT_FALSE(set.insert(64));
+  EXPECT_EQ(3, set.size());
+  for (uint32_t i = 0; i < 130; i++) {
+    EXPECT_EQ(i == 0 || i == 64 || i == 129, set.contains(i));
+  }
+
+  set.erase(64);
+  set.erase(65);
+  EXPECT_EQ(2, set.size());
+  EXPECT_FALSE(set.contains(64));
+  EXPECT_TRUE(set.contains(129));
+
+  set.clear();
+  EXPECT_EQ(0, set.size());
+  EXPECT_FALSE(set.contains(0));
+  EXPECT_FALSE(set.contains(129));
+}
@@ -1,40 +1,56 @@
-#include <unordered_map>
-#include <unordered_set>
 #include <vector>
 #include <deque>
 #include <algorithm>
 #include <functional>
 #include <cstdint>
+#include <memory>
+#include <new>
+#include <cassert>
+#include <random>
 #include "./Game.h"
 
+const uint32_t GameSnapshot::NONE;
+
 // _____________________________________________________________________________
 
-std::unordered_map<uint32_t, Island*> Game::islandVectorToMap(
-  const std::vector<Island> &islands) const {
-  std::unordered_map<uint32_t, Island*> map;
+std::vector<Island> Game::copyIslands(const std::vector<Island> &islands) {
+  std::vector<const Island*> order;
+  order.reserve(islands.size());
   for (const auto &entry : islands) {
-    uint32_t key = entry._x + entry._y * _width;
-    // Island deoesn't have a copy(-assignment) constructor
-    // to make it explicit that that the Island will not
-    // copy its bridges which would create undefined behaviour
-    map[key] = new Island(entry._x, entry._y, entry._requiredBridges);
+    order.push_back(&entry);
+  }
+  // Row-major order means full-board sweeps walk through memory linearly
+  std::stable_sort(order.begin(), order.end(),
+    [](const Island* one, const Island* two) {
+      return std::make_pair(one->_y, one->_x)
+        < std::make_pair(two->_y, two->_x);
+    });
+  std::vector<Island> result;
+  result.reserve(order.size());
+  for (size_t i = 0; i < order.size(); i++) {
+    if (i + 1 < order.size() && order[i]->_x == order[i + 1]->_x
+      && order[i]->_y == order[i + 1]->_y) {
+      continue;
+    }
+    // Only the coordinates and the required bridges are copied,
+    // copying the bridges would create undefined behaviour
+    result.emplace_back(order[i]->_x, order[i]->_y,
+      order[i]->_requiredBridges);
   }
-  return map;
+  return result;
 }
 
 // _____________________________________________________________________________
 
-// This is a little helper function that creates a 2 dimensional
-// boolean array to be used by the Game class
-bool** createBoolMatrix(uint32_t width, uint32_t height) {
-  bool** matrix = new bool*[width];
-  for (uint32_t x = 0; x < width; x++) {
-    matrix[x] = new bool[height]();
+std::vector<Island*> Game::islandPointers(std::vector<Island>* islands) {
+  std::vector<Island*> result;
+  result.reserve(islands->size());
+  for (auto &island : *islands) {
+    result.push_back(&island);
   }
-  return matrix;
+  return result;
 }
 
-
 // _____________________________________________________________________________
 
 // Small helper function that gets the highest value (or 0 if no values) + 1
@@ -49,46 +65,259 @@ uint32_t getSize(const std::vector<Island> &islands,
   return max + 1;
 }
 
-
 // _____________________________________________________________________________
 
-Game::Game(const std::vector<Island> &islands) :
+Game::Game(const std::vector<Island> &islands, IslandIndex::Layout layout) :
   _width(getSize(islands, [](const Island &island){ return island._x; })),
   _height(getSize(islands, [](const Island &island){ return island._y; })),
-  _islands(islandVectorToMap(islands)),
-  _bridgeOccupation(createBoolMatrix(_width, _height)) {}
+  _storage(copyIslands(islands)),
+  _islands(islandPointers(&_storage), _width, _height, layout),
+  _occupation(_width, _height),
+  _components(_islands.islands().size()),
+  _zobristKeys(_islands.islands().size() * 4) {
+  buildNeighbourTable();
+  for (const auto &island : _islands.islands()) {
+    updateCapacity(*island);
+  }
+  // A fixed seed gives Games with the same Islands the same hashes
+  std::mt19937_64 generator(0x9E3779B97F4A7C15ull);
+  for (auto &key : _zobristKeys) {
+    key = generator();
+  }
+}
 
 // _____________________________________________________________________________
 
-Island* Game::getIsland(uint32_t x, uint32_t y) const {
-  if (x >= _width || y >= _height) {
-    return nullptr;
+Game::Game(const Game &other, const GameSnapshot &snapshot) :
+  _width(other._width), _height(other._height),
+  // The stored Islands are already sorted and unique, so they keep
+  // their positions
+  _storage(copyIslands(other._storage)),
+  _islands(other._islands, other._storage.data(), _storage.data()),
+  _occupation(_width, _height), _neighbours(other._neighbours),
+  _rows(other._rows), _columns(other._columns),
+  _components(_islands.islands().size()),
+  _zobristKeys(other._zobristKeys) {
+  // The copied tables still point into the storage of the other Game
+  auto rebase = [&other, this](Island* &island) {
+    if (island != nullptr) {
+      island = &_storage[island - other._storage.data()];
+    }
+  };
+  for (size_t i = 0; i < _storage.size(); i++) {
+    _storage[i]._index = other._storage[i]._index;
   }
-  // This ensures a unique key
-  uint32_t key = x + y * _width;
-  if (_islands.count(key)) {
-    return _islands.at(key);
+  for (auto &island : _neighbours) {
+    rebase(island);
   }
-  return nullptr;
+  for (auto &island : _rows.islands) {
+    rebase(island);
+  }
+  for (auto &island : _columns.islands) {
+    rebase(island);
+  }
+  restore(snapshot);
 }
 
 // _____________________________________________________________________________
 
-Island* const & IslandView::unordered_map_value_iterator::operator*() const {
-  return std::unordered_map<uint32_t, Island*>::const_iterator::operator*()
-    .second;
+Game Game::clone() const {
+  return Game(*this, snapshot());
 }
 
 // _____________________________________________________________________________
 
-IslandView::unordered_map_value_iterator IslandView::begin() const {
-  return unordered_map_value_iterator(_islands.begin());
+GameSnapshot Game::snapshot() const {
+  GameSnapshot snapshot(_occupation, _components);
+  const auto &islands = _islands.islands();
+  snapshot._partners.assign(islands.size() * 2, GameSnapshot::NONE);
+  snapshot._multiplicities.assign(islands.size() * 2, 0);
+  snapshot._unions = _unions;
+  snapshot._hash = _hash;
+  for (const auto &island : islands) {
+    // Every bridge is in the right or down slot of exactly one Island
+    for (const Direction* dir : { &Direction::RIGHT, &Direction::DOWN }) {
+      const Bridge* bridge = island->_bridges[dir->_index];
+      if (bridge != nullptr) {
+        size_t slot = island->_index * 2 + (dir == &Direction::DOWN);
+        Island* other = bridge->_one == island ? bridge->_two : bridge->_one;
+        snapshot._partners[slot] = other->_index;
+        snapshot._multiplicities[slot] = island->_multiplicity[dir->_index];
+      }
+    }
+  }
+  return snapshot;
 }
 
 // _____________________________________________________________________________
 
-IslandView::unordered_map_value_iterator IslandView::end() const {
-  return unordered_map_value_iterator(_islands.end());
+bool Game::restore(const GameSnapshot &snapshot) {
+  const auto &islands = _islands.islands();
+  if (snapshot._partners.size() != islands.size() * 2) {
+    return false;
+  }
+  // Recycled memory is overwritten, so the bridges are only recycled
+  // through the right and down slots, which hold every bridge once
+  for (const auto &island : islands) {
+    for (const Direction* dir : { &Direction::RIGHT, &Direction::DOWN }) {
+      if (island->_bridges[dir->_index] != nullptr) {
+        recycle(island->_bridges[dir->_index]);
+      }
+    }
+    std::fill(island->_bridges, island->_bridges + 4, nullptr);
+    std::fill(island->_multiplicity, island->_multiplicity + 4, 0);
+    island->_degree = 0;
+  }
+  for (size_t slot = 0; slot < snapshot._partners.size(); slot++) {
+    if (snapshot._partners[slot] != GameSnapshot::NONE) {
+      Island* island = islands[slot / 2];
+      Island* other = islands[snapshot._partners[slot]];
+      Bridge* bridge = _bridgePool.acquire(island, other,
+        snapshot._multiplicities[slot] == 2);
+      island->attach(bridge);
+      other->attach(bridge);
+    }
+  }
+  // Everything else can simply be copied
+  _occupation = snapshot._occupation;
+  _components = snapshot._components;
+  _unions = snapshot._unions;
+  _hash = snapshot._hash;
+  return true;
+}
+
+// _____________________________________________________________________________
+
+// Small helper that returns the coordinate of an Island along a line
+// that points into the given direction
+uint32_t positionAlong(const Island* island, const Direction &dir) {
+  return dir._xchange != 0 ? island->_x : island->_y;
+}
+
+// _____________________________________________________________________________
+
+std::vector<Game::Line> Game::groupIntoLines(std::vector<Island*> islands,
+  const Direction &along) {
+  const Direction &across = along._xchange != 0
+    ? Direction::DOWN : Direction::RIGHT;
+  std::sort(islands.begin(), islands.end(),
+    [&along, &across](const Island* one, const Island* two) {
+      return std::make_pair(positionAlong(one, across),
+        positionAlong(one, along)) < std::make_pair(positionAlong(two, across),
+        positionAlong(two, along));
+    });
+  std::vector<Game::Line> lines;
+  for (const auto &island : islands) {
+    uint32_t position = positionAlong(island, across);
+    if (lines.empty() || lines.back().position != position) {
+      lines.push_back({ position, {} });
+    }
+    lines.back().islands.push_back(island);
+  }
+  return lines;
+}
+
+// _____________________________________________________________________________
+
+Game::LineIndex Game::indexLines(const std::vector<Line> &lines,
+  size_t count) {
+  LineIndex index;
+  index.start.assign(count + 1, 0);
+  for (const auto &line : lines) {
+    index.start[line.position + 1] = line.islands.size();
+    index.islands.insert(index.islands.end(), line.islands.begin(),
+      line.islands.end());
+  }
+  // Turn the sizes into offsets, the lines are sorted by their position
+  for (size_t i = 1; i <= count; i++) {
+    index.start[i] += index.start[i - 1];
+  }
+  return index;
+}
+
+// _____________________________________________________________________________
+
+void Game::buildNeighbourTable() {
+  const auto &islands = _islands.islands();
+  for (size_t i = 0; i < islands.size(); i++) {
+    islands[i]->_index = i;
+  }
+  _neighbours.assign(islands.size() * 4, nullptr);
+  auto rows = groupIntoLines(islands, Direction::RIGHT);
+  _rows = indexLines(rows, _height);
+  for (const auto &line : rows) {
+    for (size_t i = 1; i < line.islands.size(); i++) {
+      _neighbours[line.islands[i - 1]->_index * 4 + Direction::RIGHT._index]
+        = line.islands[i];
+      _neighbours[line.islands[i]->_index * 4 + Direction::LEFT._index]
+        = line.islands[i - 1];
+    }
+  }
+  auto columns = groupIntoLines(islands, Direction::DOWN);
+  _columns = indexLines(columns, _width);
+  for (const auto &line : columns) {
+    for (size_t i = 1; i < line.islands.size(); i++) {
+      _neighbours[line.islands[i - 1]->_index * 4 + Direction::DOWN._index]
+        = line.islands[i];
+      _neighbours[line.islands[i]->_index * 4 + Direction::UP._index]
+        = line.islands[i - 1];
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+Island* Game::neighbour(const Island &island, const Direction &dir) const {
+  return _neighbours[island._index * 4 + dir._index];
+}
+
+// _____________________________________________________________________________
+
+Island* Game::nearestIsland(uint32_t x, uint32_t y,
+  const Direction &dir) const {
+  bool horizontal = dir._ychange == 0;
+  const LineIndex &lines = horizontal ? _rows : _columns;
+  uint32_t line = horizontal ? y : x;
+  uint32_t position = horizontal ? x : y;
+  auto begin = lines.islands.begin() + lines.start[line];
+  auto end = lines.islands.begin() + lines.start[line + 1];
+  // The first Island behind the cell
+  auto behind = std::upper_bound(begin, end, position,
+    [&dir](uint32_t position, const Island* island) {
+      return position < positionAlong(island, dir);
+    });
+  if (dir._xchange + dir._ychange > 0) {
+    return behind == end ? nullptr : *behind;
+  }
+  // Skip the Island on the cell itself
+  while (behind != begin && positionAlong(*(behind - 1), dir) >= position) {
+    behind--;
+  }
+  return behind == begin ? nullptr : *(behind - 1);
+}
+
+// _____________________________________________________________________________
+
+Island* Game::getIsland(uint32_t x, uint32_t y) const {
+  return _islands.find(x, y);
+}
+
+// _____________________________________________________________________________
+
+std::vector<Island*>::const_iterator IslandView::begin() const {
+  return _islands.begin();
+}
+
+// _____________________________________________________________________________
+
+std::vector<Island*>::const_iterator IslandView::end() const {
+  return _islands.end();
+}
+
+// _____________________________________________________________________________
+
+Island* IslandView::operator[](size_t index) const {
+  return _islands[index];
 }
 
 // _____________________________________________________________________________
@@ -100,37 +329,31 @@ size_t IslandView::size() const {
 // _____________________________________________________________________________
 
 IslandView Game::getIslands() const {
-  return IslandView(_islands);
+  return IslandView(_islands.islands());
 }
 
 // _____________________________________________________________________________
 
-
 Island* Game::findAccessibleIsland(const Island &origin,
   const Direction &dir) const {
   // If we are already connected we can skip
   // the search process
-  for (const auto &bridge : origin._bridges) {
-    Island* other = bridge->_one == &origin ? bridge->_two : bridge->_one;
-    if (&dir == origin.findDirection(other)) {
-      return other;
-    }
+  const Bridge* bridge = origin._bridges[dir._index];
+  if (bridge != nullptr) {
+    return bridge->_one == &origin ? bridge->_two : bridge->_one;
   }
-  uint32_t x = origin._x + dir._xchange;
-  uint32_t y = origin._y + dir._ychange;
-  // Because we're underflowing, this is ok
-  while (x < _width && y < _height) {
-    if (_bridgeOccupation[x][y]) {
-      return nullptr;
-    }
-    Island* island = getIsland(x, y);
-    if (island != nullptr) {
-      return island;
-    }
-    x += dir._xchange;
-    y += dir._ychange;
+  // The neighbour table already knows the nearest Island,
+  // only the cells in between need to be checked for bridges
+  Island* other = neighbour(origin, dir);
+  if (other == nullptr) {
+    return nullptr;
   }
-  return nullptr;
+  bool clear = dir._ychange == 0
+    ? _occupation.isRowClear(origin._y,
+      std::min(origin._x, other->_x) + 1, std::max(origin._x, other->_x))
+    : _occupation.isColumnClear(origin._x,
+      std::min(origin._y, other->_y) + 1, std::max(origin._y, other->_y));
+  return clear ? other : nullptr;
 }
 
 // _____________________________________________________________________________
@@ -155,109 +378,67 @@ std::vector<Island*> Game::findAccessibleIslands(
 // _____________________________________________________________________________
 
 bool Game::isSolved() const {
-  // Depth first search to check if all Islands are connected to each other
-  std::unordered_set<Island*> visited;
-  std::deque<Island*> toVisit;
-  toVisit.push_back(_islands.cbegin()->second);
-  while (!toVisit.empty()) {
-    Island* current = toVisit.back();
-    toVisit.pop_back();
-    visited.insert(current);
-    uint8_t missingConnections = current->_requiredBridges;
-    for (const auto &bridge : current->_bridges) {
-      Island* other = bridge->_one == current ? bridge->_two : bridge->_one;
-      if (!visited.count(other)) {
-        toVisit.push_back(other);
-      }
-      missingConnections -= bridge->_doubleBridge ? 2 : 1;
-    }
-    if (missingConnections != 0) {
-      // Some connection is still missing, no solution
-      return false;
-    }
-  }
-  // If we haven't visited all Islands, the graph is not complete
-  return _islands.size() == visited.size();
+  // All Islands have to be in a single component without missing connections
+  return _components.count() == 1 && _components.capacity(0) == 0;
 }
 
 // _____________________________________________________________________________
 
 bool Game::wouldCreateDisjunctGroup(Island* island, Island* other) const {
-  std::deque<Island*> toVisit;
-  toVisit.push_back(island);
-  toVisit.push_back(other);
-  return wouldCreateDisjunctGroup(&toVisit);
-}
-
-// _____________________________________________________________________________
-
-bool Game::wouldCreateDisjunctGroup(std::deque<Island*>* toVisit) const {
-  std::unordered_set<Island*> visited;
-  visited.insert(toVisit->begin(), toVisit->end());
-  while (!toVisit->empty()) {
-    Island* current = toVisit->front();
-    toVisit->pop_front();
-
-    // enqueue all unvisited, connected Islands
-    for (const auto &bridge : current->_bridges) {
-      Island* other = bridge->_one == current ? bridge->_two : bridge->_one;
-      if (!visited.count(other)) {
-        if (other->missingConnections() != 0) {
-          // this function could be a little bit smarter,
-          // but ain't nobody got time for that
-          return false;
-        }
-        toVisit->push_back(other);
-      }
-    }
-    visited.insert(current);
-  }
-  // We iterated through a closed group, if not all Islands
-  // are in this group, some of them are disjunct
-  return visited.size() != _islands.size();
+  std::deque<Island*> islands;
+  islands.push_back(island);
+  islands.push_back(other);
+  return wouldCreateDisjunctGroup(&islands);
 }
 
 // _____________________________________________________________________________
 
-bool Game::isPartOfDisjunctGroup(Island* island) const {
-  // Modified Depth-first search
-  std::unordered_set<Island*> visited;
-  std::deque<Island*> toVisit;
-  toVisit.push_back(island);
-  while (!toVisit.empty()) {
-    Island* current = toVisit.front();
-    toVisit.pop_front();
-    if (current->missingConnections() != 0) {
-      return false;
+bool Game::wouldCreateDisjunctGroup(std::deque<Island*>* islands) const {
+  // Sum up every component that contains one of the Islands exactly once
+  std::vector<uint32_t> roots;
+  std::vector<uint32_t> indices;
+  uint64_t capacity = 0;
+  size_t size = 0;
+  for (const auto &island : *islands) {
+    uint32_t root = _components.find(island->_index);
+    if (std::find(roots.begin(), roots.end(), root) == roots.end()) {
+      roots.push_back(root);
+      capacity += _components.capacity(root);
+      size += _components.size(root);
     }
-    visited.insert(current);
-
-    // enqueue all unvisited, connected Islands
-    for (const auto &bridge : current->_bridges) {
-      Island* other = bridge->_one == current ? bridge->_two : bridge->_one;
-      if (!visited.count(other)) {
-        toVisit.push_back(other);
-      }
+    if (std::find(indices.begin(), indices.end(), island->_index)
+      == indices.end()) {
+      indices.push_back(island->_index);
     }
   }
-  // We iterated through a closed group, if not all Islands
-  // are in this group, some of them are disjunct
-  return visited.size() != _islands.size();
+  // The given Islands are assumed to be full after the connection,
+  // everything else needs to be full already to close the group
+  for (const auto &index : indices) {
+    capacity -= _components.ownCapacity(index);
+  }
+  // If not all Islands are in this group, some of them are disjunct
+  return capacity == 0 && size != _islands.islands().size();
+}
+
+// _____________________________________________________________________________
+
+bool Game::isPartOfDisjunctGroup(Island* island) const {
+  // A closed group, that doesn't contain all Islands
+  return _components.capacity(island->_index) == 0
+    && _components.size(island->_index) != _islands.islands().size();
 }
 
 // _____________________________________________________________________________
 
 void Game::registerBridge(Bridge* bridge, bool add) {
-  bool horizontal = bridge->_one->_y == bridge->_two->_y;
-  auto minmax = horizontal
-    ? std::minmax(bridge->_one->_x, bridge->_two->_x)
-    : std::minmax(bridge->_one->_y, bridge->_two->_y);
-  for (auto i = minmax.first + 1; i < minmax.second; i++) {
-    if (horizontal) {
-      _bridgeOccupation[i][bridge->_one->_y] = add;
-    } else {
-      _bridgeOccupation[bridge->_one->_x][i] = add;
-    }
+  if (bridge->_one->_y == bridge->_two->_y) {
+    auto minmax = std::minmax(bridge->_one->_x, bridge->_two->_x);
+    _occupation.assignRow(bridge->_one->_y, minmax.first + 1, minmax.second,
+      add);
+  } else {
+    auto minmax = std::minmax(bridge->_one->_y, bridge->_two->_y);
+    _occupation.assignColumn(bridge->_one->_x, minmax.first + 1,
+      minmax.second, add);
   }
 }
 
@@ -279,6 +460,128 @@ int8_t Game::maxBandwidth(Island* current, Island* other) const {
 
 // _____________________________________________________________________________
 
+uint32_t Game::edgeId(const Island* one, const Island* two) {
+  bool vertical = one->_x == two->_x;
+  return std::min(one->_index, two->_index) * 2 + vertical;
+}
+
+// _____________________________________________________________________________
+
+size_t Game::edgeCount() const {
+  return _storage.size() * 2;
+}
+
+// _____________________________________________________________________________
+
+std::pair<Island*, Island*> Game::edgeIslands(uint32_t edge) const {
+  Island* one = _islands.islands()[edge / 2];
+  return {one, neighbour(*one, edge % 2 ? Direction::DOWN : Direction::RIGHT)};
+}
+
+// _____________________________________________________________________________
+
+uint32_t Game::edgeId(const Bridge* bridge) {
+  return edgeId(bridge->_one, bridge->_two);
+}
+
+// _____________________________________________________________________________
+
+int8_t Game::multiplicity(const Bridge* bridge) {
+  return bridge->_doubleBridge ? 2 : 1;
+}
+
+// _____________________________________________________________________________
+
+uint32_t Game::neighbourGap(const Island &island, const Direction &dir)
+  const {
+  Island* other = neighbour(island, dir);
+  return other == nullptr ? UINT32_MAX : edgeId(&island, other);
+}
+
+// _____________________________________________________________________________
+
+void Game::crossingGaps(uint32_t edge, std::vector<uint32_t>* result) const {
+  auto islands = edgeIslands(edge);
+  if (islands.second == nullptr) {
+    return;
+  }
+  bool horizontal = edge % 2 == 0;
+  uint32_t from = horizontal ? islands.first->_x : islands.first->_y;
+  uint32_t to = horizontal ? islands.second->_x : islands.second->_y;
+  const Direction &across = horizontal ? Direction::DOWN : Direction::RIGHT;
+  for (uint32_t i = from + 1; i < to; i++) {
+    uint32_t x = horizontal ? i : islands.first->_x;
+    uint32_t y = horizontal ? islands.first->_y : i;
+    Island* before = nearestIsland(x, y,
+      horizontal ? Direction::UP : Direction::LEFT);
+    if (before != nullptr && before->_bridges[across._index] != nullptr) {
+      result->push_back(edgeId(before->_bridges[across._index]));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void Game::acrossGaps(uint32_t edge, std::vector<uint32_t>* result) const {
+  auto islands = edgeIslands(edge);
+  if (islands.second == nullptr) {
+    return;
+  }
+  bool horizontal = edge % 2 == 0;
+  uint32_t from = horizontal ? islands.first->_x : islands.first->_y;
+  uint32_t to = horizontal ? islands.second->_x : islands.second->_y;
+  for (uint32_t i = from + 1; i < to; i++) {
+    uint32_t x = horizontal ? i : islands.first->_x;
+    uint32_t y = horizontal ? islands.first->_y : i;
+    Island* before = nearestIsland(x, y,
+      horizontal ? Direction::UP : Direction::LEFT);
+    Island* after = nearestIsland(x, y,
+      horizontal ? Direction::DOWN : Direction::RIGHT);
+    if (before != nullptr && after != nullptr) {
+      result->push_back(edgeId(before, after));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void Game::findAffectedIslands(const Bridge* bridge,
+  std::vector<Island*>* result) const {
+  for (Island* end : { bridge->_one, bridge->_two }) {
+    result->push_back(end);
+    // Blocked neighbours don't matter, but skipping them costs more
+    // than analyzing them
+    for (const Direction* dir : Direction::ALL) {
+      Island* other = neighbour(*end, *dir);
+      if (other != nullptr) {
+        result->push_back(other);
+      }
+    }
+  }
+  // Every cell between both Islands blocks the gap across it, if there is one
+  const Island* one = bridge->_one;
+  const Island* two = bridge->_two;
+  bool horizontal = one->_y == two->_y;
+  uint32_t from = horizontal ? std::min(one->_x, two->_x) : std::min(one->_y,
+    two->_y);
+  uint32_t to = horizontal ? std::max(one->_x, two->_x) : std::max(one->_y,
+    two->_y);
+  for (uint32_t i = from + 1; i < to; i++) {
+    uint32_t x = horizontal ? i : one->_x;
+    uint32_t y = horizontal ? one->_y : i;
+    Island* before = nearestIsland(x, y,
+      horizontal ? Direction::UP : Direction::LEFT);
+    Island* after = nearestIsland(x, y,
+      horizontal ? Direction::DOWN : Direction::RIGHT);
+    if (before != nullptr && after != nullptr) {
+      result->push_back(before);
+      result->push_back(after);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
 bool Game::containsIsland(Island* island) {
   return getIsland(island->_x, island->_y) == island;
 }
@@ -289,31 +592,32 @@ Bridge* Game::connect(Island* origin, Island* other, bool doubleBridge,
   Bridge** oldBridge) {
   if (origin->isCorrectlyAlignedWith(other) && containsIsland(origin)
     && containsIsland(other)) {
-    Bridge* existingBridge = nullptr;
-    for (const auto &bridge : origin->_bridges) {
-      // Does bridge connect origin and other?
-      if (bridge->_one == other || bridge->_two == other) {
-        if (!doubleBridge && !bridge->_doubleBridge) {
-          // Requested bridge does not break the rules, proceed
-          existingBridge = bridge;
-          break;
-        }
-        // The requested bridge does brek the rules, abort
-        return nullptr;
-      }
+    const Direction* dir = origin->findDirection(other);
+    Bridge* existingBridge = origin->_bridges[dir->_index];
+    // Both slots either hold the bridge between the two Islands or are
+    // empty, otherwise one of them is already connected elsewhere
+    if (existingBridge != other->_bridges[dir->opposite()._index]) {
+      return nullptr;
     }
-    if (existingBridge != nullptr) {
-      disconnect(existingBridge);
-      // Don't deallocate bridge, is we can pass the ownership to the caller
-      if (oldBridge != nullptr) {
-        *oldBridge = existingBridge;
-      } else {
-        delete existingBridge;
-      }
+    if (existingBridge != nullptr
+      && (doubleBridge || existingBridge->_doubleBridge)) {
+      // The requested bridge does brek the rules, abort
+      return nullptr;
     }
     bool bridgeStrength = existingBridge != nullptr || doubleBridge;
-    auto bridge = new Bridge(origin, other, bridgeStrength);
-    reconnect(bridge);
+    auto bridge = _bridgePool.acquire(origin, other, bridgeStrength);
+    if (existingBridge == nullptr) {
+      reconnect(bridge);
+      return bridge;
+    }
+    // Both Islands stay connected, so the components don't change
+    replace(existingBridge, bridge);
+    // Don't deallocate bridge, is we can pass the ownership to the caller
+    if (oldBridge != nullptr) {
+      *oldBridge = existingBridge;
+    } else {
+      recycle(existingBridge);
+    }
     return bridge;
   }
   return nullptr;
@@ -325,11 +629,22 @@ void Game::disconnect(Bridge* bridge) {
   if (!containsIsland(bridge->_one) || !containsIsland(bridge->_two)) {
     return;
   }
-  bridge->_one->_bridges.erase(std::remove(bridge->_one->_bridges.begin(),
-    bridge->_one->_bridges.end(), bridge), bridge->_one->_bridges.end());
-  bridge->_two->_bridges.erase(std::remove(bridge->_two->_bridges.begin(),
-    bridge->_two->_bridges.end(), bridge), bridge->_two->_bridges.end());
+  bridge->_one->detach(bridge);
+  bridge->_two->detach(bridge);
   registerBridge(bridge, false);
+  _hash ^= zobristKey(bridge);
+  updateCapacity(*bridge->_one);
+  updateCapacity(*bridge->_two);
+  // Undoing the last merge is cheap, any other merge can't be undone
+  // on its own
+  std::pair<uint32_t, uint32_t> islands = std::minmax(bridge->_one->_index,
+    bridge->_two->_index);
+  if (!_unions.empty() && _unions.back() == islands) {
+    _unions.pop_back();
+    _components.rollback();
+  } else {
+    rebuildComponents();
+  }
 }
 
 // _____________________________________________________________________________
@@ -338,21 +653,90 @@ void Game::reconnect(Bridge* bridge) {
   if (!containsIsland(bridge->_one) || !containsIsland(bridge->_two)) {
     return;
   }
-  bridge->_one->_bridges.push_back(bridge);
-  bridge->_two->_bridges.push_back(bridge);
+  bridge->_one->attach(bridge);
+  bridge->_two->attach(bridge);
   registerBridge(bridge, true);
+  _hash ^= zobristKey(bridge);
+  updateCapacity(*bridge->_one);
+  updateCapacity(*bridge->_two);
+  _unions.push_back(std::minmax(bridge->_one->_index, bridge->_two->_index));
+  _components.unite(bridge->_one->_index, bridge->_two->_index);
 }
 
 // _____________________________________________________________________________
 
-Game::~Game() {
-  for (const auto &island : getIslands()) {
-    delete island;
+void Game::replace(Bridge* bridge, Bridge* replacement) {
+  if (!containsIsland(bridge->_one) || !containsIsland(bridge->_two)) {
+    return;
   }
-  for (size_t i = 0; i < _width; i++) {
-    delete[] _bridgeOccupation[i];
+  // Both bridges cover the same cells, so the occupation stays the same
+  bridge->_one->detach(bridge);
+  bridge->_two->detach(bridge);
+  replacement->_one->attach(replacement);
+  replacement->_two->attach(replacement);
+  _hash ^= zobristKey(bridge) ^ zobristKey(replacement);
+  updateCapacity(*bridge->_one);
+  updateCapacity(*bridge->_two);
+}
+
+// _____________________________________________________________________________
+
+uint64_t Game::zobristKey(const Bridge* bridge) const {
+  // Islands are indexed in row-major order, so the Island with the lower
+  // index holds the bridge in its right or down slot
+  uint32_t index = std::min(bridge->_one->_index, bridge->_two->_index);
+  bool vertical = bridge->_one->_x == bridge->_two->_x;
+  return _zobristKeys[index * 4 + vertical * 2 + bridge->_doubleBridge];
+}
+
+// _____________________________________________________________________________
+
+uint64_t Game::hash() const {
+  return _hash;
+}
+
+// _____________________________________________________________________________
+
+void Game::updateCapacity(const Island &island) {
+  // Overfilled Islands count with their excess, so a closed group
+  // always has a capacity of 0
+  int8_t missing = island.missingConnections();
+  _components.setCapacity(island._index, missing < 0 ? -missing : missing);
+}
+
+// _____________________________________________________________________________
+
+void Game::rebuildComponents() {
+  _components.reset();
+  _unions.clear();
+  for (const auto &island : _islands.islands()) {
+    for (const auto &bridge : island->_bridges) {
+      // Every bridge is stored by both of its Islands
+      if (bridge != nullptr && bridge->_one == island) {
+        _unions.push_back(std::minmax(bridge->_one->_index,
+          bridge->_two->_index));
+        _components.unite(bridge->_one->_index, bridge->_two->_index);
+      }
+    }
   }
-  delete[] _bridgeOccupation;
+}
+
+// _____________________________________________________________________________
+
+void Game::recycle(Bridge* bridge) {
+  _bridgePool.recycle(bridge);
+}
+
+// _____________________________________________________________________________
+
+const BridgePool::Statistics& Game::bridgeStatistics() const {
+  return _bridgePool.statistics();
+}
+
+// _____________________________________________________________________________
+
+uint32_t Island::index() const {
+  return _index;
 }
 
 // _____________________________________________________________________________
@@ -367,24 +751,98 @@ bool Island::isCorrectlyAlignedWith(Island* other) const {
 // _____________________________________________________________________________
 
 int8_t Island::missingConnections() const {
-  int8_t sum = _requiredBridges;
-  for (const auto &bridge : _bridges) {
-    sum -= bridge->_doubleBridge ? 2 : 1;
-  }
-  return sum;
+  return _requiredBridges - _degree;
+}
+
+// _____________________________________________________________________________
+
+int8_t Island::multiplicity(const Direction &dir) const {
+  return _multiplicity[dir._index];
 }
 
 // _____________________________________________________________________________
 
 int8_t Island::isConnected(Island* other) const {
-  for (const auto &bridge : _bridges) {
-    if (bridge->_one == other || bridge->_two == other) {
-      return bridge->_doubleBridge ? 2 : 1;
-    }
+  const Direction* dir = findDirection(other);
+  if (dir == nullptr) {
+    return 0;
+  }
+  const Bridge* bridge = _bridges[dir->_index];
+  if (bridge != nullptr && (bridge->_one == other || bridge->_two == other)) {
+    return _multiplicity[dir->_index];
   }
   return 0;
 }
 
+// _____________________________________________________________________________
+
+void Island::attach(Bridge* bridge) {
+  Island* other = bridge->_one == this ? bridge->_two : bridge->_one;
+  const Direction* dir = findDirection(other);
+  if (dir == nullptr) {
+    return;
+  }
+#ifdef HASHI_DEBUG
+  assert(_bridges[dir->_index] == nullptr);
+#endif
+  int8_t weight = bridge->_doubleBridge ? 2 : 1;
+  _bridges[dir->_index] = bridge;
+  _multiplicity[dir->_index] = weight;
+  _degree += weight;
+#ifdef HASHI_DEBUG
+  assert(hasConsistentCounters());
+#endif
+}
+
+// _____________________________________________________________________________
+
+void Island::detach(Bridge* bridge) {
+  Island* other = bridge->_one == this ? bridge->_two : bridge->_one;
+  const Direction* dir = findDirection(other);
+  if (dir == nullptr || _bridges[dir->_index] != bridge) {
+    return;
+  }
+  _bridges[dir->_index] = nullptr;
+  _degree -= _multiplicity[dir->_index];
+  _multiplicity[dir->_index] = 0;
+#ifdef HASHI_DEBUG
+  assert(hasConsistentCounters());
+#endif
+}
+
+// _____________________________________________________________________________
+
+uint8_t Island::bridgeCount() const {
+  uint8_t count = 0;
+  for (const auto &bridge : _bridges) {
+    count += bridge != nullptr;
+  }
+  return count;
+}
+
+// _____________________________________________________________________________
+
+bool Island::hasConsistentCounters() const {
+  int8_t degree = 0;
+  for (const auto &dir : Direction::ALL) {
+    const Bridge* bridge = _bridges[dir->_index];
+    int8_t weight = 0;
+    if (bridge != nullptr) {
+      // Every bridge has to be stored in the slot it points to
+      Island* other = bridge->_one == this ? bridge->_two : bridge->_one;
+      if ((bridge->_one != this && bridge->_two != this)
+        || findDirection(other) != dir) {
+        return false;
+      }
+      weight = bridge->_doubleBridge ? 2 : 1;
+    }
+    if (_multiplicity[dir->_index] != weight) {
+      return false;
+    }
+    degree += weight;
+  }
+  return degree == _degree;
+}
 
 // _____________________________________________________________________________
 
@@ -410,19 +868,59 @@ const Direction* Island::findDirection(const Island* other) const {
 
 // _____________________________________________________________________________
 
-Island::~Island() {
-  for (const auto &bridge : _bridges) {
-    Island* other = bridge->_one == this ? bridge->_two : bridge->_one;
-    other->_bridges.erase(std::remove(other->_bridges.begin(),
-      other->_bridges.end(), bridge), other->_bridges.end());
-    delete bridge;
+Bridge* BridgePool::acquire(Island* one, Island* two, bool doubleBridge) {
+  Slot* slot;
+  if (_free != nullptr) {
+    slot = _free;
+    _free = _free->next;
+  } else {
+    if (_unused == 0) {
+      _blocks.push_back(std::unique_ptr<Slot[]>(new Slot[BLOCK_SIZE]));
+      _unused = BLOCK_SIZE;
+      _statistics.blockAllocations++;
+    }
+    slot = &_blocks.back()[BLOCK_SIZE - _unused];
+    _unused--;
   }
+  _statistics.acquired++;
+  _statistics.peak = std::max(_statistics.peak,
+    _statistics.acquired - _statistics.recycled);
+  return new (&slot->bridge) Bridge(one, two, doubleBridge);
+}
+
+// _____________________________________________________________________________
+
+void BridgePool::recycle(Bridge* bridge) {
+  // Bridges are trivially destructible, so the memory can be reused directly
+  Slot* slot = reinterpret_cast<Slot*>(bridge);
+  slot->next = _free;
+  _free = slot;
+  _statistics.recycled++;
+}
+
+// _____________________________________________________________________________
+
+const BridgePool::Statistics& BridgePool::statistics() const {
+  return _statistics;
 }
 
 // _____________________________________________________________________________
 
 // enum-like objects, the only different directions available
-const Direction Direction::UP = Direction(0, -1);
-const Direction Direction::RIGHT = Direction(1, 0);
-const Direction Direction::DOWN = Direction(0, 1);
-const Direction Direction::LEFT = Direction(-1, 0);
+const Direction Direction::UP = Direction(0, -1, 0);
+const Direction Direction::RIGHT = Direction(1, 0, 1);
+const Direction Direction::DOWN = Direction(0, 1, 2);
+const Direction Direction::LEFT = Direction(-1, 0, 3);
+
+const Direction* const Direction::ALL[4] = {
+  &Direction::UP,
+  &Direction::RIGHT,
+  &Direction::DOWN,
+  &Direction::LEFT
+};
+
+// _____________________________________________________________________________
+
+const Direction& Direction::opposite() const {
+  return *ALL[(_index + 2) % 4];
+}
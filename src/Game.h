@@ -4,10 +4,13 @@
 #include <gtest/gtest_prod.h>
 #include <cstdint>
 #include <vector>
-#include <unordered_map>
-#include <unordered_set>
 #include <deque>
 #include <utility>
+#include <memory>
+#include <type_traits>
+#include "./IslandIndex.h"
+#include "./OccupationGrid.h"
+#include "./Components.h"
 
 // _____________________________________________________________________________
 
@@ -22,7 +25,7 @@ class Game;
 // we need to remove and recreate it
 class Bridge {
   FRIEND_TEST(GameTest, connect);
-  FRIEND_TEST(SolverTest, revertSteps);
+  FRIEND_TEST(SolverTest, revertLevel);
   FRIEND_TEST(SolverTest, eliminateObvious);
   FRIEND_TEST(SmartConnectorTest, reversedFindConnection);
   FRIEND_TEST(SmartConnectorTest, connectSmart);
@@ -33,8 +36,15 @@ class Bridge {
   FRIEND_TEST(IslandTest, missingConnections);
   FRIEND_TEST(IslandTest, isConnected);
   FRIEND_TEST(GameTest, registerBridge);
+  FRIEND_TEST(GameTest, findAccessibleIslandRandomized);
+  FRIEND_TEST(BridgePoolTest, acquire);
+  FRIEND_TEST(BridgePoolTest, recycle);
+  FRIEND_TEST(IslandTest, attach);
+  FRIEND_TEST(IslandTest, counters);
+  FRIEND_TEST(GameTest, componentsRandomized);
   friend class Game;
   friend class Island;
+  friend class BridgePool;
   friend class PlainPrinter;
   friend class XYPrinter;
   // source island
@@ -53,12 +63,75 @@ class Bridge {
 
 // _____________________________________________________________________________
 
+// Allocator for the Bridge objects of a single Game.
+// Memory is requested in blocks, recycled bridges go into a free list
+// and are handed out again before a new block is allocated, so
+// connecting and disconnecting in a loop doesn't touch the heap.
+// All blocks are released at once when the pool is destroyed
+class BridgePool {
+  FRIEND_TEST(BridgePoolTest, acquire);
+  FRIEND_TEST(BridgePoolTest, recycle);
+
+  // Storage for one Bridge that doubles as a free list node while unused
+  union Slot {
+    Slot* next;
+    std::aligned_storage<sizeof(Bridge), alignof(Bridge)>::type bridge;
+  };
+
+ public:
+  // How many bridges fit into a single block of memory
+  static const size_t BLOCK_SIZE = 256;
+
+  // Counters to verify the pool behaves as intended
+  struct Statistics {
+    // how many blocks have been requested from the heap
+    uint64_t blockAllocations;
+    // how many bridges have been handed out in total
+    uint64_t acquired;
+    // how many bridges have been given back to the pool
+    uint64_t recycled;
+    // the highest amount of bridges that were in use at the same time
+    uint64_t peak;
+  };
+
+  // Constructs an empty pool, no memory is allocated up front
+  BridgePool(): _free(nullptr), _unused(0), _statistics{0, 0, 0, 0} {}
+
+  // Creates a new Bridge, see the Bridge constructor for the parameters
+  Bridge* acquire(Island*, Island*, bool);
+
+  // Gives the memory of a Bridge acquired from this pool back,
+  // the Bridge must no longer be used afterwards
+  void recycle(Bridge*);
+
+  // Returns the counters of this pool
+  const Statistics& statistics() const;
+
+  // The pool can't be copied, because it owns the bridge memory,
+  // moving it keeps all bridges at their address
+  BridgePool(const BridgePool&) = delete;
+  BridgePool& operator=(const BridgePool&) = delete;
+  BridgePool(BridgePool&&) = default;
+
+ private:
+  // all memory blocks that have been allocated so far
+  std::vector<std::unique_ptr<Slot[]>> _blocks;
+  // head of the list of recycled slots
+  Slot* _free;
+  // amount of slots at the end of the last block that were never used
+  size_t _unused;
+  // counters of this pool
+  Statistics _statistics;
+};
+
+// _____________________________________________________________________________
+
 // Helper class to make direction related functions reusable
 class Direction {
   FRIEND_TEST(DirectionTest, constructor);
   // Private constructor, so we only have 4 possible directions
-  Direction(int8_t xchange, int8_t ychange):
-  _xchange(xchange), _ychange(ychange) {}
+  Direction(int8_t xchange, int8_t ychange, uint8_t index):
+  _xchange(xchange), _ychange(ychange), _index(index) {}
  public:
   // Enum-like objects, the only possible directions
   static const Direction UP;
@@ -66,10 +139,19 @@ class Direction {
   static const Direction DOWN;
   static const Direction LEFT;
 
+  // All directions, ordered by their index
+  static const Direction* const ALL[4];
+
   // How far a step in x direction goes for this direction
   const int8_t _xchange;
   // How far a step in y direction goes for this direction
   const int8_t _ychange;
+  // Unique number between 0 and 3, so per-direction data can
+  // be stored in plain arrays
+  const uint8_t _index;
+
+  // Returns the direction pointing the other way
+  const Direction& opposite() const;
 };
 
 // _____________________________________________________________________________
@@ -77,7 +159,8 @@ class Direction {
 // Class representing an Island of the Game
 class Island {
   FRIEND_TEST(GameTest, connect);
-  FRIEND_TEST(SolverTest, revertSteps);
+  FRIEND_TEST(GameTest, connectOccupiedDirection);
+  FRIEND_TEST(SolverTest, revertLevel);
   FRIEND_TEST(SolverTest, eliminateObvious);
   FRIEND_TEST(SmartConnectorTest, reversedFindConnection);
   FRIEND_TEST(SolverTest, solvePublicSolvable);
@@ -88,13 +171,45 @@ class Island {
   FRIEND_TEST(IslandTest, isConnected);
   FRIEND_TEST(GameTest, disconnect);
   FRIEND_TEST(GameTest, reconnect);
+  FRIEND_TEST(GameTest, islandStorage);
+  FRIEND_TEST(GameTest, moveConstructor);
+  FRIEND_TEST(IslandTest, attach);
+  FRIEND_TEST(IslandTest, counters);
+  FRIEND_TEST(GameTest, findAccessibleIslandRandomized);
+  FRIEND_TEST(GameTest, components);
+  FRIEND_TEST(GameTest, componentsRandomized);
+  FRIEND_TEST(GameTest, snapshot);
   friend class Game;
   friend class Bridge;
   friend class PlainPrinter;
   friend class XYPrinter;
 
-  // store all the bridges that come from or to this Island
-  std::vector<Bridge*> _bridges;
+  // the bridge in every direction or nullptr, indexed by the direction
+  // index, an Island can't have more than one bridge per direction.
+  // The bridges are owned by the Game the Island belongs to
+  Bridge* _bridges[4] = { nullptr, nullptr, nullptr, nullptr };
+  // position of this Island in the Game it belongs to, used to
+  // look up per-island data the Game stores in plain arrays
+  uint32_t _index = 0;
+  // sum of the multiplicities of all bridges in _bridges
+  int8_t _degree = 0;
+  // the multiplicity of the bridge in every direction,
+  // indexed by the direction index
+  int8_t _multiplicity[4] = { 0, 0, 0, 0 };
+
+  // Puts the Bridge into the slot of its direction and updates the
+  // counters, the slot must be empty
+  void attach(Bridge*);
+
+  // Removes the Bridge from its slot and updates the counters
+  void detach(Bridge*);
+
+  // Returns the amount of bridges connected to this Island
+  uint8_t bridgeCount() const;
+
+  // Recounts the bridges and returns true if the counters are up to date.
+  // Builds with HASHI_DEBUG defined check this after every change
+  bool hasConsistentCounters() const;
 
  public:
   // x coordinate of the island
@@ -111,8 +226,17 @@ class Island {
     _x(x), _y(y), _requiredBridges(requiredBridges) {}
 
   // Returns how many connections this Island needs in order to be "full"
+  // in constant time
   int8_t missingConnections() const;
 
+  // Returns the position of this Island in the Game it belongs to,
+  // see Game#getIslands()
+  uint32_t index() const;
+
+  // Returns the multiplicity of the bridge in the given direction,
+  // 0 if there is none
+  int8_t multiplicity(const Direction&) const;
+
   // Returns the degree of connection between this and the provided Island.
   // If they are connected with a single bridge, this function
   // returns 1, for a double bridge 2 and 0 otherwise
@@ -127,9 +251,6 @@ class Island {
   // Returns true if this and the given island are relatively aligned to each
   // other so they could technically be connected to each other
   bool isCorrectlyAlignedWith(Island*) const;
-
-  // deletes all bridges connected to this island
-  ~Island();
 };
 
 // _____________________________________________________________________________
@@ -141,84 +262,264 @@ class IslandView {
   FRIEND_TEST(IslandViewTest, testIteration);
   friend class Game;
 
-  // iterator wrapper that maps a map iterator to the value iterator of the map
-  struct unordered_map_value_iterator
-    : public std::unordered_map<uint32_t, Island*>::const_iterator {
-    unordered_map_value_iterator(std::unordered_map<uint32_t,
-      Island*>::const_iterator src)
-    : std::unordered_map<uint32_t, Island*>::const_iterator(std::move(src)) {}
-
-    // override the indirection operator in order to provide
-    // a view of the values of the map
-    Island* const & operator*() const;
-  };
-
-  // the unordered_map containing the islands of the Game class
-  const std::unordered_map<uint32_t, Island*> &_islands;
+  // the contiguous island vector of the index of the Game class
+  const std::vector<Island*> &_islands;
 
-  // Constructor to construct an iterator over the values of the given map
-  explicit IslandView(const std::unordered_map<uint32_t, Island*> &islands)
+  // Constructor to construct an iterator over the given vector
+  explicit IslandView(const std::vector<Island*> &islands)
     : _islands(islands) {}
 
  public:
   // begin iterator for for-each loops
-  unordered_map_value_iterator begin() const;
+  std::vector<Island*>::const_iterator begin() const;
   // end iterator for for-each loops
-  unordered_map_value_iterator end() const;
-  // COnvinience size function to query the size of the underlying map
+  std::vector<Island*>::const_iterator end() const;
+  // random access to the Island at the given position
+  Island* operator[](size_t) const;
+  // COnvinience size function to query the size of the underlying vector
   size_t size() const;
 };
 
 // _____________________________________________________________________________
 
+// Copy of everything that changes while a Game is being solved, stored
+// in flat buffers so taking and restoring a snapshot is a handful of
+// memcpys. A snapshot can be restored into the Game it has been taken
+// from or any clone of that Game
+class GameSnapshot {
+  FRIEND_TEST(GameTest, snapshot);
+  friend class Game;
+
+  // marks an empty slot in _partners
+  static const uint32_t NONE = UINT32_MAX;
+
+  // the Island index at the other end of the right and the down slot
+  // of every Island, 2 consecutive entries per Island, or NONE
+  std::vector<uint32_t> _partners;
+  // the multiplicity of the bridge in every slot of _partners
+  std::vector<int8_t> _multiplicities;
+  // the occupation grid of the Game
+  OccupationGrid _occupation;
+  // the connected components of the Game
+  Components _components;
+  // the undoable merges of the components of the Game
+  std::vector<std::pair<uint32_t, uint32_t>> _unions;
+  // the Zobrist hash of the Game
+  uint64_t _hash = 0;
+
+  // Snapshots are only taken by a Game
+  GameSnapshot(const OccupationGrid &occupation, const Components &components)
+    : _occupation(occupation), _components(components) {}
+};
+
+// _____________________________________________________________________________
+
 // Game object, the root object of all game related operations
 class Game {
   FRIEND_TEST(GameTest, constructor);
+  FRIEND_TEST(GameTest, constructorLayout);
   FRIEND_TEST(GameParserTest, parserPlain);
   FRIEND_TEST(GameParserTest, parserXY);
   FRIEND_TEST(GameParserTest, autoParsePlain);
   FRIEND_TEST(GameParserTest, autoParseXY);
   FRIEND_TEST(GameTest, connect);
-  FRIEND_TEST(GameTest, islandVectorToMap);
+  FRIEND_TEST(GameTest, copyIslands);
+  FRIEND_TEST(GameTest, islandStorage);
   FRIEND_TEST(GameTest, registerBridge);
   FRIEND_TEST(GameTest, disconnect);
   FRIEND_TEST(GameTest, reconnect);
+  FRIEND_TEST(GameTest, neighbourTable);
+  FRIEND_TEST(GameTest, moveConstructor);
+  FRIEND_TEST(GameTest, components);
+  FRIEND_TEST(GameTest, componentsRandomized);
+  FRIEND_TEST(GameTest, snapshot);
+  FRIEND_TEST(GameTest, clone);
+  FRIEND_TEST(GameTest, hash);
+  FRIEND_TEST(GameTest, nearestIsland);
   friend class PlainPrinter;
   friend class XYPrinter;
 
+  // A row or column of the grid that contains at least one Island
+  struct Line {
+    // y coordinate of a row or x coordinate of a column
+    uint32_t position;
+    // the Islands on this line sorted by their position along the line
+    std::vector<Island*> islands;
+  };
+
+  // All rows or all columns of the grid in flat vectors
+  struct LineIndex {
+    // the Islands sorted by their line and their position along it
+    std::vector<Island*> islands;
+    // the Islands of line i are the range from start[i] up to,
+    // but excluding, start[i + 1]
+    std::vector<uint32_t> start;
+  };
+
   // width of the map
   const size_t _width;
   // height of the map
   const size_t _height;
 
-  // store all islands of the map
-  // with average constant access based on x-y coordinates
-  const std::unordered_map<uint32_t, Island*> _islands;
-  // a dynamic 2 dimensional array holding basic information about all
-  // bridges on the field, this is more efficient than calculating
-  // every time where the bridges are when this class tries to connect
-  // two islands
-  bool* const * const _bridgeOccupation;
-
-  // Convinience function to "copy" a given vector of islands
-  // into a O(1) access map for faster lookup
-  std::unordered_map<uint32_t, Island*> islandVectorToMap(
-    const std::vector<Island> &islands) const;
+  // all islands of the map in one contiguous block in row-major order,
+  // the vector is never resized, so pointers to the islands stay valid
+  std::vector<Island> _storage;
+  // flat index over the stored islands
+  // with constant access based on x-y coordinates
+  const IslandIndex _islands;
+  // holds basic information about all bridges on the field,
+  // this is more efficient than calculating every time where the bridges
+  // are when this class tries to connect two islands
+  OccupationGrid _occupation;
+  // the nearest neighbour of every Island in every direction,
+  // 4 consecutive entries per Island ordered by the direction index
+  std::vector<Island*> _neighbours;
+  // the Islands of every row
+  LineIndex _rows;
+  // the Islands of every column
+  LineIndex _columns;
+  // owns the memory of all bridges of this game
+  BridgePool _bridgePool;
+  // the connected components of the bridge graph, the capacity of an
+  // Island is the amount of connections it's still missing
+  Components _components;
+  // the Islands (by index) connected by every merge of the components
+  // that can still be undone, ordered like the merges
+  std::vector<std::pair<uint32_t, uint32_t>> _unions;
+  // random keys for the Zobrist hash, 2 per right and down slot of
+  // every Island, one for a single and one for a double bridge
+  std::vector<uint64_t> _zobristKeys;
+  // xor of the keys of all bridges that are currently connected
+  uint64_t _hash = 0;
+
+  // Convinience function to "copy" a given vector of islands into
+  // row-major order, only the last of multiple islands on the same
+  // cell is kept
+  static std::vector<Island> copyIslands(const std::vector<Island>&);
+
+  // Returns pointers to all given islands in the same order
+  static std::vector<Island*> islandPointers(std::vector<Island>*);
 
   // Removes (false) or adds (true) a bridge from the collision
   // cache based on the second parameter
   void registerBridge(Bridge*, bool);
 
+  // Groups the Islands into rows and columns and fills the neighbour
+  // table, called once by the constructor
+  void buildNeighbourTable();
+
+  // Returns the Zobrist key of the given Bridge, which depends on
+  // the slot it is stored in and its multiplicity
+  uint64_t zobristKey(const Bridge*) const;
+
+  // Updates the capacity of the Island in the components after
+  // its bridges have changed
+  void updateCapacity(const Island&);
+
+  // Rebuilds the components from all bridges, only needed if bridges
+  // aren't disconnected in the reverse order they were connected in
+  void rebuildComponents();
+
+  // Groups the given Islands into lines that point into the given direction,
+  // the lines and the Islands on them are sorted by their coordinates
+  static std::vector<Line> groupIntoLines(std::vector<Island*>,
+    const Direction&);
+
+  // Returns the nearest Island in the given direction, regardless
+  // of any bridges in between, nullptr if there is none
+  Island* neighbour(const Island&, const Direction&) const;
+
+  // Flattens the given lines of the grid into a line index with
+  // the given amount of lines
+  static LineIndex indexLines(const std::vector<Line>&, size_t);
+
+  // Returns the nearest Island from the cell at the given x-y coordinates
+  // in the given direction, regardless of any bridges in between,
+  // nullptr if there is none
+  Island* nearestIsland(uint32_t, uint32_t, const Direction&) const;
+
+  // Creates a Game with the Islands of the given Game in the state of the
+  // snapshot, the tables that never change are copied instead of rebuilt
+  Game(const Game&, const GameSnapshot&);
+
  public:
   // Construct a game
   // Stores a given vector of Islands in this game instance
-  explicit Game(const std::vector<Island>&);
+  // The layout of the island index is picked automatically unless
+  // explicitly specified
+  explicit Game(const std::vector<Island>&,
+    IslandIndex::Layout = IslandIndex::Layout::AUTO);
+
+  // Games can't be copied, but moved, which keeps all islands and bridges
+  // at their address
+  Game(const Game&) = delete;
+  Game(Game&&) = default;
+
+  // Creates an independent Game with the same Islands and bridges,
+  // the bridges of the clone are new objects
+  Game clone() const;
+
+  // Returns a 64 bit hash of the current bridges, which is updated
+  // with every change, so calling this function costs nothing.
+  // Games with the same Islands and bridges have the same hash,
+  // regardless of the order the bridges have been connected in
+  uint64_t hash() const;
+
+  // Copies the current bridges into a snapshot
+  GameSnapshot snapshot() const;
+
+  // Replaces all bridges with the ones of the snapshot, returns false
+  // if the snapshot has been taken from a Game with different Islands.
+  // All Bridge pointers of this Game become invalid
+  bool restore(const GameSnapshot&);
 
   // returns an Island pointer pointing to the Island
   // at the specified x y coordinate
   // is nullptr if this island does not exist
   Island* getIsland(uint32_t, uint32_t) const;
 
+  // Compact list of gaps that have bridges: the id of every such gap
+  // (see edgeId) and its amount of bridges, ordered by the id
+  typedef std::vector<std::pair<uint32_t, int8_t>> EdgeList;
+
+  // Returns the id of the gap between the two aligned Islands, i.e. twice
+  // the index of the upper or left Island plus one for vertical gaps.
+  // Every gap of the game has a distinct id below edgeCount()
+  static uint32_t edgeId(const Island*, const Island*);
+
+  // Returns the amount of possible gap ids
+  size_t edgeCount() const;
+
+  // Returns both Islands of the gap with the given id, the upper or left
+  // one first, the second one is nullptr if there is no such gap
+  std::pair<Island*, Island*> edgeIslands(uint32_t) const;
+
+  // Returns the id of the gap the given Bridge is connected in
+  static uint32_t edgeId(const Bridge*);
+
+  // Returns how many bridges the given Bridge stands for, 1 or 2
+  static int8_t multiplicity(const Bridge*);
+
+  // Returns the id of the gap between the Island and its nearest Island
+  // in the given direction, regardless of any bridges in between,
+  // UINT32_MAX if there is none
+  uint32_t neighbourGap(const Island&, const Direction&) const;
+
+  // Appends the ids of the gaps whose bridges cross the gap with the
+  // given id to the vector, i.e. the ones that keep it from being used
+  void crossingGaps(uint32_t, std::vector<uint32_t>*) const;
+
+  // Appends the ids of all gaps that cross the gap with the given id to
+  // the vector, with or without bridges, i.e. the ones a bridge in it
+  // keeps from being used
+  void acrossGaps(uint32_t, std::vector<uint32_t>*) const;
+
+  // Appends the Islands whose possible connections are changed by the
+  // given connected Bridge to the vector: both of its Islands, the nearest
+  // Islands around them and the Islands on both ends of every gap
+  // the Bridge crosses. Islands may be appended more than once
+  void findAffectedIslands(const Bridge*, std::vector<Island*>*) const;
+
   // returns a pointer to a reachable Island in the given direction
   // if no Island is reachable in this direction this function returns nullptr
   Island* findAccessibleIsland(const Island&, const Direction&) const;
@@ -226,10 +527,11 @@ class Game {
   // returns a vector of Islands that are reachable from the given instance
   std::vector<Island*> findAccessibleIslands(const Island&) const;
 
-  // const view of the islands map's values
+  // const view of the islands of the game in their stored order
   IslandView getIslands() const;
 
   // Checks if the current state is a solution to the game, returns true if so
+  // in constant time
   bool isSolved() const;
 
   // calculates how many connections between this and the other Island
@@ -256,23 +558,34 @@ class Game {
   bool containsIsland(Island*);
 
   // connects two islands and create a bridge
-  // does check if the other Island is aligned correctly,
+  // does check if the other Island is aligned correctly and that neither
+  // Island already has a bridge to a different Island in this direction,
   // does not check if the connection path is clear
   // note that if a bridge is already present, the connection degree will
   // be added to the new bridge, so calling this function 2 times
   // with false as the bool argument, will result in the same bridge
   // as calling one time using true instead
-  // If a Bridge** is being passed, any old Bridge won't be deleted
+  // If a Bridge** is being passed, any old Bridge won't be recycled
   // but assigned to the Bridge* instead, so keep track of your bridge pointers
   Bridge* connect(Island*, Island*, bool, Bridge** = nullptr);
 
-  // Removes this Bridge from the Game, and deregisters the bridge
+  // Gives a Bridge that has been created by this game and is
+  // no longer connected back to the game, so its memory can be reused
+  void recycle(Bridge*);
+
+  // Returns the allocation counters of the bridges of this game
+  const BridgePool::Statistics& bridgeStatistics() const;
+
+  // Removes this Bridge from the Game, and deregisters the bridge.
+  // Disconnecting bridges in the reverse order they have been connected
+  // in is cheaper than any other order
   void disconnect(Bridge*);
   // Connects this Bridge to the Game, and registers the bridge
   void reconnect(Bridge*);
-
-  // Destruct a game deletes all stored Islands
-  ~Game();
+  // Replaces the connected Bridge (1st parameter) with another Bridge
+  // between the same Islands (2nd parameter), i.e. changes the
+  // multiplicity without disconnecting the Islands in between
+  void replace(Bridge*, Bridge*);
 };
 
 #endif  // GAME_H_
@@ -136,17 +136,17 @@ TEST(GameParserTest, autoParsePlain) {
   ASSERT_EQ(6, game._width);
   ASSERT_EQ(2, game._height);
 
-  ASSERT_EQ(4, game._islands.size());
+  ASSERT_EQ(4, game._islands.islands().size());
 
-  ASSERT_NE(nullptr, game._islands.at(0 + 0 * 6));
-  ASSERT_NE(nullptr, game._islands.at(5 + 0 * 6));
-  ASSERT_NE(nullptr, game._islands.at(0 + 1 * 6));
-  ASSERT_NE(nullptr, game._islands.at(3 + 1 * 6));
+  ASSERT_NE(nullptr, game._islands.find(0, 0));
+  ASSERT_NE(nullptr, game._islands.find(5, 0));
+  ASSERT_NE(nullptr, game._islands.find(0, 1));
+  ASSERT_NE(nullptr, game._islands.find(3, 1));
 
-  ASSERT_EQ(1, game._islands.at(0 + 0 * 6)->_requiredBridges);
-  ASSERT_EQ(2, game._islands.at(5 + 0 * 6)->_requiredBridges);
-  ASSERT_EQ(2, game._islands.at(0 + 1 * 6)->_requiredBridges);
-  ASSERT_EQ(5, game._islands.at(3 + 1 * 6)->_requiredBridges);
+  ASSERT_EQ(1, game._islands.find(0, 0)->_requiredBridges);
+  ASSERT_EQ(2, game._islands.find(5, 0)->_requiredBridges);
+  ASSERT_EQ(2, game._islands.find(0, 1)->_requiredBridges);
+  ASSERT_EQ(5, game._islands.find(3, 1)->_requiredBridges);
 }
 
 // _____________________________________________________________________________
@@ -156,15 +156,15 @@ TEST(GameParserTest, autoParseXY) {
   ASSERT_EQ(5, game._width);
   ASSERT_EQ(4, game._height);
 
-  ASSERT_EQ(3, game._islands.size());
+  ASSERT_EQ(3, game._islands.islands().size());
 
-  ASSERT_NE(nullptr, game._islands.at(0 + 1 * 5));
-  ASSERT_NE(nullptr, game._islands.at(0 + 3 * 5));
-  ASSERT_NE(nullptr, game._islands.at(4 + 1 * 5));
+  ASSERT_NE(nullptr, game._islands.find(0, 1));
+  ASSERT_NE(nullptr, game._islands.find(0, 3));
+  ASSERT_NE(nullptr, game._islands.find(4, 1));
 
-  ASSERT_EQ(2, game._islands.at(0 + 1 * 5)->_requiredBridges);
-  ASSERT_EQ(4, game._islands.at(0 + 3 * 5)->_requiredBridges);
-  ASSERT_EQ(1, game._islands.at(4 + 1 * 5)->_requiredBridges);
+  ASSERT_EQ(2, game._islands.find(0, 1)->_requiredBridges);
+  ASSERT_EQ(4, game._islands.find(0, 3)->_requiredBridges);
+  ASSERT_EQ(1, game._islands.find(4, 1)->_requiredBridges);
 }
 
 // _____________________________________________________________________________
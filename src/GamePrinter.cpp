@@ -4,6 +4,7 @@
 #include <algorithm>
 #include <vector>
 #include <cstdint>
+#include <utility>
 #include "./Game.h"
 #include "./GamePrinter.h"
 
@@ -27,7 +28,7 @@ std::vector<std::string> PlainPrinter::generateOutput() const {
     // Simple int to ascii conversion
     output[island->_y][island->_x] = '0' + island->_requiredBridges;
     for (const auto &bridge : island->_bridges) {
-      if (bridge->_one == island) {
+      if (bridge != nullptr && bridge->_one == island) {
         if (bridge->_one->_x == bridge->_two->_x) {
           auto minmax = std::minmax(bridge->_one->_y, bridge->_two->_y);
           for (uint32_t i = minmax.first + 1; i < minmax.second; i++) {
@@ -61,7 +62,7 @@ void XYPrinter::printToFile(const std::string& filename) const {
   std::ofstream file = openFile(filename);
   for (const auto &island : _game.getIslands()) {
     for (const auto &bridge : island->_bridges) {
-      if (bridge->_one == island) {
+      if (bridge != nullptr && bridge->_one == island) {
         for (int8_t i = 0; i < (bridge->_doubleBridge ? 2 : 1); i++) {
           file << island->_x << ',' << island->_y << ','
           << bridge->_two->_x << ',' << bridge->_two->_y << std::endl;
@@ -71,3 +72,30 @@ void XYPrinter::printToFile(const std::string& filename) const {
   }
   file.close();
 }
+
+// _____________________________________________________________________________
+
+XYSolutionWriter::XYSolutionWriter(const Game &game, std::ostream* stream):
+  _game(game), _stream(stream) {}
+
+// _____________________________________________________________________________
+
+void XYSolutionWriter::write(const Game::EdgeList &solution) {
+  if (_written > 0) {
+    *_stream << '\n';
+  }
+  for (const auto &gap : solution) {
+    auto islands = _game.edgeIslands(gap.first);
+    for (int8_t i = 0; i < gap.second; i++) {
+      *_stream << islands.first->_x << ',' << islands.first->_y << ','
+        << islands.second->_x << ',' << islands.second->_y << '\n';
+    }
+  }
+  _written++;
+}
+
+// _____________________________________________________________________________
+
+uint64_t XYSolutionWriter::written() const {
+  return _written;
+}
@@ -4,6 +4,8 @@
 #include <gtest/gtest_prod.h>
 #include <string>
 #include <vector>
+#include <ostream>
+#include <cstdint>
 #include "./Game.h"
 
 // _____________________________________________________________________________
@@ -40,6 +42,30 @@ class XYPrinter : public GamePrinter {
 
 // _____________________________________________________________________________
 
+// Writes the solutions of Solver#enumerateSolutions to a stream one by one
+// in the xy format, separated by an empty line. Nothing is kept after a
+// solution has been written, so any amount of solutions fits
+class XYSolutionWriter {
+  // The game the solutions belong to
+  const Game &_game;
+  // The stream to write to
+  std::ostream* const _stream;
+  // How many solutions have been written
+  uint64_t _written = 0;
+
+ public:
+  // Constructs a writer for the solutions of the game
+  XYSolutionWriter(const Game&, std::ostream*);
+
+  // Writes the solution to the stream
+  void write(const Game::EdgeList&);
+
+  // Returns how many solutions have been written
+  uint64_t written() const;
+};
+
+// _____________________________________________________________________________
+
 // Printer for the plain.solution format
 class PlainPrinter : public GamePrinter {
   FRIEND_TEST(PlainPrinterTest, generateOutput);
@@ -1,11 +1,13 @@
 #include <gtest/gtest.h>
 #include <cstdio>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 #include <algorithm>
 #include "./Game.h"
 #include "./GamePrinter.h"
+#include "./Solver.h"
 
 // _____________________________________________________________________________
 
@@ -102,6 +104,47 @@ TEST(XYPrinterTest, printToFile) {
 
 // _____________________________________________________________________________
 
+TEST(XYSolutionWriterTest, write) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  uint32_t top = Game::edgeId(game.getIsland(0, 0), game.getIsland(2, 0));
+  uint32_t left = Game::edgeId(game.getIsland(0, 0), game.getIsland(0, 2));
+  std::ostringstream stream;
+  XYSolutionWriter writer(game, &stream);
+  EXPECT_EQ(0, writer.written());
+  writer.write({ { top, 2 }, { left, 1 } });
+  EXPECT_EQ("0,0,2,0\n0,0,2,0\n0,0,0,2\n", stream.str());
+  writer.write({ { left, 2 } });
+  EXPECT_EQ(2, writer.written());
+  EXPECT_EQ("0,0,2,0\n0,0,2,0\n0,0,0,2\n\n0,0,0,2\n0,0,0,2\n",
+    stream.str());
+
+  // Every solution of the search ends up in the stream
+  std::ostringstream solutions;
+  XYSolutionWriter solutionWriter(game, &solutions);
+  Solver solver(&game);
+  EXPECT_EQ(2, solver.enumerateSolutions(
+    [&solutionWriter](const Solver::Solution &solution) {
+      solutionWriter.write(solution);
+      return true;
+    }));
+  EXPECT_EQ(2, solutionWriter.written());
+  std::vector<std::string> lines;
+  std::istringstream input(solutions.str());
+  std::string line;
+  while (std::getline(input, line)) {
+    lines.push_back(line);
+  }
+  ASSERT_EQ(13, lines.size());
+  EXPECT_EQ("", lines[6]);
+}
+
+// _____________________________________________________________________________
+
 
 TEST(GamePrinterTest, print) {
   ::testing::FLAGS_gtest_death_test_style = "threadsafe";
@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <deque>
 #include <memory>
+#include <random>
 #include "./Game.h"
 
 // _____________________________________________________________________________
@@ -26,27 +27,53 @@ TEST(GameTest, constructor) {
   EXPECT_EQ(457, game._height);
 
   for (uint32_t x = 0; x < game._width; x++) {
-    ASSERT_NE(nullptr, game._bridgeOccupation[x]);
     for (uint32_t y = 0; y < game._height; y++) {
-      ASSERT_EQ(0, game._bridgeOccupation[x][y]);
+      ASSERT_FALSE(game._occupation.get(x, y));
     }
   }
 
-  ASSERT_EQ(5, game._islands.size());
+  ASSERT_EQ(5, game._islands.islands().size());
 
-  EXPECT_NE(nullptr, game._islands.at(0 + 0 * 124));
-  EXPECT_NE(nullptr, game._islands.at(123 + 456 * 124));
-  EXPECT_NE(nullptr, game._islands.at(1 + 1 * 124));
-  EXPECT_NE(nullptr, game._islands.at(5 + 0 * 124));
-  EXPECT_NE(nullptr, game._islands.at(7 + 8 * 124));
+  EXPECT_NE(nullptr, game._islands.find(0, 0));
+  EXPECT_NE(nullptr, game._islands.find(123, 456));
+  EXPECT_NE(nullptr, game._islands.find(1, 1));
+  EXPECT_NE(nullptr, game._islands.find(5, 0));
+  EXPECT_NE(nullptr, game._islands.find(7, 8));
 
-  EXPECT_EQ(0, game._islands.at(0 + 0 * 124)->_requiredBridges);
-  EXPECT_EQ(8, game._islands.at(123 + 456 * 124)->_requiredBridges);
-  EXPECT_EQ(9, game._islands.at(1 + 1 * 124)->_requiredBridges);
-  EXPECT_EQ(3, game._islands.at(5 + 0 * 124)->_requiredBridges);
-  EXPECT_EQ(1, game._islands.at(7 + 8 * 124)->_requiredBridges);
+  EXPECT_EQ(0, game._islands.find(0, 0)->_requiredBridges);
+  EXPECT_EQ(8, game._islands.find(123, 456)->_requiredBridges);
+  EXPECT_EQ(9, game._islands.find(1, 1)->_requiredBridges);
+  EXPECT_EQ(3, game._islands.find(5, 0)->_requiredBridges);
+  EXPECT_EQ(1, game._islands.find(7, 8)->_requiredBridges);
 
-  EXPECT_NE(&test, game._islands.at(000 + 000 * 124));
+  EXPECT_NE(&test, game._islands.find(0, 0));
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, constructorLayout) {
+  std::vector<Island> islands = {
+    Island(0, 0, 1),
+    Island(2, 0, 2),
+    Island(2, 2, 1)
+  };
+  Game dense(islands, IslandIndex::Layout::DENSE);
+  Game sparse(islands, IslandIndex::Layout::SPARSE);
+
+  EXPECT_EQ(IslandIndex::Layout::DENSE, dense._islands.layout());
+  EXPECT_EQ(IslandIndex::Layout::SPARSE, sparse._islands.layout());
+
+  for (uint32_t x = 0; x < 4; x++) {
+    for (uint32_t y = 0; y < 4; y++) {
+      Island* denseIsland = dense.getIsland(x, y);
+      Island* sparseIsland = sparse.getIsland(x, y);
+      ASSERT_EQ(denseIsland == nullptr, sparseIsland == nullptr);
+      if (denseIsland != nullptr) {
+        EXPECT_EQ(denseIsland->_requiredBridges,
+          sparseIsland->_requiredBridges);
+      }
+    }
+  }
 }
 
 // _____________________________________________________________________________
@@ -145,32 +172,32 @@ TEST(GameTest, connect) {
   ASSERT_EQ(island1, bridge15s->_one);
   ASSERT_EQ(island5, bridge15s->_two);
   ASSERT_FALSE(bridge15s->_doubleBridge);
-  ASSERT_EQ(island1->_bridges[0], bridge15s);
-  ASSERT_EQ(1, island1->_bridges.size());
-  ASSERT_EQ(island5->_bridges[0], bridge15s);
-  ASSERT_EQ(1, island5->_bridges.size());
+  ASSERT_EQ(island1->_bridges[Direction::DOWN._index], bridge15s);
+  ASSERT_EQ(1, island1->bridgeCount());
+  ASSERT_EQ(island5->_bridges[Direction::UP._index], bridge15s);
+  ASSERT_EQ(1, island5->bridgeCount());
 
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
+  EXPECT_TRUE(game._occupation.get(0, 1));
 
   Bridge* oldBridge = nullptr;
 
   ASSERT_EQ(nullptr, game.connect(island1, island5, true, &oldBridge));
-  ASSERT_EQ(island1->_bridges[0], bridge15s);
-  ASSERT_EQ(1, island1->_bridges.size());
-  ASSERT_EQ(island5->_bridges[0], bridge15s);
-  ASSERT_EQ(1, island5->_bridges.size());
+  ASSERT_EQ(island1->_bridges[Direction::DOWN._index], bridge15s);
+  ASSERT_EQ(1, island1->bridgeCount());
+  ASSERT_EQ(island5->_bridges[Direction::UP._index], bridge15s);
+  ASSERT_EQ(1, island5->bridgeCount());
 
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
+  EXPECT_TRUE(game._occupation.get(0, 1));
 
   EXPECT_EQ(nullptr, oldBridge);
 
   Bridge* oldBridge15s = nullptr;
 
   ASSERT_EQ(nullptr, game.connect(island5, island1, true, &oldBridge15s));
-  ASSERT_EQ(island5->_bridges[0], bridge15s);
-  ASSERT_EQ(1, island5->_bridges.size());
-  ASSERT_EQ(island1->_bridges[0], bridge15s);
-  ASSERT_EQ(1, island1->_bridges.size());
+  ASSERT_EQ(island5->_bridges[Direction::UP._index], bridge15s);
+  ASSERT_EQ(1, island5->bridgeCount());
+  ASSERT_EQ(island1->_bridges[Direction::DOWN._index], bridge15s);
+  ASSERT_EQ(1, island1->bridgeCount());
 
   EXPECT_EQ(nullptr, oldBridge15s);
 
@@ -179,28 +206,28 @@ TEST(GameTest, connect) {
   ASSERT_EQ(island5, bridge51d->_one);
   ASSERT_EQ(island1, bridge51d->_two);
   ASSERT_TRUE(bridge51d->_doubleBridge);
-  ASSERT_EQ(island5->_bridges[0], bridge51d);
-  ASSERT_EQ(1, island5->_bridges.size());
-  ASSERT_EQ(island1->_bridges[0], bridge51d);
-  ASSERT_EQ(1, island1->_bridges.size());
+  ASSERT_EQ(island5->_bridges[Direction::UP._index], bridge51d);
+  ASSERT_EQ(1, island5->bridgeCount());
+  ASSERT_EQ(island1->_bridges[Direction::DOWN._index], bridge51d);
+  ASSERT_EQ(1, island1->bridgeCount());
 
   EXPECT_EQ(bridge15s, oldBridge15s);
-  delete bridge15s;
+  game.recycle(bridge15s);
 
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
+  EXPECT_TRUE(game._occupation.get(0, 1));
 
   Bridge* bridge16s = game.connect(island1, island6, false, &oldBridge);
   ASSERT_NE(nullptr, bridge16s);
   ASSERT_EQ(island1, bridge16s->_one);
   ASSERT_EQ(island6, bridge16s->_two);
   ASSERT_FALSE(bridge16s->_doubleBridge);
-  ASSERT_EQ(island1->_bridges[1], bridge16s);
-  ASSERT_EQ(2, island1->_bridges.size());
-  ASSERT_EQ(island6->_bridges[0], bridge16s);
-  ASSERT_EQ(1, island6->_bridges.size());
+  ASSERT_EQ(island1->_bridges[Direction::RIGHT._index], bridge16s);
+  ASSERT_EQ(2, island1->bridgeCount());
+  ASSERT_EQ(island6->_bridges[Direction::LEFT._index], bridge16s);
+  ASSERT_EQ(1, island6->bridgeCount());
 
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
-  EXPECT_TRUE(game._bridgeOccupation[1][0]);
+  EXPECT_TRUE(game._occupation.get(0, 1));
+  EXPECT_TRUE(game._occupation.get(1, 0));
 
   EXPECT_EQ(nullptr, oldBridge);
 
@@ -208,18 +235,18 @@ TEST(GameTest, connect) {
 
 
   ASSERT_EQ(nullptr, game.connect(island1, island6, true, &oldBridge16s));
-  ASSERT_EQ(island1->_bridges[1], bridge16s);
-  ASSERT_EQ(2, island1->_bridges.size());
-  ASSERT_EQ(island6->_bridges[0], bridge16s);
-  ASSERT_EQ(1, island6->_bridges.size());
+  ASSERT_EQ(island1->_bridges[Direction::RIGHT._index], bridge16s);
+  ASSERT_EQ(2, island1->bridgeCount());
+  ASSERT_EQ(island6->_bridges[Direction::LEFT._index], bridge16s);
+  ASSERT_EQ(1, island6->bridgeCount());
 
   EXPECT_EQ(nullptr, oldBridge16s);
 
   ASSERT_EQ(nullptr, game.connect(island6, island1, true, &oldBridge16s));
-  ASSERT_EQ(island6->_bridges[0], bridge16s);
-  ASSERT_EQ(1, island6->_bridges.size());
-  ASSERT_EQ(island1->_bridges[1], bridge16s);
-  ASSERT_EQ(2, island1->_bridges.size());
+  ASSERT_EQ(island6->_bridges[Direction::LEFT._index], bridge16s);
+  ASSERT_EQ(1, island6->bridgeCount());
+  ASSERT_EQ(island1->_bridges[Direction::RIGHT._index], bridge16s);
+  ASSERT_EQ(2, island1->bridgeCount());
 
   EXPECT_EQ(nullptr, oldBridge16s);
 
@@ -228,16 +255,43 @@ TEST(GameTest, connect) {
   ASSERT_EQ(island6, bridge61d->_one);
   ASSERT_EQ(island1, bridge61d->_two);
   ASSERT_TRUE(bridge61d->_doubleBridge);
-  ASSERT_EQ(island6->_bridges[0], bridge61d);
-  ASSERT_EQ(1, island6->_bridges.size());
-  ASSERT_EQ(island1->_bridges[1], bridge61d);
-  ASSERT_EQ(2, island1->_bridges.size());
+  ASSERT_EQ(island6->_bridges[Direction::LEFT._index], bridge61d);
+  ASSERT_EQ(1, island6->bridgeCount());
+  ASSERT_EQ(island1->_bridges[Direction::RIGHT._index], bridge61d);
+  ASSERT_EQ(2, island1->bridgeCount());
 
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
-  EXPECT_TRUE(game._bridgeOccupation[1][0]);
+  EXPECT_TRUE(game._occupation.get(0, 1));
+  EXPECT_TRUE(game._occupation.get(1, 0));
 
   EXPECT_EQ(bridge16s, oldBridge16s);
-  delete bridge16s;
+  game.recycle(bridge16s);
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, connectOccupiedDirection) {
+  Game game({
+    Island(0, 0, 2),
+    Island(2, 0, 2),
+    Island(4, 0, 2)
+  });
+  auto island1 = game.getIsland(0, 0);
+  auto island2 = game.getIsland(2, 0);
+  auto island3 = game.getIsland(4, 0);
+
+  // Connecting across an Island is technically possible
+  auto bridge = game.connect(island1, island3, false);
+  ASSERT_NE(nullptr, bridge);
+  EXPECT_EQ(bridge, island1->_bridges[Direction::RIGHT._index]);
+  EXPECT_EQ(bridge, island3->_bridges[Direction::LEFT._index]);
+
+  // but both ends have only one slot per direction
+  EXPECT_EQ(nullptr, game.connect(island1, island2, false));
+  EXPECT_EQ(nullptr, game.connect(island2, island3, false));
+  EXPECT_EQ(nullptr, game.connect(island3, island2, true));
+  EXPECT_EQ(0, island2->bridgeCount());
+  EXPECT_EQ(1, island1->bridgeCount());
+  EXPECT_EQ(1, island3->bridgeCount());
 }
 
 // _____________________________________________________________________________
@@ -259,10 +313,117 @@ TEST(BridgeTest, constructor) {
 
 // _____________________________________________________________________________
 
+TEST(BridgePoolTest, acquire) {
+  Island island1(0, 0, 1);
+  Island island2(0, 2, 1);
+  BridgePool pool;
+  EXPECT_EQ(0, pool._blocks.size());
+  EXPECT_EQ(0, pool.statistics().blockAllocations);
+
+  Bridge* bridge1 = pool.acquire(&island1, &island2, true);
+  EXPECT_EQ(&island1, bridge1->_one);
+  EXPECT_EQ(&island2, bridge1->_two);
+  EXPECT_TRUE(bridge1->_doubleBridge);
+  EXPECT_EQ(1, pool.statistics().blockAllocations);
+  EXPECT_EQ(BridgePool::BLOCK_SIZE - 1, pool._unused);
+
+  std::vector<Bridge*> bridges;
+  for (size_t i = 1; i < BridgePool::BLOCK_SIZE; i++) {
+    bridges.push_back(pool.acquire(&island2, &island1, false));
+  }
+  // All bridges fit into the first block and are laid out consecutively
+  EXPECT_EQ(1, pool.statistics().blockAllocations);
+  EXPECT_EQ(0, pool._unused);
+  EXPECT_EQ(reinterpret_cast<BridgePool::Slot*>(bridge1) + 1,
+    reinterpret_cast<BridgePool::Slot*>(bridges[0]));
+
+  Bridge* bridge2 = pool.acquire(&island2, &island1, false);
+  EXPECT_EQ(&island2, bridge2->_one);
+  EXPECT_FALSE(bridge2->_doubleBridge);
+  EXPECT_EQ(2, pool.statistics().blockAllocations);
+  EXPECT_EQ(BridgePool::BLOCK_SIZE + 1, pool.statistics().acquired);
+  EXPECT_EQ(BridgePool::BLOCK_SIZE + 1, pool.statistics().peak);
+  EXPECT_EQ(0, pool.statistics().recycled);
+}
+
+// _____________________________________________________________________________
+
+TEST(BridgePoolTest, recycle) {
+  Island island1(0, 0, 1);
+  Island island2(0, 2, 1);
+  BridgePool pool;
+
+  Bridge* bridge1 = pool.acquire(&island1, &island2, false);
+  Bridge* bridge2 = pool.acquire(&island1, &island2, false);
+  pool.recycle(bridge1);
+  pool.recycle(bridge2);
+  EXPECT_EQ(2, pool.statistics().recycled);
+
+  // Recycled memory is handed out again, most recently recycled first
+  EXPECT_EQ(bridge2, pool.acquire(&island2, &island1, true));
+  EXPECT_EQ(bridge1, pool.acquire(&island2, &island1, true));
+  EXPECT_TRUE(bridge1->_doubleBridge);
+  EXPECT_EQ(&island2, bridge1->_one);
+
+  // In a steady state no more memory gets allocated
+  for (int i = 0; i < 10000; i++) {
+    pool.recycle(pool.acquire(&island1, &island2, false));
+  }
+  EXPECT_EQ(1, pool.statistics().blockAllocations);
+  EXPECT_EQ(10004, pool.statistics().acquired);
+  EXPECT_EQ(10002, pool.statistics().recycled);
+  EXPECT_EQ(3, pool.statistics().peak);
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, bridgeStatistics) {
+  Game game({
+    Island(0, 0, 2),
+    Island(2, 0, 2)
+  });
+  auto island1 = game.getIsland(0, 0);
+  auto island2 = game.getIsland(2, 0);
+
+  for (int i = 0; i < 1000; i++) {
+    Bridge* bridge = game.connect(island1, island2, false);
+    // Upgrading to a double bridge recycles the single one once
+    // the double bridge has replaced it
+    bridge = game.connect(island1, island2, false);
+    game.disconnect(bridge);
+    game.recycle(bridge);
+  }
+  EXPECT_EQ(1, game.bridgeStatistics().blockAllocations);
+  EXPECT_EQ(2000, game.bridgeStatistics().acquired);
+  EXPECT_EQ(2000, game.bridgeStatistics().recycled);
+  EXPECT_EQ(2, game.bridgeStatistics().peak);
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, moveConstructor) {
+  Game game({
+    Island(0, 0, 1),
+    Island(2, 0, 1)
+  });
+  auto island1 = game.getIsland(0, 0);
+  auto island2 = game.getIsland(2, 0);
+  auto bridge = game.connect(island1, island2, false);
+
+  Game moved(std::move(game));
+  EXPECT_EQ(island1, moved.getIsland(0, 0));
+  EXPECT_EQ(island2, moved.getIsland(2, 0));
+  ASSERT_EQ(1, island1->bridgeCount());
+  EXPECT_EQ(bridge, island1->_bridges[Direction::RIGHT._index]);
+  EXPECT_TRUE(moved.isSolved());
+}
+
+// _____________________________________________________________________________
+
 TEST(DirectionTest, constructor) {
-  Direction direction1(-100, 0);
-  Direction direction2(0, -100);
-  Direction direction3(100, 100);
+  Direction direction1(-100, 0, 3);
+  Direction direction2(0, -100, 0);
+  Direction direction3(100, 100, 2);
 
   EXPECT_EQ(-100, direction1._xchange);
   EXPECT_EQ(0, direction1._ychange);
@@ -272,6 +433,10 @@ TEST(DirectionTest, constructor) {
 
   EXPECT_EQ(100, direction3._xchange);
   EXPECT_EQ(100, direction3._ychange);
+
+  EXPECT_EQ(3, direction1._index);
+  EXPECT_EQ(0, direction2._index);
+  EXPECT_EQ(2, direction3._index);
 }
 
 // _____________________________________________________________________________
@@ -288,6 +453,23 @@ TEST(DirectionTest, predefinedValues) {
 
   EXPECT_EQ(-1, Direction::LEFT._xchange);
   EXPECT_EQ(0, Direction::LEFT._ychange);
+
+  for (uint8_t i = 0; i < 4; i++) {
+    EXPECT_EQ(i, Direction::ALL[i]->_index);
+  }
+  EXPECT_EQ(&Direction::UP, Direction::ALL[0]);
+  EXPECT_EQ(&Direction::RIGHT, Direction::ALL[1]);
+  EXPECT_EQ(&Direction::DOWN, Direction::ALL[2]);
+  EXPECT_EQ(&Direction::LEFT, Direction::ALL[3]);
+}
+
+// _____________________________________________________________________________
+
+TEST(DirectionTest, opposite) {
+  EXPECT_EQ(&Direction::DOWN, &Direction::UP.opposite());
+  EXPECT_EQ(&Direction::LEFT, &Direction::RIGHT.opposite());
+  EXPECT_EQ(&Direction::UP, &Direction::DOWN.opposite());
+  EXPECT_EQ(&Direction::RIGHT, &Direction::LEFT.opposite());
 }
 
 // _____________________________________________________________________________
@@ -330,77 +512,150 @@ TEST(IslandTest, missingConnections) {
   EXPECT_EQ(8, island8.missingConnections());
   EXPECT_EQ(9, island9.missingConnections());
 
-  Bridge dummy1(nullptr, nullptr, false);
-  Bridge dummy2(nullptr, nullptr, true);
+  Island other(0, 25, 0);
+  Bridge single0(&island0, &other, false);
+  Bridge double0(&other, &island0, true);
 
-  island0._bridges.push_back(&dummy1);
+  island0.attach(&single0);
   EXPECT_EQ(-1, island0.missingConnections());
 
-  island0._bridges.clear();
-  island0._bridges.push_back(&dummy2);
+  island0.detach(&single0);
+  island0.attach(&double0);
   EXPECT_EQ(-2, island0.missingConnections());
 
-  island0._bridges.clear();
+  island0.detach(&double0);
+  EXPECT_EQ(0, island0.missingConnections());
 
-  island5._bridges.push_back(&dummy1);
-  island5._bridges.push_back(&dummy2);
-  island5._bridges.push_back(&dummy2);
+  Island up(5, 0, 0);
+  Island right(9, 25, 0);
+  Bridge single5(&island5, &other, false);
+  Bridge double5(&island5, &up, true);
+  Bridge double5b(&right, &island5, true);
+  island5.attach(&single5);
+  island5.attach(&double5);
+  island5.attach(&double5b);
 
   EXPECT_EQ(0, island5.missingConnections());
 
-  island5._bridges.clear();
-
-  island8._bridges.push_back(&dummy2);
-  island8._bridges.push_back(&dummy2);
-  island8._bridges.push_back(&dummy2);
-  island8._bridges.push_back(&dummy2);
-  island8._bridges.push_back(&dummy2);
-
-  EXPECT_EQ(-2, island8.missingConnections());
+  island5.detach(&double5);
+  EXPECT_EQ(2, island5.missingConnections());
+  island5.detach(&double5b);
+  island5.detach(&single5);
+  EXPECT_EQ(5, island5.missingConnections());
 
-  island8._bridges.clear();
+  Island island8up(21, 0, 0);
+  Island island8right(30, 64, 0);
+  Island island8down(21, 70, 0);
+  Island island8left(0, 64, 0);
+  Bridge double8up(&island8, &island8up, true);
+  Bridge double8right(&island8, &island8right, true);
+  Bridge double8down(&island8, &island8down, true);
+  Bridge double8left(&island8, &island8left, true);
+  island8.attach(&double8up);
+  island8.attach(&double8right);
+  island8.attach(&double8down);
+  island8.attach(&double8left);
+
+  EXPECT_EQ(0, island8.missingConnections());
+
+  // Bridges that can't belong to the Island are ignored
+  island3.attach(&double8up);
+  EXPECT_EQ(3, island3.missingConnections());
 }
 
 // _____________________________________________________________________________
 
 TEST(IslandTest, isConnected) {
   Island islanda(0, 0, 1);
-  Island islandb(8, 8, 8);
+  Island islandb(0, 8, 8);
+  Island islandc(0, 4, 8);
+  Island islandd(8, 8, 8);
 
   EXPECT_EQ(0, islanda.isConnected(&islandb));
   EXPECT_EQ(0, islandb.isConnected(&islanda));
+  // Islands that aren't aligned can never be connected
+  EXPECT_EQ(0, islanda.isConnected(&islandd));
 
   Bridge bridge(&islanda, &islandb, false);
-  islanda._bridges.push_back(&bridge);
-  islandb._bridges.push_back(&bridge);
+  islanda.attach(&bridge);
+  islandb.attach(&bridge);
 
   EXPECT_EQ(1, islanda.isConnected(&islandb));
   EXPECT_EQ(1, islandb.isConnected(&islanda));
+  // Same direction, but the bridge ends at a different Island
+  EXPECT_EQ(0, islanda.isConnected(&islandc));
 
-  islanda._bridges.push_back(&bridge);
-  islandb._bridges.push_back(&bridge);
-
-  EXPECT_EQ(1, islanda.isConnected(&islandb));
-  EXPECT_EQ(1, islandb.isConnected(&islanda));
-
-  islanda._bridges.clear();
-  islandb._bridges.clear();
+  islanda.detach(&bridge);
+  islandb.detach(&bridge);
+  EXPECT_EQ(0, islanda.isConnected(&islandb));
+  EXPECT_EQ(0, islandb.isConnected(&islanda));
 
   Bridge bridge2(&islanda, &islandb, true);
-  islanda._bridges.push_back(&bridge2);
-  islandb._bridges.push_back(&bridge2);
+  islanda.attach(&bridge2);
+  islandb.attach(&bridge2);
 
   EXPECT_EQ(2, islanda.isConnected(&islandb));
   EXPECT_EQ(2, islandb.isConnected(&islanda));
+}
 
-  islanda._bridges.push_back(&bridge2);
-  islandb._bridges.push_back(&bridge2);
+// _____________________________________________________________________________
 
-  EXPECT_EQ(2, islanda.isConnected(&islandb));
-  EXPECT_EQ(2, islandb.isConnected(&islanda));
+TEST(IslandTest, attach) {
+  Island center(4, 4, 8);
+  Island up(4, 0, 2);
+  Island right(8, 4, 2);
+  Island left(0, 4, 2);
+  Bridge bridgeUp(&up, &center, true);
+  Bridge bridgeRight(&center, &right, false);
+  Bridge bridgeLeft(&left, &center, true);
+
+  center.attach(&bridgeUp);
+  center.attach(&bridgeRight);
+  center.attach(&bridgeLeft);
+  ASSERT_EQ(3, center.bridgeCount());
+  EXPECT_EQ(5, center._degree);
+  EXPECT_EQ(2, center._multiplicity[Direction::UP._index]);
+  EXPECT_EQ(1, center._multiplicity[Direction::RIGHT._index]);
+  EXPECT_EQ(0, center._multiplicity[Direction::DOWN._index]);
+  EXPECT_EQ(2, center._multiplicity[Direction::LEFT._index]);
+  EXPECT_TRUE(center.hasConsistentCounters());
+
+  center.detach(&bridgeRight);
+  ASSERT_EQ(2, center.bridgeCount());
+  EXPECT_EQ(&bridgeUp, center._bridges[Direction::UP._index]);
+  EXPECT_EQ(nullptr, center._bridges[Direction::RIGHT._index]);
+  EXPECT_EQ(&bridgeLeft, center._bridges[Direction::LEFT._index]);
+  EXPECT_EQ(4, center._degree);
+  EXPECT_EQ(0, center._multiplicity[Direction::RIGHT._index]);
+
+  // Detaching a Bridge that isn't attached changes nothing
+  center.detach(&bridgeRight);
+  EXPECT_EQ(4, center._degree);
+  EXPECT_TRUE(center.hasConsistentCounters());
+}
+
+// _____________________________________________________________________________
 
-  islanda._bridges.clear();
-  islandb._bridges.clear();
+TEST(IslandTest, counters) {
+  Island center(4, 4, 8);
+  Island down(4, 8, 2);
+  Bridge bridge(&center, &down, true);
+  center.attach(&bridge);
+  EXPECT_TRUE(center.hasConsistentCounters());
+
+  // Changes that bypass attach and detach are detected
+  center._bridges[Direction::DOWN._index] = nullptr;
+  EXPECT_FALSE(center.hasConsistentCounters());
+  center._multiplicity[Direction::DOWN._index] = 0;
+  EXPECT_FALSE(center.hasConsistentCounters());
+  center._degree = 0;
+  EXPECT_TRUE(center.hasConsistentCounters());
+
+  // Bridges have to be in the slot they point to
+  center._bridges[Direction::UP._index] = &bridge;
+  center._multiplicity[Direction::UP._index] = 2;
+  center._degree = 2;
+  EXPECT_FALSE(center.hasConsistentCounters());
 }
 
 // _____________________________________________________________________________
@@ -540,7 +795,7 @@ TEST(IslandTest, isCorrectlyAlignedWith) {
 // _____________________________________________________________________________
 
 TEST(IslandViewTest, constructor) {
-  std::unordered_map<uint32_t, Island*> islands;
+  std::vector<Island*> islands;
   IslandView view(islands);
 
   EXPECT_EQ(&islands, &view._islands);
@@ -549,18 +804,18 @@ TEST(IslandViewTest, constructor) {
 // _____________________________________________________________________________
 
 TEST(IslandViewTest, size) {
-  std::unordered_map<uint32_t, Island*> islands;
+  std::vector<Island*> islands;
   IslandView view(islands);
 
   EXPECT_EQ(0, view.size());
 
-  islands[0] = nullptr;
+  islands.push_back(nullptr);
   EXPECT_EQ(1, view.size());
 
-  islands[1] = nullptr;
+  islands.push_back(nullptr);
   EXPECT_EQ(2, view.size());
 
-  islands[2] = nullptr;
+  islands.push_back(nullptr);
   EXPECT_EQ(3, view.size());
 
   islands.clear();
@@ -579,10 +834,10 @@ TEST(IslandViewTest, testIteration) {
     island3.get()
   };
   std::sort(reference.begin(), reference.end());
-  std::unordered_map<uint32_t, Island*> islands = {
-    { 0, island1.get() },
-    { 1, island2.get() },
-    { 2, island3.get() }
+  std::vector<Island*> islands = {
+    island1.get(),
+    island2.get(),
+    island3.get()
   };
 
   IslandView view(islands);
@@ -598,25 +853,53 @@ TEST(IslandViewTest, testIteration) {
 
 // _____________________________________________________________________________
 
-TEST(GameTest, islandVectorToMap) {
-  Game game({ Island(4, 4, 0) });
-  auto map = game.islandVectorToMap({
-    Island(0, 0, 0),
+TEST(GameTest, copyIslands) {
+  Island original(2, 3, 5);
+  auto islands = Game::copyIslands({
+    original,
     Island(1, 1, 0),
-    Island(2, 3, 0)
+    Island(0, 0, 0),
+    Island(3, 0, 1),
+    // Replaces the first island on the same cell
+    Island(1, 1, 4)
   });
 
-  ASSERT_EQ(3, map.size());
-  EXPECT_EQ(0, map[0]->_x);
-  EXPECT_EQ(0, map[0]->_y);
-  EXPECT_EQ(1, map[1 + 1 * 5]->_x);
-  EXPECT_EQ(1, map[1 + 1 * 5]->_y);
-  EXPECT_EQ(2, map[2 + 3 * 5]->_x);
-  EXPECT_EQ(3, map[2 + 3 * 5]->_y);
+  // Islands are sorted in row-major order
+  ASSERT_EQ(4, islands.size());
+  EXPECT_EQ(0, islands[0]._x);
+  EXPECT_EQ(0, islands[0]._y);
+  EXPECT_EQ(3, islands[1]._x);
+  EXPECT_EQ(0, islands[1]._y);
+  EXPECT_EQ(1, islands[2]._x);
+  EXPECT_EQ(1, islands[2]._y);
+  EXPECT_EQ(4, islands[2]._requiredBridges);
+  EXPECT_EQ(2, islands[3]._x);
+  EXPECT_EQ(3, islands[3]._y);
+  EXPECT_EQ(5, islands[3]._requiredBridges);
+  EXPECT_NE(&original, &islands[3]);
+}
 
-  for (const auto &entry : map) {
-    delete entry.second;
+// _____________________________________________________________________________
+
+TEST(GameTest, islandStorage) {
+  Game game({
+    Island(2, 2, 1),
+    Island(0, 2, 2),
+    Island(2, 0, 3),
+    Island(0, 0, 4)
+  });
+  auto view = game.getIslands();
+  ASSERT_EQ(4, view.size());
+  ASSERT_EQ(4, game._storage.size());
+  for (size_t i = 0; i < view.size(); i++) {
+    // The view hands out pointers into the contiguous storage
+    EXPECT_EQ(&game._storage[i], view[i]);
+    EXPECT_EQ(i, view[i]->_index);
   }
+  EXPECT_EQ(game.getIsland(0, 0), view[0]);
+  EXPECT_EQ(game.getIsland(2, 0), view[1]);
+  EXPECT_EQ(game.getIsland(0, 2), view[2]);
+  EXPECT_EQ(game.getIsland(2, 2), view[3]);
 }
 
 // _____________________________________________________________________________
@@ -635,40 +918,40 @@ TEST(GameTest, registerBridge) {
   Bridge bridge2(island1, island3, true);
 
   game.registerBridge(&bridge1, true);
-  EXPECT_FALSE(game._bridgeOccupation[0][0]);
-  EXPECT_TRUE(game._bridgeOccupation[1][0]);
-  EXPECT_TRUE(game._bridgeOccupation[2][0]);
-  EXPECT_FALSE(game._bridgeOccupation[3][0]);
-  EXPECT_FALSE(game._bridgeOccupation[0][1]);
-  EXPECT_FALSE(game._bridgeOccupation[0][2]);
-  EXPECT_FALSE(game._bridgeOccupation[0][3]);
+  EXPECT_FALSE(game._occupation.get(0, 0));
+  EXPECT_TRUE(game._occupation.get(1, 0));
+  EXPECT_TRUE(game._occupation.get(2, 0));
+  EXPECT_FALSE(game._occupation.get(3, 0));
+  EXPECT_FALSE(game._occupation.get(0, 1));
+  EXPECT_FALSE(game._occupation.get(0, 2));
+  EXPECT_FALSE(game._occupation.get(0, 3));
 
   game.registerBridge(&bridge2, true);
-  EXPECT_FALSE(game._bridgeOccupation[0][0]);
-  EXPECT_TRUE(game._bridgeOccupation[1][0]);
-  EXPECT_TRUE(game._bridgeOccupation[2][0]);
-  EXPECT_FALSE(game._bridgeOccupation[3][0]);
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
-  EXPECT_TRUE(game._bridgeOccupation[0][2]);
-  EXPECT_FALSE(game._bridgeOccupation[0][3]);
+  EXPECT_FALSE(game._occupation.get(0, 0));
+  EXPECT_TRUE(game._occupation.get(1, 0));
+  EXPECT_TRUE(game._occupation.get(2, 0));
+  EXPECT_FALSE(game._occupation.get(3, 0));
+  EXPECT_TRUE(game._occupation.get(0, 1));
+  EXPECT_TRUE(game._occupation.get(0, 2));
+  EXPECT_FALSE(game._occupation.get(0, 3));
 
   game.registerBridge(&bridge1, false);
-  EXPECT_FALSE(game._bridgeOccupation[0][0]);
-  EXPECT_FALSE(game._bridgeOccupation[1][0]);
-  EXPECT_FALSE(game._bridgeOccupation[2][0]);
-  EXPECT_FALSE(game._bridgeOccupation[3][0]);
-  EXPECT_TRUE(game._bridgeOccupation[0][1]);
-  EXPECT_TRUE(game._bridgeOccupation[0][2]);
-  EXPECT_FALSE(game._bridgeOccupation[0][3]);
+  EXPECT_FALSE(game._occupation.get(0, 0));
+  EXPECT_FALSE(game._occupation.get(1, 0));
+  EXPECT_FALSE(game._occupation.get(2, 0));
+  EXPECT_FALSE(game._occupation.get(3, 0));
+  EXPECT_TRUE(game._occupation.get(0, 1));
+  EXPECT_TRUE(game._occupation.get(0, 2));
+  EXPECT_FALSE(game._occupation.get(0, 3));
 
   game.registerBridge(&bridge2, false);
-  EXPECT_FALSE(game._bridgeOccupation[0][0]);
-  EXPECT_FALSE(game._bridgeOccupation[1][0]);
-  EXPECT_FALSE(game._bridgeOccupation[2][0]);
-  EXPECT_FALSE(game._bridgeOccupation[3][0]);
-  EXPECT_FALSE(game._bridgeOccupation[0][1]);
-  EXPECT_FALSE(game._bridgeOccupation[0][2]);
-  EXPECT_FALSE(game._bridgeOccupation[0][3]);
+  EXPECT_FALSE(game._occupation.get(0, 0));
+  EXPECT_FALSE(game._occupation.get(1, 0));
+  EXPECT_FALSE(game._occupation.get(2, 0));
+  EXPECT_FALSE(game._occupation.get(3, 0));
+  EXPECT_FALSE(game._occupation.get(0, 1));
+  EXPECT_FALSE(game._occupation.get(0, 2));
+  EXPECT_FALSE(game._occupation.get(0, 3));
 }
 
 // _____________________________________________________________________________
@@ -727,8 +1010,8 @@ TEST(GameTest, findAccessibleIsland) {
 
   game.disconnect(bridge1);
   game.disconnect(bridge2);
-  delete bridge1;
-  delete bridge2;
+  game.recycle(bridge1);
+  game.recycle(bridge2);
   // Block connection
   game.connect(island4, island5, false);
 
@@ -833,12 +1116,12 @@ TEST(GameTest, isSolved) {
   game.disconnect(bridge5);
   game.disconnect(bridge6);
   EXPECT_FALSE(game.isSolved());
-  delete bridge1;
-  delete bridge2;
-  delete bridge3;
-  delete bridge4;
-  delete bridge5;
-  delete bridge6;
+  game.recycle(bridge1);
+  game.recycle(bridge2);
+  game.recycle(bridge3);
+  game.recycle(bridge4);
+  game.recycle(bridge5);
+  game.recycle(bridge6);
 }
 
 // _____________________________________________________________________________
@@ -1011,14 +1294,14 @@ TEST(GameTest, disconnect) {
 
   game.disconnect(bridge);
 
-  delete bridge;
+  game.recycle(bridge);
 
-  EXPECT_EQ(0, island1->_bridges.size());
-  EXPECT_EQ(0, island2->_bridges.size());
+  EXPECT_EQ(0, island1->bridgeCount());
+  EXPECT_EQ(0, island2->bridgeCount());
 
-  EXPECT_FALSE(game._bridgeOccupation[0][0]);
-  EXPECT_FALSE(game._bridgeOccupation[1][0]);
-  EXPECT_FALSE(game._bridgeOccupation[2][0]);
+  EXPECT_FALSE(game._occupation.get(0, 0));
+  EXPECT_FALSE(game._occupation.get(1, 0));
+  EXPECT_FALSE(game._occupation.get(2, 0));
 }
 
 // _____________________________________________________________________________
@@ -1035,13 +1318,680 @@ TEST(GameTest, reconnect) {
   game.disconnect(bridge);
   game.reconnect(bridge);
 
-  ASSERT_EQ(1, island1->_bridges.size());
-  ASSERT_EQ(1, island2->_bridges.size());
+  ASSERT_EQ(1, island1->bridgeCount());
+  ASSERT_EQ(1, island2->bridgeCount());
+
+  ASSERT_EQ(bridge, island1->_bridges[Direction::RIGHT._index]);
+  ASSERT_EQ(bridge, island2->_bridges[Direction::LEFT._index]);
+
+  EXPECT_FALSE(game._occupation.get(0, 0));
+  EXPECT_TRUE(game._occupation.get(1, 0));
+  EXPECT_FALSE(game._occupation.get(2, 0));
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, neighbourTable) {
+  Game game({
+    Island(0, 0, 1),
+    Island(3, 0, 1),
+    Island(6, 0, 1),
+    Island(3, 2, 1),
+    Island(0, 4, 1),
+    Island(3, 4, 1),
+    Island(1, 2, 1),
+    Island(1, 6, 1)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i30 = game.getIsland(3, 0);
+  auto i60 = game.getIsland(6, 0);
+  auto i32 = game.getIsland(3, 2);
+  auto i04 = game.getIsland(0, 4);
+  auto i34 = game.getIsland(3, 4);
+  auto i12 = game.getIsland(1, 2);
+  auto i16 = game.getIsland(1, 6);
+
+  auto rows = Game::groupIntoLines(game._islands.islands(), Direction::RIGHT);
+  auto columns = Game::groupIntoLines(game._islands.islands(),
+    Direction::DOWN);
+  ASSERT_EQ(4, rows.size());
+  ASSERT_EQ(4, columns.size());
+  EXPECT_EQ(0, rows[0].position);
+  ASSERT_EQ(3, rows[0].islands.size());
+  EXPECT_EQ(i00, rows[0].islands[0]);
+  EXPECT_EQ(i30, rows[0].islands[1]);
+  EXPECT_EQ(i60, rows[0].islands[2]);
+  EXPECT_EQ(3, columns[2].position);
+  ASSERT_EQ(3, columns[2].islands.size());
+  EXPECT_EQ(i30, columns[2].islands[0]);
+  EXPECT_EQ(i32, columns[2].islands[1]);
+  EXPECT_EQ(i34, columns[2].islands[2]);
+
+  EXPECT_EQ(nullptr, game.neighbour(*i00, Direction::UP));
+  EXPECT_EQ(i30, game.neighbour(*i00, Direction::RIGHT));
+  EXPECT_EQ(i04, game.neighbour(*i00, Direction::DOWN));
+  EXPECT_EQ(nullptr, game.neighbour(*i00, Direction::LEFT));
+  EXPECT_EQ(i12, game.neighbour(*i16, Direction::UP));
+  EXPECT_EQ(i32, game.neighbour(*i12, Direction::RIGHT));
+  EXPECT_EQ(i12, game.neighbour(*i32, Direction::LEFT));
+
+  // Crosses the path between (1, 2) and (1, 6) and runs along the path
+  // between (0, 4) and (3, 4)
+  auto bridge = game.connect(i04, i34, false);
+  EXPECT_EQ(nullptr, game.findAccessibleIsland(*i12, Direction::DOWN));
+  EXPECT_EQ(nullptr, game.findAccessibleIsland(*i16, Direction::UP));
+  EXPECT_EQ(i34, game.findAccessibleIsland(*i04, Direction::RIGHT));
+  EXPECT_EQ(i04, game.findAccessibleIsland(*i00, Direction::DOWN));
+  // The neighbours don't depend on the bridges
+  EXPECT_EQ(i16, game.neighbour(*i12, Direction::DOWN));
+
+  // Only runs along its own path
+  auto bridge2 = game.connect(i30, i32, true);
+  EXPECT_EQ(i32, game.findAccessibleIsland(*i12, Direction::RIGHT));
+  EXPECT_EQ(i32, game.findAccessibleIsland(*i30, Direction::DOWN));
+  EXPECT_EQ(i34, game.findAccessibleIsland(*i32, Direction::DOWN));
+
+  game.disconnect(bridge);
+  game.disconnect(bridge2);
+  game.recycle(bridge);
+  game.recycle(bridge2);
+  EXPECT_EQ(i16, game.findAccessibleIsland(*i12, Direction::DOWN));
+}
+
+// _____________________________________________________________________________
+
+// Reference implementation of Game::findAccessibleIsland that walks the grid
+// cell by cell using only the public interface of the Game
+Island* walkToIsland(const Game &game, const Island &origin,
+  const Direction &dir, const std::vector<std::vector<bool>> &occupied) {
+  for (const auto &island : game.findAccessibleIslands(origin)) {
+    if (origin.isConnected(island) && origin.findDirection(island) == &dir) {
+      return island;
+    }
+  }
+  uint32_t x = origin._x + dir._xchange;
+  uint32_t y = origin._y + dir._ychange;
+  while (x < occupied.size() && y < occupied[x].size()) {
+    if (occupied[x][y]) {
+      return nullptr;
+    }
+    Island* island = game.getIsland(x, y);
+    if (island != nullptr) {
+      return island;
+    }
+    x += dir._xchange;
+    y += dir._ychange;
+  }
+  return nullptr;
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, findAccessibleIslandRandomized) {
+  std::mt19937 random(1234);
+  for (int round = 0; round < 20; round++) {
+    std::vector<Island> islands;
+    std::bernoulli_distribution hasIsland(0.3);
+    for (uint32_t y = 0; y < 12; y++) {
+      for (uint32_t x = 0; x < 12; x++) {
+        if (hasIsland(random)) {
+          islands.push_back(Island(x, y, 8));
+        }
+      }
+    }
+    Game game(islands);
+    std::vector<Island*> all(game.getIslands().begin(),
+      game.getIslands().end());
+    std::vector<Bridge*> bridges;
+    std::vector<std::vector<bool>> occupied(12, std::vector<bool>(12));
+    for (int step = 0; step < 100; step++) {
+      if (!bridges.empty() && step % 3 == 0) {
+        // remove a random bridge again
+        size_t index = random() % bridges.size();
+        Bridge* bridge = bridges[index];
+        bridges.erase(bridges.begin() + index);
+        game.disconnect(bridge);
+        game.recycle(bridge);
+      } else {
+        // connect a random Island with a reachable neighbour
+        Island* island = all[random() % all.size()];
+        auto reachable = game.findAccessibleIslands(*island);
+        if (reachable.empty()) {
+          continue;
+        }
+        Island* other = reachable[random() % reachable.size()];
+        if (island->isConnected(other) || !island->isCorrectlyAlignedWith(
+          other)) {
+          continue;
+        }
+        bridges.push_back(game.connect(island, other, false));
+      }
+      for (auto &column : occupied) {
+        std::fill(column.begin(), column.end(), false);
+      }
+      for (const auto &bridge : bridges) {
+        for (uint32_t x = std::min(bridge->_one->_x, bridge->_two->_x);
+          x <= std::max(bridge->_one->_x, bridge->_two->_x); x++) {
+          for (uint32_t y = std::min(bridge->_one->_y, bridge->_two->_y);
+            y <= std::max(bridge->_one->_y, bridge->_two->_y); y++) {
+            if (game.getIsland(x, y) == nullptr) {
+              occupied[x][y] = true;
+            }
+          }
+        }
+      }
+      for (const auto &island : all) {
+        ASSERT_TRUE(island->hasConsistentCounters());
+        for (const auto &dir : Direction::ALL) {
+          ASSERT_EQ(walkToIsland(game, *island, *dir, occupied),
+            game.findAccessibleIsland(*island, *dir));
+        }
+      }
+    }
+    for (const auto &bridge : bridges) {
+      game.disconnect(bridge);
+      game.recycle(bridge);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, components) {
+  Game game({
+    Island(0, 0, 2),
+    Island(2, 0, 3),
+    Island(2, 2, 1)
+  });
+  auto island1 = game.getIsland(0, 0);
+  auto island2 = game.getIsland(2, 0);
+  auto island3 = game.getIsland(2, 2);
+  EXPECT_EQ(3, game._components.count());
+  EXPECT_EQ(6, game._components.capacity(0) + game._components.capacity(1)
+    + game._components.capacity(2));
+
+  auto bridge1 = game.connect(island1, island2, false);
+  EXPECT_EQ(2, game._components.count());
+  EXPECT_EQ(3, game._components.capacity(island1->_index));
+  ASSERT_EQ(1, game._unions.size());
+
+  // Upgrading a bridge doesn't merge anything
+  Bridge* oldBridge = nullptr;
+  auto bridge2 = game.connect(island1, island2, false, &oldBridge);
+  EXPECT_EQ(bridge1, oldBridge);
+  EXPECT_EQ(1, game._unions.size());
+  EXPECT_EQ(1, game._components.capacity(island1->_index));
+
+  auto bridge3 = game.connect(island2, island3, false);
+  EXPECT_EQ(1, game._components.count());
+  EXPECT_TRUE(game.isSolved());
+
+  // Removing the last bridge only undoes the last merge
+  game.disconnect(bridge3);
+  EXPECT_EQ(2, game._components.count());
+  EXPECT_EQ(1, game._unions.size());
+  EXPECT_FALSE(game.isSolved());
+
+  game.replace(bridge2, bridge1);
+  EXPECT_EQ(1, island1->missingConnections());
+  EXPECT_EQ(3, game._components.capacity(island2->_index));
+  EXPECT_EQ(2, game._components.count());
+  EXPECT_EQ(bridge1, island1->_bridges[Direction::RIGHT._index]);
+  EXPECT_EQ(bridge1, island2->_bridges[Direction::LEFT._index]);
+
+  // Any other order works as well
+  game.reconnect(bridge3);
+  game.disconnect(bridge1);
+  EXPECT_EQ(2, game._components.count());
+  EXPECT_EQ(game._components.find(island2->_index),
+    game._components.find(island3->_index));
+  EXPECT_NE(game._components.find(island1->_index),
+    game._components.find(island2->_index));
+  EXPECT_EQ(2, game._components.capacity(island1->_index));
+  EXPECT_EQ(2, game._components.capacity(island2->_index));
+  game.disconnect(bridge3);
+  EXPECT_EQ(3, game._components.count());
+  EXPECT_EQ(0, game._unions.size());
+
+  game.recycle(bridge1);
+  game.recycle(bridge2);
+  game.recycle(bridge3);
+}
+
+// _____________________________________________________________________________
 
-  ASSERT_EQ(bridge, island1->_bridges[0]);
-  ASSERT_EQ(bridge, island2->_bridges[0]);
+TEST(GameTest, componentsRandomized) {
+  // Reference implementation of the component based queries of the Game,
+  // collects all Islands that are connected to the given ones
+  auto collectGroup = [](std::deque<Island*> toVisit) {
+    std::vector<Island*> visited(toVisit.begin(), toVisit.end());
+    while (!toVisit.empty()) {
+      Island* current = toVisit.front();
+      toVisit.pop_front();
+      for (const auto &bridge : current->_bridges) {
+        if (bridge == nullptr) {
+          continue;
+        }
+        Island* other = bridge->_one == current ? bridge->_two : bridge->_one;
+        if (std::find(visited.begin(), visited.end(), other)
+          == visited.end()) {
+          visited.push_back(other);
+          toVisit.push_back(other);
+        }
+      }
+    }
+    return visited;
+  };
+
+  std::mt19937 random(4321);
+  for (int round = 0; round < 20; round++) {
+    std::vector<Island> islands;
+    std::bernoulli_distribution hasIsland(0.4);
+    for (uint32_t y = 0; y < 8; y++) {
+      for (uint32_t x = 0; x < 8; x++) {
+        if (hasIsland(random)) {
+          islands.push_back(Island(x, y, 1 + random() % 4));
+        }
+      }
+    }
+    Game game(islands);
+    std::vector<Island*> all(game.getIslands().begin(),
+      game.getIslands().end());
+    std::vector<std::pair<Bridge*, Bridge*>> steps;
+    for (int step = 0; step < 200; step++) {
+      uint32_t action = random() % 4;
+      if (!steps.empty() && action == 0) {
+        // Undo the last step like the Solver does
+        auto last = steps.back();
+        steps.pop_back();
+        if (last.second != nullptr) {
+          game.replace(last.first, last.second);
+        } else {
+          game.disconnect(last.first);
+        }
+        game.recycle(last.first);
+      } else if (!steps.empty() && action == 1) {
+        // Remove a random bridge out of order
+        size_t index = random() % steps.size();
+        Bridge* bridge = steps[index].first;
+        game.disconnect(bridge);
+        game.recycle(bridge);
+        if (steps[index].second != nullptr) {
+          game.recycle(steps[index].second);
+        }
+        steps.erase(steps.begin() + index);
+      } else {
+        Island* island = all[random() % all.size()];
+        auto accessible = game.findAccessibleIslands(*island);
+        if (accessible.empty()) {
+          continue;
+        }
+        Island* other = accessible[random() % accessible.size()];
+        Bridge* oldBridge = nullptr;
+        Bridge* bridge = game.connect(island, other, false, &oldBridge);
+        if (bridge == nullptr) {
+          continue;
+        }
+        if (oldBridge != nullptr) {
+          // The replaced bridge belongs to an earlier step now
+          for (auto &entry : steps) {
+            if (entry.first == oldBridge) {
+              entry.first = bridge;
+              std::swap(oldBridge, entry.second);
+            }
+          }
+          if (oldBridge != nullptr) {
+            game.recycle(oldBridge);
+          }
+        } else {
+          steps.push_back({ bridge, nullptr });
+        }
+      }
+
+      auto group = collectGroup(std::deque<Island*>{ all.front() });
+      bool solved = group.size() == all.size();
+      for (const auto &island : all) {
+        solved = solved && island->missingConnections() == 0;
+      }
+      ASSERT_EQ(solved, game.isSolved());
+      Island* one = all[random() % all.size()];
+      Island* two = all[random() % all.size()];
+      group = collectGroup(std::deque<Island*>{ one });
+      bool closed = group.size() != all.size();
+      for (const auto &island : group) {
+        closed = closed && island->missingConnections() == 0;
+      }
+      ASSERT_EQ(closed, game.isPartOfDisjunctGroup(one));
+      group = collectGroup(std::deque<Island*>{ one, two });
+      closed = group.size() != all.size();
+      for (const auto &island : group) {
+        closed = closed && (island == one || island == two
+          || island->missingConnections() == 0);
+      }
+      ASSERT_EQ(closed, game.wouldCreateDisjunctGroup(one, two));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, snapshot) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3),
+    Island(1, 4, 1)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+  auto i02 = game.getIsland(0, 2);
+  auto i22 = game.getIsland(2, 2);
+
+  GameSnapshot empty = game.snapshot();
+  ASSERT_EQ(10, empty._partners.size());
+  for (const auto &partner : empty._partners) {
+    EXPECT_EQ(GameSnapshot::NONE, partner);
+  }
+
+  game.connect(i00, i20, true);
+  game.connect(i02, i00, false);
+  GameSnapshot checkpoint = game.snapshot();
+  EXPECT_EQ(i20->_index, checkpoint._partners[i00->_index * 2]);
+  EXPECT_EQ(2, checkpoint._multiplicities[i00->_index * 2]);
+  EXPECT_EQ(i02->_index, checkpoint._partners[i00->_index * 2 + 1]);
+  EXPECT_EQ(1, checkpoint._multiplicities[i00->_index * 2 + 1]);
+  EXPECT_EQ(2, checkpoint._unions.size());
+
+  // Speculative work that is thrown away again
+  game.connect(i02, i22, true);
+  game.connect(i20, i22, false);
+  EXPECT_FALSE(game.isSolved());
+  EXPECT_TRUE(game._occupation.get(1, 2));
+
+  ASSERT_TRUE(game.restore(checkpoint));
+  EXPECT_EQ(2, i00->isConnected(i20));
+  EXPECT_EQ(1, i00->isConnected(i02));
+  EXPECT_EQ(0, i02->isConnected(i22));
+  EXPECT_EQ(0, i20->isConnected(i22));
+  EXPECT_EQ(0, i22->bridgeCount());
+  EXPECT_EQ(3, game._components.count());
+  EXPECT_FALSE(game._occupation.get(1, 2));
+  EXPECT_TRUE(game._occupation.get(1, 0));
+  EXPECT_EQ(i22, game.findAccessibleIsland(*i02, Direction::RIGHT));
+  for (const auto &island : game.getIslands()) {
+    EXPECT_TRUE(island->hasConsistentCounters());
+  }
+
+  // The restored state behaves like the original one
+  game.connect(i02, i22, true);
+  game.connect(i20, i22, false);
+  EXPECT_TRUE(game.isPartOfDisjunctGroup(i00));
+  EXPECT_FALSE(game.isSolved());
+
+  ASSERT_TRUE(game.restore(empty));
+  for (const auto &island : game.getIslands()) {
+    EXPECT_EQ(0, island->bridgeCount());
+  }
+  EXPECT_EQ(5, game._components.count());
+  EXPECT_FALSE(game._occupation.get(1, 0));
+  EXPECT_EQ(game.bridgeStatistics().acquired,
+    game.bridgeStatistics().recycled);
 
-  EXPECT_FALSE(game._bridgeOccupation[0][0]);
-  EXPECT_TRUE(game._bridgeOccupation[1][0]);
-  EXPECT_FALSE(game._bridgeOccupation[2][0]);
+  Game other({ Island(0, 0, 1), Island(2, 0, 1) });
+  EXPECT_FALSE(other.restore(checkpoint));
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, clone) {
+  Game game({
+    Island(0, 0, 1),
+    Island(2, 0, 2),
+    Island(2, 2, 1)
+  });
+  game.connect(game.getIsland(0, 0), game.getIsland(2, 0), false);
+
+  Game copy = game.clone();
+  auto i00 = copy.getIsland(0, 0);
+  auto i20 = copy.getIsland(2, 0);
+  auto i22 = copy.getIsland(2, 2);
+  EXPECT_NE(game.getIsland(0, 0), i00);
+  EXPECT_EQ(1, i00->isConnected(i20));
+  EXPECT_EQ(nullptr, copy.findAccessibleIsland(*i00, Direction::DOWN));
+
+  // Both Games are independent of each other
+  copy.connect(i20, i22, false);
+  EXPECT_TRUE(copy.isSolved());
+  EXPECT_FALSE(game.isSolved());
+  EXPECT_EQ(0, game.getIsland(2, 0)->isConnected(game.getIsland(2, 2)));
+
+  // The clone keeps the layout of the island index and the tables
+  // that point to its own Islands
+  for (auto layout : { IslandIndex::Layout::DENSE,
+    IslandIndex::Layout::SPARSE }) {
+    Game original({
+      Island(0, 0, 1),
+      Island(2, 0, 2),
+      Island(2, 2, 1)
+    }, layout);
+    original.connect(original.getIsland(0, 0), original.getIsland(2, 0),
+      false);
+    Game clone = original.clone();
+    EXPECT_EQ(layout, clone._islands.layout());
+    EXPECT_EQ(original._zobristKeys, clone._zobristKeys);
+    EXPECT_EQ(original.hash(), clone.hash());
+    auto c00 = clone.getIsland(0, 0);
+    auto c20 = clone.getIsland(2, 0);
+    auto c22 = clone.getIsland(2, 2);
+    EXPECT_EQ(&clone._storage[0], c00);
+    EXPECT_EQ(c20, clone.neighbour(*c00, Direction::RIGHT));
+    EXPECT_EQ(c22, clone.neighbour(*c20, Direction::DOWN));
+    EXPECT_EQ(c20, clone.nearestIsland(2, 1, Direction::UP));
+    EXPECT_EQ(1, c00->isConnected(c20));
+    clone.connect(c20, c22, false);
+    EXPECT_TRUE(clone.isSolved());
+    EXPECT_FALSE(original.isSolved());
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, hash) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+  auto i02 = game.getIsland(0, 2);
+  auto i22 = game.getIsland(2, 2);
+  EXPECT_EQ(0, game.hash());
+  EXPECT_EQ(16, game._zobristKeys.size());
+
+  auto bridge1 = game.connect(i00, i20, false);
+  uint64_t single = game.hash();
+  EXPECT_NE(0, single);
+  auto bridge2 = game.connect(i02, i22, false);
+  uint64_t both = game.hash();
+  EXPECT_NE(single, both);
+
+  // Upgrading a bridge changes the hash as well
+  Bridge* oldBridge = nullptr;
+  auto bridge3 = game.connect(i20, i00, false, &oldBridge);
+  EXPECT_NE(both, game.hash());
+  game.replace(bridge3, oldBridge);
+  EXPECT_EQ(both, game.hash());
+
+  game.disconnect(bridge1);
+  game.disconnect(bridge2);
+  EXPECT_EQ(0, game.hash());
+  game.recycle(bridge1);
+  game.recycle(bridge2);
+  game.recycle(bridge3);
+
+  // The order of the connections doesn't matter
+  auto bridge4 = game.connect(i22, i02, false);
+  game.connect(i20, i00, false);
+  EXPECT_EQ(both, game.hash());
+
+  // Neither does the Game instance
+  Game copy = game.clone();
+  EXPECT_EQ(both, copy.hash());
+  auto snapshot = game.snapshot();
+  game.disconnect(bridge4);
+  EXPECT_EQ(single, game.hash());
+  game.restore(snapshot);
+  EXPECT_EQ(both, game.hash());
+  game.recycle(bridge4);
+
+  // Games with the same Islands use the same keys
+  Game other({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  other.connect(other.getIsland(0, 0), other.getIsland(2, 0), false);
+  EXPECT_EQ(single, other.hash());
+
+  // Different multiplicities and slots give different keys
+  std::vector<uint64_t> keys(game._zobristKeys);
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys.end(), std::unique(keys.begin(), keys.end()));
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, edgeIslands) {
+  Game game({
+    Island(0, 0, 1),
+    Island(4, 0, 2),
+    Island(0, 3, 1),
+    Island(4, 3, 2)
+  });
+  auto topLeft = game.getIsland(0, 0);
+  auto topRight = game.getIsland(4, 0);
+  auto bottomLeft = game.getIsland(0, 3);
+  EXPECT_EQ(8, game.edgeCount());
+
+  uint32_t horizontal = Game::edgeId(topLeft, topRight);
+  uint32_t vertical = Game::edgeId(bottomLeft, topLeft);
+  EXPECT_EQ(horizontal, Game::edgeId(topRight, topLeft));
+  EXPECT_NE(horizontal, vertical);
+  EXPECT_EQ(std::make_pair(topLeft, topRight), game.edgeIslands(horizontal));
+  EXPECT_EQ(std::make_pair(topLeft, bottomLeft), game.edgeIslands(vertical));
+  // There is nothing right of the upper right Island
+  auto none = game.edgeIslands(topRight->index() * 2);
+  EXPECT_EQ(topRight, none.first);
+  EXPECT_EQ(nullptr, none.second);
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, gaps) {
+  Game game({
+    Island(2, 0, 2),
+    Island(0, 2, 1),
+    Island(4, 2, 1),
+    Island(2, 4, 2)
+  });
+  auto top = game.getIsland(2, 0);
+  auto left = game.getIsland(0, 2);
+  auto right = game.getIsland(4, 2);
+  auto bottom = game.getIsland(2, 4);
+  uint32_t vertical = Game::edgeId(top, bottom);
+  uint32_t horizontal = Game::edgeId(left, right);
+  EXPECT_EQ(vertical, game.neighbourGap(*top, Direction::DOWN));
+  EXPECT_EQ(vertical, game.neighbourGap(*bottom, Direction::UP));
+  EXPECT_EQ(horizontal, game.neighbourGap(*right, Direction::LEFT));
+  EXPECT_EQ(UINT32_MAX, game.neighbourGap(*top, Direction::UP));
+
+  // Without bridges nothing crosses
+  std::vector<uint32_t> crossing;
+  game.crossingGaps(horizontal, &crossing);
+  EXPECT_TRUE(crossing.empty());
+  // But the gaps are across each other
+  game.acrossGaps(horizontal, &crossing);
+  EXPECT_EQ(std::vector<uint32_t>({ vertical }), crossing);
+  crossing.clear();
+  game.acrossGaps(vertical, &crossing);
+  EXPECT_EQ(std::vector<uint32_t>({ horizontal }), crossing);
+  crossing.clear();
+
+  Bridge* bridge = game.connect(top, bottom, true);
+  EXPECT_EQ(vertical, Game::edgeId(bridge));
+  EXPECT_EQ(2, Game::multiplicity(bridge));
+  EXPECT_EQ(2, top->multiplicity(Direction::DOWN));
+  EXPECT_EQ(0, top->multiplicity(Direction::UP));
+  EXPECT_EQ(2, bottom->multiplicity(Direction::UP));
+  game.crossingGaps(horizontal, &crossing);
+  EXPECT_EQ(std::vector<uint32_t>({ vertical }), crossing);
+  crossing.clear();
+  game.crossingGaps(vertical, &crossing);
+  EXPECT_TRUE(crossing.empty());
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, nearestIsland) {
+  std::mt19937 random(4321);
+  std::bernoulli_distribution hasIsland(0.2);
+  std::vector<Island> islands;
+  for (uint32_t y = 0; y < 15; y++) {
+    for (uint32_t x = 0; x < 10; x++) {
+      if (hasIsland(random)) {
+        islands.push_back(Island(x, y, 8));
+      }
+    }
+  }
+  Game game(islands);
+  for (uint32_t y = 0; y < game._height; y++) {
+    for (uint32_t x = 0; x < game._width; x++) {
+      for (const Direction* dir : Direction::ALL) {
+        // Walk cell by cell until an Island or the border is reached
+        Island* expected = nullptr;
+        uint32_t cx = x + dir->_xchange;
+        uint32_t cy = y + dir->_ychange;
+        while (cx < game._width && cy < game._height && expected == nullptr) {
+          expected = game.getIsland(cx, cy);
+          cx += dir->_xchange;
+          cy += dir->_ychange;
+        }
+        EXPECT_EQ(expected, game.nearestIsland(x, y, *dir));
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(GameTest, findAffectedIslands) {
+  Game game({
+    Island(2, 0, 1),
+    Island(0, 2, 2),
+    Island(4, 2, 1),
+    Island(2, 4, 1),
+    Island(0, 5, 1),
+    Island(6, 6, 1)
+  });
+  auto top = game.getIsland(2, 0);
+  auto left = game.getIsland(0, 2);
+  auto right = game.getIsland(4, 2);
+  auto bottom = game.getIsland(2, 4);
+  auto belowLeft = game.getIsland(0, 5);
+
+  Bridge* bridge = game.connect(left, right, false);
+  std::vector<Island*> result;
+  game.findAffectedIslands(bridge, &result);
+  std::sort(result.begin(), result.end());
+  result.erase(std::unique(result.begin(), result.end()), result.end());
+
+  // The Islands of the bridge, the Island below the left one and both
+  // Islands of the vertical gap the bridge crosses
+  std::vector<Island*> expected = { top, left, right, bottom, belowLeft };
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, result);
 }
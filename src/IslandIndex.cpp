@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include "./IslandIndex.h"
+#include "./Game.h"
+
+// _____________________________________________________________________________
+
+IslandIndex::IslandIndex(const std::vector<Island*> &islands, size_t width,
+  size_t height, Layout layout):
+  _width(width), _height(height), _layout(layout), _mask(0), _shift(63) {
+  if (_layout == Layout::AUTO) {
+    _layout = chooseLayout(islands.size(), _width, _height);
+  }
+  if (_layout == Layout::DENSE) {
+    _cells.assign(_width * _height, nullptr);
+  } else {
+    // Keep the load factor at or below 25% so probe sequences for
+    // the (far more common) misses stay short
+    size_t capacity = 2;
+    _shift = 63;
+    while (capacity < islands.size() * 4) {
+      capacity <<= 1;
+      _shift--;
+    }
+    _slots.assign(capacity, Slot{0, nullptr});
+    _mask = capacity - 1;
+  }
+  _islands.reserve(islands.size());
+  for (const auto &island : islands) {
+    if (island->_x >= _width || island->_y >= _height) {
+      continue;
+    }
+    Island* previous = insert(island);
+    if (previous == nullptr) {
+      _islands.push_back(island);
+    } else {
+      std::replace(_islands.begin(), _islands.end(), previous, island);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+IslandIndex::IslandIndex(const IslandIndex &other, const Island* from,
+  Island* to):
+  _width(other._width), _height(other._height), _layout(other._layout),
+  _islands(other._islands), _cells(other._cells), _slots(other._slots),
+  _mask(other._mask), _shift(other._shift) {
+  for (auto &island : _islands) {
+    island = to + (island - from);
+  }
+  for (auto &island : _cells) {
+    if (island != nullptr) {
+      island = to + (island - from);
+    }
+  }
+  for (auto &slot : _slots) {
+    if (slot.island != nullptr) {
+      slot.island = to + (slot.island - from);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+IslandIndex::Layout IslandIndex::chooseLayout(size_t islandCount, size_t width,
+  size_t height) {
+  uint64_t cells = static_cast<uint64_t>(width) * height;
+  if (cells <= DENSE_CELLS_PER_ISLAND * islandCount) {
+    return Layout::DENSE;
+  }
+  return Layout::SPARSE;
+}
+
+// _____________________________________________________________________________
+
+uint64_t IslandIndex::hash(uint64_t key) const {
+  // Fibonacci hashing, only the high bits of the product are well mixed
+  return (key * 0x9E3779B97F4A7C15ull) >> _shift;
+}
+
+// _____________________________________________________________________________
+
+Island* IslandIndex::insert(Island* island) {
+  uint64_t key = island->_x + static_cast<uint64_t>(island->_y) * _width;
+  if (_layout == Layout::DENSE) {
+    Island* previous = _cells[key];
+    _cells[key] = island;
+    return previous;
+  }
+  for (uint64_t i = hash(key); ; i = (i + 1) & _mask) {
+    Slot &slot = _slots[i];
+    if (slot.island == nullptr) {
+      slot.key = key;
+      slot.island = island;
+      return nullptr;
+    }
+    if (slot.key == key) {
+      Island* previous = slot.island;
+      slot.island = island;
+      return previous;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+Island* IslandIndex::find(uint32_t x, uint32_t y) const {
+  if (x >= _width || y >= _height) {
+    return nullptr;
+  }
+  uint64_t key = x + static_cast<uint64_t>(y) * _width;
+  if (_layout == Layout::DENSE) {
+    return _cells[key];
+  }
+  // The table is never full, so we always hit a free slot eventually
+  for (uint64_t i = hash(key); ; i = (i + 1) & _mask) {
+    const Slot &slot = _slots[i];
+    if (slot.island == nullptr || slot.key == key) {
+      return slot.island;
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+IslandIndex::Layout IslandIndex::layout() const {
+  return _layout;
+}
+
+// _____________________________________________________________________________
+
+const std::vector<Island*>& IslandIndex::islands() const {
+  return _islands;
+}
@@ -0,0 +1,90 @@
+#ifndef ISLANDINDEX_H_
+#define ISLANDINDEX_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// _____________________________________________________________________________
+
+class Island;
+
+// _____________________________________________________________________________
+
+// Flat spatial index mapping x-y coordinates to the Islands of a Game.
+// The index is built once and never changes afterwards.
+// Boards where Islands fill a reasonable fraction of the grid use a dense
+// array with one pointer per cell, so a lookup is a single load.
+// Sparse boards would waste a lot of memory on empty cells, so they use
+// an open-addressing hash table with linear probing instead
+class IslandIndex {
+  FRIEND_TEST(IslandIndexTest, constructor);
+  FRIEND_TEST(IslandIndexTest, chooseLayout);
+  FRIEND_TEST(IslandIndexTest, sparseCollisions);
+
+ public:
+  // The two storage strategies, AUTO picks one based on the fill ratio
+  enum class Layout { AUTO, DENSE, SPARSE };
+
+  // Boards with at most this many cells per Island are stored densely
+  static const uint64_t DENSE_CELLS_PER_ISLAND = 64;
+
+  // Builds the index for the given Islands on a width x height grid.
+  // Islands outside of the grid are ignored, if multiple Islands share
+  // the same coordinates, only the last one is indexed.
+  // The Islands are not owned by the index
+  IslandIndex(const std::vector<Island*>&, size_t, size_t,
+    Layout = Layout::AUTO);
+
+  // Copies the given index for a copy of the Islands it refers to:
+  // every Island is moved from its position in the array at the first
+  // pointer to the same position in the array at the second pointer
+  IslandIndex(const IslandIndex&, const Island*, Island*);
+
+  // Returns the Island at the given coordinates or nullptr if there is none
+  Island* find(uint32_t, uint32_t) const;
+
+  // Returns the layout that has been chosen for this index
+  Layout layout() const;
+
+  // All indexed Islands in a contiguous vector
+  const std::vector<Island*>& islands() const;
+
+  // Returns the layout AUTO would choose for the given amount of Islands
+  // on a grid with the given dimensions
+  static Layout chooseLayout(size_t, size_t, size_t);
+
+ private:
+  // Entry of the open-addressing table, a nullptr island marks a free slot
+  struct Slot {
+    uint64_t key;
+    Island* island;
+  };
+
+  // width of the indexed grid
+  size_t _width;
+  // height of the indexed grid
+  size_t _height;
+  // the layout that is actually being used
+  Layout _layout;
+  // all islands in the index, used for iteration
+  std::vector<Island*> _islands;
+  // one entry per cell in row-major order, only used by the DENSE layout
+  std::vector<Island*> _cells;
+  // power of 2 sized hash table, only used by the SPARSE layout
+  std::vector<Slot> _slots;
+  // _slots.size() - 1, so a probe position can wrap with a single and
+  uint64_t _mask;
+  // 64 - log2(_slots.size()), turns a product into a slot position
+  uint32_t _shift;
+
+  // Hashes a cell key to a slot position for the SPARSE layout
+  uint64_t hash(uint64_t) const;
+
+  // Adds an Island to the storage of the chosen layout, returns the
+  // Island that previously occupied the same cell or nullptr
+  Island* insert(Island*);
+};
+
+#endif  // ISLANDINDEX_H_
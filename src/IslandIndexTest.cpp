@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "./IslandIndex.h"
+#include "./Game.h"
+
+// _____________________________________________________________________________
+
+// Helper function that creates the islands of a checkerboard-like grid
+std::vector<std::unique_ptr<Island>> createIslands(uint32_t width,
+  uint32_t height, uint32_t step) {
+  std::vector<std::unique_ptr<Island>> islands;
+  for (uint32_t y = 0; y < height; y += step) {
+    for (uint32_t x = 0; x < width; x += step) {
+      islands.push_back(std::unique_ptr<Island>(new Island(x, y, 1)));
+    }
+  }
+  return islands;
+}
+
+// _____________________________________________________________________________
+
+std::vector<Island*> toPointers(
+  const std::vector<std::unique_ptr<Island>> &islands) {
+  std::vector<Island*> result;
+  for (const auto &island : islands) {
+    result.push_back(island.get());
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+
+TEST(IslandIndexTest, constructor) {
+  auto islands = createIslands(10, 10, 2);
+  IslandIndex dense(toPointers(islands), 10, 10, IslandIndex::Layout::DENSE);
+  IslandIndex sparse(toPointers(islands), 10, 10, IslandIndex::Layout::SPARSE);
+
+  EXPECT_EQ(IslandIndex::Layout::DENSE, dense.layout());
+  EXPECT_EQ(100, dense._cells.size());
+  EXPECT_EQ(0, dense._slots.size());
+
+  EXPECT_EQ(IslandIndex::Layout::SPARSE, sparse.layout());
+  EXPECT_EQ(0, sparse._cells.size());
+  // 25 islands with a load factor of at most 25%
+  EXPECT_EQ(128, sparse._slots.size());
+  EXPECT_EQ(127, sparse._mask);
+  EXPECT_EQ(57, sparse._shift);
+
+  ASSERT_EQ(25, dense.islands().size());
+  ASSERT_EQ(25, sparse.islands().size());
+  for (size_t i = 0; i < islands.size(); i++) {
+    EXPECT_EQ(islands[i].get(), dense.islands()[i]);
+    EXPECT_EQ(islands[i].get(), sparse.islands()[i]);
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(IslandIndexTest, chooseLayout) {
+  EXPECT_EQ(IslandIndex::Layout::DENSE, IslandIndex::chooseLayout(25, 10, 10));
+  EXPECT_EQ(IslandIndex::Layout::DENSE, IslandIndex::chooseLayout(1, 8, 8));
+  EXPECT_EQ(IslandIndex::Layout::SPARSE, IslandIndex::chooseLayout(1, 9, 8));
+  EXPECT_EQ(IslandIndex::Layout::SPARSE,
+    IslandIndex::chooseLayout(5, 124, 457));
+  EXPECT_EQ(IslandIndex::Layout::SPARSE, IslandIndex::chooseLayout(0, 1, 1));
+
+  auto islands = createIslands(10, 10, 2);
+  IslandIndex automatic(toPointers(islands), 10, 10);
+  EXPECT_EQ(IslandIndex::Layout::DENSE, automatic.layout());
+
+  auto sparseIslands = createIslands(100, 100, 10);
+  IslandIndex automaticSparse(toPointers(sparseIslands), 100, 100);
+  EXPECT_EQ(IslandIndex::Layout::SPARSE, automaticSparse.layout());
+}
+
+// _____________________________________________________________________________
+
+TEST(IslandIndexTest, find) {
+  auto islands = createIslands(30, 20, 3);
+  for (auto layout : { IslandIndex::Layout::DENSE,
+    IslandIndex::Layout::SPARSE }) {
+    IslandIndex index(toPointers(islands), 30, 20, layout);
+    for (uint32_t x = 0; x < 30; x++) {
+      for (uint32_t y = 0; y < 20; y++) {
+        Island* island = index.find(x, y);
+        if (x % 3 == 0 && y % 3 == 0) {
+          ASSERT_NE(nullptr, island);
+          EXPECT_EQ(x, island->_x);
+          EXPECT_EQ(y, island->_y);
+        } else {
+          EXPECT_EQ(nullptr, island);
+        }
+      }
+    }
+    // Out of bounds and underflowing coordinates
+    EXPECT_EQ(nullptr, index.find(30, 0));
+    EXPECT_EQ(nullptr, index.find(0, 20));
+    EXPECT_EQ(nullptr, index.find(-1, 0));
+    EXPECT_EQ(nullptr, index.find(0, -1));
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(IslandIndexTest, sparseCollisions) {
+  // All keys are multiples of the table size
+  // so the probing sequence gets exercised
+  std::vector<std::unique_ptr<Island>> islands;
+  for (uint32_t x = 0; x < 8; x++) {
+    islands.push_back(std::unique_ptr<Island>(new Island(x * 16, 0, 1)));
+  }
+  IslandIndex index(toPointers(islands), 128, 1, IslandIndex::Layout::SPARSE);
+  size_t used = 0;
+  for (const auto &slot : index._slots) {
+    if (slot.island != nullptr) {
+      used++;
+    }
+  }
+  EXPECT_EQ(8, used);
+  for (const auto &island : islands) {
+    EXPECT_EQ(island.get(), index.find(island->_x, island->_y));
+  }
+  EXPECT_EQ(nullptr, index.find(8, 0));
+}
+
+// _____________________________________________________________________________
+
+TEST(IslandIndexTest, duplicates) {
+  std::unique_ptr<Island> first(new Island(1, 1, 1));
+  std::unique_ptr<Island> second(new Island(1, 1, 2));
+  std::unique_ptr<Island> other(new Island(0, 0, 3));
+  for (auto layout : { IslandIndex::Layout::DENSE,
+    IslandIndex::Layout::SPARSE }) {
+    IslandIndex index({ first.get(), other.get(), second.get() }, 2, 2,
+      layout);
+    ASSERT_EQ(2, index.islands().size());
+    EXPECT_EQ(second.get(), index.islands()[0]);
+    EXPECT_EQ(other.get(), index.islands()[1]);
+    EXPECT_EQ(second.get(), index.find(1, 1));
+    EXPECT_EQ(other.get(), index.find(0, 0));
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(IslandIndexTest, rebase) {
+  std::vector<Island> original = {
+    Island(0, 0, 1), Island(4, 0, 2), Island(0, 4, 3)
+  };
+  std::vector<Island> copy = original;
+  std::vector<Island*> pointers;
+  for (auto &island : original) {
+    pointers.push_back(&island);
+  }
+  for (auto layout : { IslandIndex::Layout::DENSE,
+    IslandIndex::Layout::SPARSE }) {
+    IslandIndex index(pointers, 5, 5, layout);
+    IslandIndex rebased(index, original.data(), copy.data());
+    EXPECT_EQ(layout, rebased.layout());
+    ASSERT_EQ(3, rebased.islands().size());
+    for (size_t i = 0; i < copy.size(); i++) {
+      EXPECT_EQ(&copy[i], rebased.islands()[i]);
+      EXPECT_EQ(&copy[i], rebased.find(copy[i]._x, copy[i]._y));
+      // The original index is left untouched
+      EXPECT_EQ(&original[i], index.find(copy[i]._x, copy[i]._y));
+    }
+    EXPECT_EQ(nullptr, rebased.find(4, 4));
+  }
+}
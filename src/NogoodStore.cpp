@@ -0,0 +1,168 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "./NogoodStore.h"
+
+const size_t NogoodStore::MAX_LENGTH;
+
+// _____________________________________________________________________________
+
+NogoodStore::NogoodStore(size_t edges, size_t budget): _budget(budget),
+  _watching(edges) {}
+
+// _____________________________________________________________________________
+
+size_t NogoodStore::cost(size_t length) {
+  return sizeof(Nogood) + length * (sizeof(Literal) + sizeof(uint32_t));
+}
+
+// _____________________________________________________________________________
+
+bool NogoodStore::add(const std::vector<Literal> &literals) {
+  if (literals.empty() || literals.size() > MAX_LENGTH
+    || cost(literals.size()) > _budget) {
+    return false;
+  }
+  std::vector<Literal> merged;
+  for (const auto &literal : literals) {
+    auto same = std::find_if(merged.begin(), merged.end(),
+      [&literal](const Literal &other) { return other.edge == literal.edge; });
+    if (same == merged.end()) {
+      merged.push_back(literal);
+    } else {
+      same->bridges = std::max(same->bridges, literal.bridges);
+    }
+  }
+  while (_memory + cost(merged.size()) > _budget) {
+    reduce();
+  }
+  _memory += cost(merged.size());
+  _nogoods.push_back({ std::move(merged), 0 });
+  watch(_nogoods.size() - 1);
+  return true;
+}
+
+// _____________________________________________________________________________
+
+void NogoodStore::watch(uint32_t id) {
+  const auto &literals = _nogoods[id].literals;
+  _watching[literals[0].edge].push_back(id);
+  if (literals.size() > 1) {
+    _watching[literals[1].edge].push_back(id);
+  }
+}
+
+// _____________________________________________________________________________
+
+void NogoodStore::update(uint32_t edge, const Counter &bridges,
+  std::vector<uint32_t>* candidates) {
+  auto &list = _watching[edge];
+  size_t kept = 0;
+  for (size_t i = 0; i < list.size(); i++) {
+    uint32_t id = list[i];
+    auto &literals = _nogoods[id].literals;
+    // The literal on this gap comes first
+    if (literals[0].edge != edge) {
+      std::swap(literals[0], literals[1]);
+    }
+    if (bridges(edge) < literals[0].bridges) {
+      // Still watched, but the other one may have been stuck
+      list[kept++] = id;
+      if (literals.size() == 1 || bridges(literals[1].edge)
+        >= literals[1].bridges) {
+        candidates->push_back(id);
+      }
+      continue;
+    }
+    size_t other = 2;
+    while (other < literals.size()
+      && bridges(literals[other].edge) >= literals[other].bridges) {
+      other++;
+    }
+    if (other < literals.size()) {
+      std::swap(literals[0], literals[other]);
+      _watching[literals[0].edge].push_back(id);
+      continue;
+    }
+    list[kept++] = id;
+    candidates->push_back(id);
+  }
+  list.resize(kept);
+}
+
+// _____________________________________________________________________________
+
+void NogoodStore::reduce() {
+  // Stable, so the older one of two with the same hits comes first
+  std::vector<uint32_t> order(_nogoods.size());
+  for (uint32_t i = 0; i < order.size(); i++) {
+    order[i] = i;
+  }
+  std::stable_sort(order.begin(), order.end(),
+    [this](uint32_t one, uint32_t two) {
+      return _nogoods[one].hits < _nogoods[two].hits;
+    });
+  std::vector<bool> keep(_nogoods.size(), true);
+  for (size_t i = 0; i < order.size() / 2 + 1 && i < order.size(); i++) {
+    keep[order[i]] = false;
+  }
+
+  std::vector<Nogood> kept;
+  _memory = 0;
+  for (auto &list : _watching) {
+    list.clear();
+  }
+  for (uint32_t i = 0; i < _nogoods.size(); i++) {
+    if (!keep[i]) {
+      _dropped++;
+      continue;
+    }
+    _memory += cost(_nogoods[i].literals.size());
+    kept.push_back(std::move(_nogoods[i]));
+  }
+  _nogoods.swap(kept);
+  for (uint32_t id = 0; id < _nogoods.size(); id++) {
+    watch(id);
+  }
+}
+
+// _____________________________________________________________________________
+
+const std::vector<NogoodStore::Literal>& NogoodStore::operator[](uint32_t id)
+  const {
+  return _nogoods[id].literals;
+}
+
+// _____________________________________________________________________________
+
+void NogoodStore::touch(uint32_t id) {
+  _nogoods[id].hits++;
+}
+
+// _____________________________________________________________________________
+
+size_t NogoodStore::size() const {
+  return _nogoods.size();
+}
+
+// _____________________________________________________________________________
+
+size_t NogoodStore::memory() const {
+  return _memory;
+}
+
+// _____________________________________________________________________________
+
+uint64_t NogoodStore::dropped() const {
+  return _dropped;
+}
+
+// _____________________________________________________________________________
+
+void NogoodStore::clear() {
+  _nogoods.clear();
+  for (auto &list : _watching) {
+    list.clear();
+  }
+  _memory = 0;
+}
@@ -0,0 +1,105 @@
+#ifndef NOGOODSTORE_H_
+#define NOGOODSTORE_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// Nogoods learned by the search, i.e. combinations of bridges that are
+// part of no solution. Every nogood is a list of literals, a literal
+// holds if its gap carries at least its amount of bridges. The store is
+// indexed by gap, so the nogoods a new bridge may complete are found
+// without looking at the others. The memory of the nogoods is bounded:
+// once they need more than the budget, the half that has been used the
+// least is dropped. Like the clauses of a SAT solver, every nogood
+// watches two literals that don't hold, so a new bridge only visits the
+// nogoods watching its gap
+class NogoodStore {
+  FRIEND_TEST(NogoodStoreTest, constructor);
+  FRIEND_TEST(NogoodStoreTest, update);
+  FRIEND_TEST(NogoodStoreTest, reduce);
+
+ public:
+  // At least the given amount of bridges in the gap with the given id
+  struct Literal {
+    uint32_t edge;
+    int8_t bridges;
+  };
+
+  // Returns the amount of bridges in the gap with the given id
+  typedef std::function<int8_t(uint32_t)> Counter;
+
+  // The longest nogood that is stored, longer ones hardly ever prune
+  static const size_t MAX_LENGTH = 32;
+
+  // Creates an empty store for the gap ids 0 to n - 1 whose nogoods may
+  // occupy the given amount of bytes, 0 stores nothing
+  NogoodStore(size_t, size_t);
+
+  // Adds the nogood, returns false if it's empty, longer than
+  // MAX_LENGTH or doesn't fit into the budget at all. Literals on the
+  // same gap are merged, the first two gaps are watched. The ids of all
+  // nogoods change if the store had to drop some of them
+  bool add(const std::vector<Literal>&);
+
+  // Has to be called after the gap with the given id got a bridge. Moves
+  // the watches of the nogoods whose literal on that gap holds now and
+  // appends the ids of the nogoods that can't find a literal to watch
+  // instead, i.e. those with at most one literal that doesn't hold
+  void update(uint32_t, const Counter&, std::vector<uint32_t>*);
+
+  // Returns the literals of the nogood with the given id
+  const std::vector<Literal>& operator[](uint32_t) const;
+
+  // Marks the nogood with the given id as useful, nogoods that are used
+  // more often survive dropping
+  void touch(uint32_t);
+
+  // Returns the amount of stored nogoods
+  size_t size() const;
+
+  // Returns how many bytes the stored nogoods occupy
+  size_t memory() const;
+
+  // Returns the amount of nogoods dropped to stay within the budget
+  uint64_t dropped() const;
+
+  // Removes all nogoods, the budget is kept
+  void clear();
+
+ private:
+  // A stored nogood and how often it has been useful
+  struct Nogood {
+    std::vector<Literal> literals;
+    uint64_t hits;
+  };
+
+  // the maximum of memory()
+  size_t _budget;
+  // the stored nogoods, the oldest first
+  std::vector<Nogood> _nogoods;
+  // the ids of the nogoods watching a literal on every gap
+  std::vector<std::vector<uint32_t>> _watching;
+  // the sum of the sizes of all nogoods
+  size_t _memory = 0;
+  // amount of nogoods dropped so far
+  uint64_t _dropped = 0;
+
+  // Returns how many bytes a nogood with the given amount of literals
+  // occupies, including its entries in _watching
+  static size_t cost(size_t);
+
+  // Adds the nogood with the given id to the watch lists of its first
+  // two literals
+  void watch(uint32_t);
+
+  // Drops the half of the nogoods with the fewest hits, the older one
+  // of two with the same hits first, and rebuilds _watching
+  void reduce();
+};
+
+#endif  // NOGOODSTORE_H_
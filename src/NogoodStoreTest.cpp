@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "./NogoodStore.h"
+
+// _____________________________________________________________________________
+
+TEST(NogoodStoreTest, constructor) {
+  NogoodStore store(4, 1000);
+  EXPECT_EQ(4, store._watching.size());
+  EXPECT_EQ(0, store.size());
+  EXPECT_EQ(0, store.memory());
+
+  EXPECT_FALSE(store.add({}));
+  std::vector<NogoodStore::Literal> tooLong(NogoodStore::MAX_LENGTH + 1,
+    { 0, 1 });
+  EXPECT_FALSE(store.add(tooLong));
+  NogoodStore tiny(4, NogoodStore::cost(1) - 1);
+  EXPECT_FALSE(tiny.add({ { 0, 1 } }));
+
+  // Literals on the same gap are merged
+  EXPECT_TRUE(store.add({ { 0, 1 }, { 2, 2 }, { 0, 2 } }));
+  ASSERT_EQ(1, store.size());
+  ASSERT_EQ(2, store[0].size());
+  EXPECT_EQ(0, store[0][0].edge);
+  EXPECT_EQ(2, store[0][0].bridges);
+  EXPECT_EQ(2, store[0][1].edge);
+  EXPECT_EQ(NogoodStore::cost(2), store.memory());
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), store._watching[0]);
+  EXPECT_TRUE(store._watching[1].empty());
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), store._watching[2]);
+
+  store.clear();
+  EXPECT_EQ(0, store.size());
+  EXPECT_EQ(0, store.memory());
+  EXPECT_TRUE(store._watching[0].empty());
+}
+
+// _____________________________________________________________________________
+
+TEST(NogoodStoreTest, update) {
+  std::vector<int8_t> bridges(3, 0);
+  NogoodStore::Counter counter = [&bridges](uint32_t edge) {
+    return bridges[edge];
+  };
+  NogoodStore store(3, 1000);
+  ASSERT_TRUE(store.add({ { 0, 1 }, { 1, 1 }, { 2, 2 } }));
+  std::vector<uint32_t> candidates;
+
+  // The watch moves on to the last literal
+  bridges[0] = 1;
+  store.update(0, counter, &candidates);
+  EXPECT_TRUE(candidates.empty());
+  EXPECT_TRUE(store._watching[0].empty());
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), store._watching[2]);
+
+  // Only the last literal doesn't hold, so there is nothing to watch
+  bridges[1] = 1;
+  store.update(1, counter, &candidates);
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), candidates);
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), store._watching[1]);
+
+  // A single bridge doesn't complete the last literal, but the nogood
+  // stays a candidate
+  candidates.clear();
+  bridges[2] = 1;
+  store.update(2, counter, &candidates);
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), candidates);
+
+  // Undoing bridges keeps the watches valid
+  bridges.assign(3, 0);
+  candidates.clear();
+  bridges[2] = 2;
+  store.update(2, counter, &candidates);
+  EXPECT_TRUE(candidates.empty());
+  EXPECT_TRUE(store._watching[2].empty());
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), store._watching[0]);
+}
+
+// _____________________________________________________________________________
+
+TEST(NogoodStoreTest, reduce) {
+  NogoodStore store(5, 4 * NogoodStore::cost(1));
+  for (uint32_t edge = 0; edge < 4; edge++) {
+    ASSERT_TRUE(store.add({ { edge, 1 } }));
+  }
+  store.touch(1);
+  store.touch(3);
+  EXPECT_EQ(0, store.dropped());
+
+  // The oldest 3 of the least useful ones make room
+  ASSERT_TRUE(store.add({ { 4, 1 } }));
+  EXPECT_EQ(3, store.dropped());
+  ASSERT_EQ(2, store.size());
+  EXPECT_EQ(3, store[0][0].edge);
+  EXPECT_EQ(4, store[1][0].edge);
+  EXPECT_EQ(2 * NogoodStore::cost(1), store.memory());
+  for (uint32_t edge = 0; edge < 3; edge++) {
+    EXPECT_TRUE(store._watching[edge].empty());
+  }
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), store._watching[3]);
+  EXPECT_EQ(std::vector<uint32_t>({ 1 }), store._watching[4]);
+}
@@ -0,0 +1,110 @@
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include "./OccupationGrid.h"
+
+// _____________________________________________________________________________
+
+OccupationGrid::OccupationGrid(size_t width, size_t height):
+  _width(width), _height(height),
+  _rowWords((width + WORD_BITS - 1) / WORD_BITS),
+  _columnWords((height + WORD_BITS - 1) / WORD_BITS),
+  _rowMajor(_rowWords * height, 0),
+  _columnMajor(_columnWords * width, 0) {}
+
+// _____________________________________________________________________________
+
+void OccupationGrid::assign(std::vector<uint64_t>* bits, size_t from,
+  size_t to, bool value) {
+  while (from < to) {
+    size_t word = from / WORD_BITS;
+    size_t offset = from % WORD_BITS;
+    size_t count = std::min(WORD_BITS - offset, to - from);
+    uint64_t mask = count == WORD_BITS ? ~0ull
+      : ((1ull << count) - 1) << offset;
+    if (value) {
+      (*bits)[word] |= mask;
+    } else {
+      (*bits)[word] &= ~mask;
+    }
+    from += count;
+  }
+}
+
+// _____________________________________________________________________________
+
+void OccupationGrid::assignBit(std::vector<uint64_t>* bits, size_t position,
+  bool value) {
+  uint64_t mask = 1ull << (position % WORD_BITS);
+  if (value) {
+    (*bits)[position / WORD_BITS] |= mask;
+  } else {
+    (*bits)[position / WORD_BITS] &= ~mask;
+  }
+}
+
+// _____________________________________________________________________________
+
+size_t OccupationGrid::findSet(const std::vector<uint64_t> &bits,
+  size_t from, size_t to) {
+  if (from >= to) {
+    return to;
+  }
+  size_t word = from / WORD_BITS;
+  // Ignore the bits in front of the range in the first word
+  uint64_t current = bits[word] & (~0ull << (from % WORD_BITS));
+  while (current == 0) {
+    word++;
+    if (word * WORD_BITS >= to) {
+      return to;
+    }
+    current = bits[word];
+  }
+  size_t position = word * WORD_BITS + __builtin_ctzll(current);
+  return position < to ? position : to;
+}
+
+// _____________________________________________________________________________
+
+void OccupationGrid::assignRow(uint32_t y, uint32_t from, uint32_t to,
+  bool value) {
+  size_t row = y * _rowWords * WORD_BITS;
+  assign(&_rowMajor, row + from, row + to, value);
+  // The other orientation has one bit per column in different words
+  for (uint32_t x = from; x < to; x++) {
+    assignBit(&_columnMajor, x * _columnWords * WORD_BITS + y, value);
+  }
+}
+
+// _____________________________________________________________________________
+
+void OccupationGrid::assignColumn(uint32_t x, uint32_t from, uint32_t to,
+  bool value) {
+  size_t column = x * _columnWords * WORD_BITS;
+  assign(&_columnMajor, column + from, column + to, value);
+  for (uint32_t y = from; y < to; y++) {
+    assignBit(&_rowMajor, y * _rowWords * WORD_BITS + x, value);
+  }
+}
+
+// _____________________________________________________________________________
+
+bool OccupationGrid::get(uint32_t x, uint32_t y) const {
+  size_t position = y * _rowWords * WORD_BITS + x;
+  return (_rowMajor[position / WORD_BITS] >> (position % WORD_BITS)) & 1;
+}
+
+// _____________________________________________________________________________
+
+bool OccupationGrid::isRowClear(uint32_t y, uint32_t from, uint32_t to) const {
+  size_t row = y * _rowWords * WORD_BITS;
+  return findSet(_rowMajor, row + from, row + to) == row + to;
+}
+
+// _____________________________________________________________________________
+
+bool OccupationGrid::isColumnClear(uint32_t x, uint32_t from,
+  uint32_t to) const {
+  size_t column = x * _columnWords * WORD_BITS;
+  return findSet(_columnMajor, column + from, column + to) == column + to;
+}
@@ -0,0 +1,74 @@
+#ifndef OCCUPATIONGRID_H_
+#define OCCUPATIONGRID_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// Bit-packed grid that stores which cells are covered by a bridge.
+// Every cell is stored twice, once in row-major and once in column-major
+// order, so a run of cells along a row or a column is always a run of
+// consecutive bits. Every row and column starts at a word boundary, so
+// setting or scanning a run only touches the words it covers
+class OccupationGrid {
+  FRIEND_TEST(OccupationGridTest, constructor);
+  FRIEND_TEST(OccupationGridTest, findSet);
+
+ public:
+  // Creates an empty grid with the given width and height
+  OccupationGrid(size_t, size_t);
+
+  // Marks (true) or clears (false) the cells of the row at the given
+  // y coordinate (1st parameter) from the 2nd up to, but excluding,
+  // the 3rd x coordinate
+  void assignRow(uint32_t, uint32_t, uint32_t, bool);
+
+  // Marks (true) or clears (false) the cells of the column at the given
+  // x coordinate (1st parameter) from the 2nd up to, but excluding,
+  // the 3rd y coordinate
+  void assignColumn(uint32_t, uint32_t, uint32_t, bool);
+
+  // Returns true if the cell at the given x-y coordinates is occupied
+  bool get(uint32_t, uint32_t) const;
+
+  // Returns true if no cell of the row at the given y coordinate
+  // from the 2nd up to, but excluding, the 3rd x coordinate is occupied
+  bool isRowClear(uint32_t, uint32_t, uint32_t) const;
+
+  // Returns true if no cell of the column at the given x coordinate
+  // from the 2nd up to, but excluding, the 3rd y coordinate is occupied
+  bool isColumnClear(uint32_t, uint32_t, uint32_t) const;
+
+ private:
+  // amount of bits per word
+  static const size_t WORD_BITS = 64;
+
+  // width of the grid
+  size_t _width;
+  // height of the grid
+  size_t _height;
+  // words per row of the row-major bits
+  size_t _rowWords;
+  // words per column of the column-major bits
+  size_t _columnWords;
+  // one bit per cell, row after row
+  std::vector<uint64_t> _rowMajor;
+  // one bit per cell, column after column
+  std::vector<uint64_t> _columnMajor;
+
+  // Sets or clears the bits from the 2nd up to, but excluding, the 3rd
+  // position with one masked write per touched word
+  static void assign(std::vector<uint64_t>*, size_t, size_t, bool);
+
+  // Sets or clears the single bit at the given position
+  static void assignBit(std::vector<uint64_t>*, size_t, bool);
+
+  // Returns the position of the first set bit from the 2nd up to,
+  // but excluding, the 3rd position or the 3rd position if there is none
+  static size_t findSet(const std::vector<uint64_t>&, size_t, size_t);
+};
+
+#endif  // OCCUPATIONGRID_H_
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <random>
+#include "./OccupationGrid.h"
+
+// _____________________________________________________________________________
+
+TEST(OccupationGridTest, constructor) {
+  OccupationGrid grid(130, 3);
+  EXPECT_EQ(130, grid._width);
+  EXPECT_EQ(3, grid._height);
+  // Every row and column starts at a new word
+  EXPECT_EQ(3, grid._rowWords);
+  EXPECT_EQ(1, grid._columnWords);
+  EXPECT_EQ(9, grid._rowMajor.size());
+  EXPECT_EQ(130, grid._columnMajor.size());
+  for (uint32_t x = 0; x < 130; x++) {
+    for (uint32_t y = 0; y < 3; y++) {
+      ASSERT_FALSE(grid.get(x, y));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(OccupationGridTest, findSet) {
+  std::vector<uint64_t> bits(3, 0);
+  EXPECT_EQ(192, OccupationGrid::findSet(bits, 0, 192));
+  EXPECT_EQ(5, OccupationGrid::findSet(bits, 5, 5));
+
+  OccupationGrid::assign(&bits, 60, 130, true);
+  EXPECT_EQ(~0ull << 60, bits[0]);
+  EXPECT_EQ(~0ull, bits[1]);
+  EXPECT_EQ(3, bits[2]);
+  EXPECT_EQ(60, OccupationGrid::findSet(bits, 0, 192));
+  EXPECT_EQ(60, OccupationGrid::findSet(bits, 0, 61));
+  EXPECT_EQ(60, OccupationGrid::findSet(bits, 0, 60));
+  EXPECT_EQ(100, OccupationGrid::findSet(bits, 100, 192));
+  EXPECT_EQ(192, OccupationGrid::findSet(bits, 130, 192));
+
+  OccupationGrid::assign(&bits, 61, 129, false);
+  EXPECT_EQ(1ull << 60, bits[0]);
+  EXPECT_EQ(0, bits[1]);
+  EXPECT_EQ(2, bits[2]);
+  EXPECT_EQ(129, OccupationGrid::findSet(bits, 61, 192));
+  EXPECT_EQ(129, OccupationGrid::findSet(bits, 61, 129));
+
+  OccupationGrid::assignBit(&bits, 64, true);
+  EXPECT_EQ(64, OccupationGrid::findSet(bits, 61, 192));
+  OccupationGrid::assignBit(&bits, 64, false);
+  EXPECT_EQ(129, OccupationGrid::findSet(bits, 61, 192));
+}
+
+// _____________________________________________________________________________
+
+TEST(OccupationGridTest, assignRow) {
+  OccupationGrid grid(100, 70);
+  grid.assignRow(3, 10, 90, true);
+  for (uint32_t x = 0; x < 100; x++) {
+    EXPECT_EQ(x >= 10 && x < 90, grid.get(x, 3));
+    EXPECT_FALSE(grid.get(x, 2));
+    EXPECT_FALSE(grid.get(x, 4));
+  }
+  EXPECT_TRUE(grid.isRowClear(3, 0, 10));
+  EXPECT_FALSE(grid.isRowClear(3, 0, 11));
+  EXPECT_TRUE(grid.isRowClear(3, 90, 100));
+  EXPECT_TRUE(grid.isRowClear(2, 0, 100));
+  // The column-major bits are kept in sync
+  EXPECT_TRUE(grid.isColumnClear(9, 0, 70));
+  EXPECT_FALSE(grid.isColumnClear(10, 0, 70));
+  EXPECT_TRUE(grid.isColumnClear(10, 0, 3));
+  EXPECT_TRUE(grid.isColumnClear(10, 4, 70));
+
+  grid.assignRow(3, 20, 80, false);
+  EXPECT_TRUE(grid.isRowClear(3, 20, 80));
+  EXPECT_FALSE(grid.isRowClear(3, 19, 80));
+  EXPECT_FALSE(grid.isRowClear(3, 20, 81));
+  EXPECT_TRUE(grid.isColumnClear(50, 0, 70));
+}
+
+// _____________________________________________________________________________
+
+TEST(OccupationGridTest, assignColumn) {
+  OccupationGrid grid(70, 100);
+  grid.assignColumn(65, 1, 99, true);
+  for (uint32_t y = 0; y < 100; y++) {
+    EXPECT_EQ(y >= 1 && y < 99, grid.get(65, y));
+    EXPECT_FALSE(grid.get(64, y));
+    EXPECT_FALSE(grid.get(66, y));
+  }
+  EXPECT_FALSE(grid.isColumnClear(65, 0, 100));
+  EXPECT_TRUE(grid.isColumnClear(65, 0, 1));
+  EXPECT_TRUE(grid.isColumnClear(65, 99, 100));
+  EXPECT_FALSE(grid.isRowClear(50, 0, 70));
+  EXPECT_TRUE(grid.isRowClear(50, 0, 65));
+  EXPECT_TRUE(grid.isRowClear(50, 66, 70));
+  EXPECT_TRUE(grid.isRowClear(0, 0, 70));
+
+  grid.assignColumn(65, 1, 99, false);
+  EXPECT_TRUE(grid.isColumnClear(65, 0, 100));
+  EXPECT_TRUE(grid.isRowClear(50, 0, 70));
+}
+
+// _____________________________________________________________________________
+
+TEST(OccupationGridTest, randomized) {
+  // Compare against a plain boolean matrix
+  std::mt19937 generator(7);
+  const uint32_t width = 150;
+  const uint32_t height = 90;
+  OccupationGrid grid(width, height);
+  std::vector<std::vector<bool>> cells(width, std::vector<bool>(height));
+  for (int round = 0; round < 2000; round++) {
+    bool value = generator() % 2;
+    bool horizontal = generator() % 2;
+    uint32_t position = generator() % (horizontal ? height : width);
+    uint32_t length = horizontal ? width : height;
+    uint32_t from = generator() % (length + 1);
+    uint32_t to = from + generator() % (length - from + 1);
+    for (uint32_t i = from; i < to; i++) {
+      if (horizontal) {
+        cells[i][position] = value;
+      } else {
+        cells[position][i] = value;
+      }
+    }
+    if (horizontal) {
+      grid.assignRow(position, from, to, value);
+    } else {
+      grid.assignColumn(position, from, to, value);
+    }
+
+    uint32_t y = generator() % height;
+    uint32_t x = generator() % width;
+    uint32_t rowFrom = generator() % (width + 1);
+    uint32_t rowTo = rowFrom + generator() % (width - rowFrom + 1);
+    uint32_t columnFrom = generator() % (height + 1);
+    uint32_t columnTo = columnFrom + generator() % (height - columnFrom + 1);
+    bool rowClear = true;
+    for (uint32_t i = rowFrom; i < rowTo; i++) {
+      rowClear = rowClear && !cells[i][y];
+    }
+    bool columnClear = true;
+    for (uint32_t i = columnFrom; i < columnTo; i++) {
+      columnClear = columnClear && !cells[x][i];
+    }
+    ASSERT_EQ(rowClear, grid.isRowClear(y, rowFrom, rowTo));
+    ASSERT_EQ(columnClear, grid.isColumnClear(x, columnFrom, columnTo));
+    ASSERT_EQ(cells[x][y], grid.get(x, y));
+  }
+}
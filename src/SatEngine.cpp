@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cstdint>
+#include <ostream>
+#include <tuple>
+#include <vector>
+#include "./SatEngine.h"
+#include "./Components.h"
+
+// _____________________________________________________________________________
+
+SatEngine::SatEngine(Game* game): _game(game) {
+  encodeGaps();
+  encodeCapacities();
+  encodeCrossings();
+}
+
+// _____________________________________________________________________________
+
+size_t SatEngine::variables() const {
+  return _sat.variables();
+}
+
+// _____________________________________________________________________________
+
+size_t SatEngine::clauses() const {
+  return _sat.clauses();
+}
+
+// _____________________________________________________________________________
+
+size_t SatEngine::cuts() const {
+  return _cuts;
+}
+
+// _____________________________________________________________________________
+
+const SatSolver::Statistics& SatEngine::statistics() const {
+  return _sat.statistics();
+}
+
+// _____________________________________________________________________________
+
+void SatEngine::writeDimacs(std::ostream* out) const {
+  _sat.writeDimacs(out);
+}
+
+// _____________________________________________________________________________
+
+void SatEngine::encodeGaps() {
+  for (uint32_t edge = 0; edge < _game->edgeCount(); edge++) {
+    auto islands = _game->edgeIslands(edge);
+    if (islands.second == nullptr) {
+      continue;
+    }
+    _gaps.push_back(edge);
+    int single = _sat.newVariable();
+    int twice = _sat.newVariable();
+    _single.push_back(single);
+    _double.push_back(twice);
+    // A double bridge is a bridge
+    _sat.addClause({ -twice, single });
+    int8_t existing = islands.first->isConnected(islands.second);
+    if (existing > 0) {
+      _sat.addClause({ single });
+    }
+    if (existing > 1) {
+      _sat.addClause({ twice });
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void SatEngine::encodeCapacities() {
+  // The variables of the bridges at every Island, at most 8 of them
+  std::vector<std::vector<int>> bridges(_game->getIslands().size());
+  for (size_t i = 0; i < _gaps.size(); i++) {
+    auto islands = _game->edgeIslands(_gaps[i]);
+    for (Island* island : { islands.first, islands.second }) {
+      bridges[island->index()].push_back(_single[i]);
+      bridges[island->index()].push_back(_double[i]);
+    }
+  }
+  for (const auto &island : _game->getIslands()) {
+    const auto &literals = bridges[island->index()];
+    uint32_t count = literals.size();
+    uint32_t required = island->_requiredBridges;
+    if (required > count) {
+      _sat.addClause({});
+      continue;
+    }
+    // At most k of n are true if every k + 1 of them contain a false
+    // one, at least k are true if every n - k + 1 contain a true one
+    auto addSubset = [this, &literals, count](uint32_t subset, int sign) {
+      std::vector<int> clause;
+      for (uint32_t j = 0; j < count; j++) {
+        if (subset & (1u << j)) {
+          clause.push_back(sign * literals[j]);
+        }
+      }
+      _sat.addClause(clause);
+    };
+    for (uint32_t subset = 0; subset < (1u << count); subset++) {
+      uint32_t size = 0;
+      for (uint32_t bits = subset; bits != 0; bits &= bits - 1) {
+        size++;
+      }
+      if (size == required + 1) {
+        addSubset(subset, -1);
+      }
+      if (size == count - required + 1) {
+        addSubset(subset, 1);
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void SatEngine::encodeCrossings() {
+  // The vertical gaps of every column as (top y, bottom y, gap), sorted
+  // from top to bottom, they don't overlap
+  uint32_t width = 0;
+  for (const auto &island : _game->getIslands()) {
+    width = std::max(width, island->_x + 1);
+  }
+  std::vector<std::vector<std::tuple<uint32_t, uint32_t, size_t>>>
+    columns(width);
+  for (size_t i = 0; i < _gaps.size(); i++) {
+    if (_gaps[i] % 2 == 1) {
+      auto islands = _game->edgeIslands(_gaps[i]);
+      columns[islands.first->_x].push_back(
+        std::make_tuple(islands.first->_y, islands.second->_y, i));
+    }
+  }
+  for (auto &column : columns) {
+    std::sort(column.begin(), column.end());
+  }
+  for (size_t i = 0; i < _gaps.size(); i++) {
+    if (_gaps[i] % 2 == 1) {
+      continue;
+    }
+    auto islands = _game->edgeIslands(_gaps[i]);
+    uint32_t y = islands.first->_y;
+    for (uint32_t x = islands.first->_x + 1; x < islands.second->_x; x++) {
+      const auto &column = columns[x];
+      // The last vertical gap that starts above the row
+      auto above = std::lower_bound(column.begin(), column.end(),
+        std::make_tuple(y, 0u, size_t(0)));
+      if (above == column.begin()) {
+        continue;
+      }
+      above--;
+      if (std::get<1>(*above) > y) {
+        _sat.addClause({ -static_cast<int>(_single[i]),
+          -static_cast<int>(_single[std::get<2>(*above)]) });
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+bool SatEngine::addCuts() {
+  size_t islands = _game->getIslands().size();
+  Components components(islands);
+  for (size_t i = 0; i < _gaps.size(); i++) {
+    if (_sat.value(_single[i])) {
+      auto ends = _game->edgeIslands(_gaps[i]);
+      components.unite(ends.first->index(), ends.second->index());
+    }
+  }
+  if (components.count() <= 1) {
+    return false;
+  }
+  // Every group needs a bridge to the rest, i.e. in a gap with one
+  // Island inside and one outside of it
+  std::vector<std::vector<int>> clauses(islands);
+  for (size_t i = 0; i < _gaps.size(); i++) {
+    auto ends = _game->edgeIslands(_gaps[i]);
+    uint32_t one = components.find(ends.first->index());
+    uint32_t two = components.find(ends.second->index());
+    if (one != two) {
+      clauses[one].push_back(_single[i]);
+      clauses[two].push_back(_single[i]);
+    }
+  }
+  for (uint32_t i = 0; i < islands; i++) {
+    if (components.find(i) == i) {
+      _sat.addClause(clauses[i]);
+      _cuts++;
+    }
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
+void SatEngine::applyModel() {
+  for (size_t i = 0; i < _gaps.size(); i++) {
+    int8_t bridges = _sat.value(_single[i]) + _sat.value(_double[i]);
+    auto islands = _game->edgeIslands(_gaps[i]);
+    int8_t existing = islands.first->isConnected(islands.second);
+    if (bridges > existing) {
+      _game->connect(islands.first, islands.second, bridges - existing == 2);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+bool SatEngine::solve() {
+  while (_sat.solve() == SatSolver::Result::SATISFIABLE) {
+    if (!addCuts()) {
+      applyModel();
+      return _game->isSolved();
+    }
+  }
+  return false;
+}
@@ -0,0 +1,82 @@
+#ifndef SATENGINE_H_
+#define SATENGINE_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+#include "./Game.h"
+#include "./SatSolver.h"
+
+// _____________________________________________________________________________
+
+// Alternative to the Solver that encodes a game in CNF and solves it
+// with the SatSolver. Every gap has a variable for at least one bridge
+// and one for a double bridge, every Island gets cardinality clauses for
+// exactly its amount of bridges, crossing gaps exclude each other and
+// bridges that are already part of the game are fixed. The bridges have
+// to connect all Islands, which isn't encoded up front: every assignment
+// that falls apart into several groups of Islands adds a clause per
+// group that demands a bridge leaving it, until one is connected
+class SatEngine {
+  FRIEND_TEST(SatEngineTest, constructor);
+  FRIEND_TEST(SatEngineTest, crossings);
+  FRIEND_TEST(SatEngineTest, addCuts);
+
+  // the game to solve
+  Game* const _game;
+  // the encoding of the game
+  SatSolver _sat;
+  // the gap ids (see Game::edgeId) that have a neighbour on both sides
+  std::vector<uint32_t> _gaps;
+  // the variable for at least one bridge in every gap of _gaps
+  std::vector<uint32_t> _single;
+  // the variable for a double bridge in every gap of _gaps
+  std::vector<uint32_t> _double;
+  // amount of connectivity clauses added
+  size_t _cuts = 0;
+
+  // Adds the variables of every gap and fixes the existing bridges
+  void encodeGaps();
+
+  // Adds the cardinality clauses for the bridges of every Island
+  void encodeCapacities();
+
+  // Adds a clause for every pair of gaps that cross each other
+  void encodeCrossings();
+
+  // Adds a clause for every group of Islands the bridges of the last
+  // assignment fall apart into, returns false if they are all connected
+  bool addCuts();
+
+  // Connects the bridges of the last assignment in the game
+  void applyModel();
+
+ public:
+  // Encodes the game, its current bridges are kept
+  explicit SatEngine(Game*);
+
+  // Modifies the game into a solution and returns true if there is one,
+  // returns false otherwise
+  bool solve();
+
+  // Returns the amount of variables of the encoding
+  size_t variables() const;
+
+  // Returns the amount of clauses of the encoding, including the
+  // connectivity clauses added so far
+  size_t clauses() const;
+
+  // Returns the amount of connectivity clauses added so far
+  size_t cuts() const;
+
+  // Returns the counters of the SatSolver
+  const SatSolver::Statistics& statistics() const;
+
+  // Writes the encoding in the DIMACS CNF format, including the
+  // connectivity clauses added so far
+  void writeDimacs(std::ostream*) const;
+};
+
+#endif  // SATENGINE_H_
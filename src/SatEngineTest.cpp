@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include "./SatEngine.h"
+#include "./Game.h"
+
+// _____________________________________________________________________________
+
+TEST(SatEngineTest, constructor) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  SatEngine engine(&game);
+  // 4 gaps with 2 variables each
+  ASSERT_EQ(4, engine._gaps.size());
+  EXPECT_EQ(8, engine.variables());
+  EXPECT_EQ(Game::edgeId(game.getIsland(0, 0), game.getIsland(2, 0)),
+    engine._gaps[0]);
+  EXPECT_EQ(Game::edgeId(game.getIsland(0, 0), game.getIsland(0, 2)),
+    engine._gaps[1]);
+  // 4 double implications, every Island has 4 variables, so 1 clause
+  // for at most 3 of them and 6 clauses for at least 3 of them
+  EXPECT_EQ(4 + 4 * 7, engine.clauses());
+  EXPECT_EQ(0, engine.cuts());
+}
+
+// _____________________________________________________________________________
+
+TEST(SatEngineTest, crossings) {
+  // The only possible bridges cross each other
+  Game game({
+    Island(1, 0, 1),
+    Island(0, 1, 1),
+    Island(2, 1, 1),
+    Island(1, 2, 1)
+  });
+  SatEngine engine(&game);
+  ASSERT_EQ(2, engine._gaps.size());
+  std::ostringstream out;
+  engine.writeDimacs(&out);
+  int vertical = engine._single[0];
+  int horizontal = engine._single[1];
+  EXPECT_NE(std::string::npos, out.str().find("\n-" +
+    std::to_string(horizontal) + " -" + std::to_string(vertical) + " 0\n"));
+  EXPECT_FALSE(engine.solve());
+  EXPECT_EQ(0, game.getIsland(1, 0)->isConnected(game.getIsland(1, 2)));
+}
+
+// _____________________________________________________________________________
+
+TEST(SatEngineTest, addCuts) {
+  Game game({
+    Island(0, 0, 2),
+    Island(2, 0, 2),
+    Island(0, 2, 2),
+    Island(2, 2, 2)
+  });
+  SatEngine engine(&game);
+  // A double bridge at the top leaves 2 separate pairs
+  engine._sat.addClause({ static_cast<int>(engine._double[0]) });
+  ASSERT_EQ(SatSolver::Result::SATISFIABLE, engine._sat.solve());
+  EXPECT_TRUE(engine.addCuts());
+  EXPECT_EQ(2, engine.cuts());
+  EXPECT_FALSE(engine.solve());
+}
+
+// _____________________________________________________________________________
+
+TEST(SatEngineTest, solve) {
+  // Either 2 separate double bridges or a ring of single bridges,
+  // only the ring connects all Islands
+  Game ring({
+    Island(0, 0, 2),
+    Island(2, 0, 2),
+    Island(0, 2, 2),
+    Island(2, 2, 2)
+  });
+  SatEngine ringEngine(&ring);
+  EXPECT_TRUE(ringEngine.solve());
+  EXPECT_TRUE(ring.isSolved());
+  EXPECT_EQ(1, ring.getIsland(0, 0)->isConnected(ring.getIsland(2, 0)));
+  EXPECT_EQ(1, ring.getIsland(0, 2)->isConnected(ring.getIsland(2, 2)));
+
+  // Existing bridges are kept
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+  game.connect(i00, i20, true);
+  SatEngine engine(&game);
+  EXPECT_TRUE(engine.solve());
+  EXPECT_TRUE(game.isSolved());
+  EXPECT_EQ(2, i00->isConnected(i20));
+  EXPECT_EQ(1, i00->isConnected(game.getIsland(0, 2)));
+
+  Game unsolvable({
+    Island(0, 0, 1),
+    Island(2, 0, 1),
+    Island(0, 2, 1),
+    Island(2, 2, 1)
+  });
+  SatEngine unsolvableEngine(&unsolvable);
+  EXPECT_FALSE(unsolvableEngine.solve());
+  EXPECT_LT(0, unsolvableEngine.cuts());
+  EXPECT_FALSE(unsolvable.isSolved());
+}
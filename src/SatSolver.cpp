@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <ostream>
+#include <utility>
+#include <vector>
+#include "./SatSolver.h"
+
+const uint32_t SatSolver::NONE;
+const int8_t SatSolver::NEGATIVE;
+const int8_t SatSolver::POSITIVE;
+const int8_t SatSolver::UNASSIGNED;
+
+// _____________________________________________________________________________
+
+// Helper function that converts a DIMACS literal to an internal one,
+// twice the variable index plus one if it is negated
+uint32_t toLiteral(int literal) {
+  return 2 * (static_cast<uint32_t>(std::abs(literal)) - 1) + (literal < 0);
+}
+
+// _____________________________________________________________________________
+
+SatSolver::SatSolver() {
+  // Level 0 needs a mark, even without variables
+  _levelStamps.push_back(0);
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::newVariable() {
+  uint32_t variable = _values.size();
+  _values.push_back(UNASSIGNED);
+  _levels.push_back(0);
+  _reasons.push_back(NONE);
+  _phases.push_back(NEGATIVE);
+  _activities.push_back(0);
+  _heapPositions.push_back(NONE);
+  _seen.push_back(false);
+  _levelStamps.push_back(0);
+  _watches.emplace_back();
+  _watches.emplace_back();
+  heapInsert(variable);
+  return variable + 1;
+}
+
+// _____________________________________________________________________________
+
+size_t SatSolver::variables() const {
+  return _values.size();
+}
+
+// _____________________________________________________________________________
+
+size_t SatSolver::clauses() const {
+  return _original.size();
+}
+
+// _____________________________________________________________________________
+
+const SatSolver::Statistics& SatSolver::statistics() const {
+  return _statistics;
+}
+
+// _____________________________________________________________________________
+
+bool SatSolver::value(uint32_t variable) const {
+  return _model[variable - 1] == POSITIVE;
+}
+
+// _____________________________________________________________________________
+
+int8_t SatSolver::literalValue(uint32_t literal) const {
+  int8_t value = _values[literal >> 1];
+  return value == UNASSIGNED ? UNASSIGNED : value ^ (literal & 1);
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::level() const {
+  return _levelStarts.size();
+}
+
+// _____________________________________________________________________________
+
+bool SatSolver::addClause(const std::vector<int> &clause) {
+  _original.push_back(clause);
+  if (_unsatisfiable) {
+    return false;
+  }
+  std::vector<uint32_t> literals;
+  for (int literal : clause) {
+    literals.push_back(toLiteral(literal));
+  }
+  // Duplicates and complementary literals end up next to each other
+  std::sort(literals.begin(), literals.end());
+  size_t kept = 0;
+  for (size_t i = 0; i < literals.size(); i++) {
+    uint32_t literal = literals[i];
+    // Clauses are only added at level 0, so all assignments are final
+    int8_t value = literalValue(literal);
+    if (value == POSITIVE || (i > 0 && literals[i - 1] == (literal ^ 1))) {
+      // Satisfied for good
+      return true;
+    }
+    if (value == NEGATIVE || (kept > 0 && literals[kept - 1] == literal)) {
+      continue;
+    }
+    literals[kept++] = literal;
+  }
+  literals.resize(kept);
+  if (literals.empty()) {
+    _unsatisfiable = true;
+    return false;
+  }
+  if (literals.size() == 1) {
+    assign(literals[0], NONE);
+    if (propagate() != NONE) {
+      _unsatisfiable = true;
+      return false;
+    }
+    return true;
+  }
+  attach(std::move(literals), false, 0);
+  return true;
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::attach(std::vector<uint32_t> &&literals, bool learned,
+  uint32_t lbd) {
+  uint32_t position = _clauses.size();
+  _watches[literals[0]].push_back(position);
+  _watches[literals[1]].push_back(position);
+  _clauses.push_back({ std::move(literals), learned, lbd, false });
+  if (learned) {
+    _learned.push_back(position);
+  }
+  return position;
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::assign(uint32_t literal, uint32_t reason) {
+  uint32_t variable = literal >> 1;
+  _values[variable] = POSITIVE ^ (literal & 1);
+  _levels[variable] = level();
+  _reasons[variable] = reason;
+  _trail.push_back(literal);
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::propagate() {
+  while (_propagated < _trail.size()) {
+    uint32_t falseLiteral = _trail[_propagated++] ^ 1;
+    std::vector<uint32_t> &watches = _watches[falseLiteral];
+    size_t kept = 0;
+    for (size_t i = 0; i < watches.size(); i++) {
+      uint32_t position = watches[i];
+      std::vector<uint32_t> &literals = _clauses[position].literals;
+      // The false literal goes second, the first one is implied
+      if (literals[0] == falseLiteral) {
+        std::swap(literals[0], literals[1]);
+      }
+      if (literalValue(literals[0]) == POSITIVE) {
+        watches[kept++] = position;
+        continue;
+      }
+      // Watch another literal that isn't false, if there is one
+      bool moved = false;
+      for (size_t k = 2; k < literals.size(); k++) {
+        if (literalValue(literals[k]) != NEGATIVE) {
+          std::swap(literals[1], literals[k]);
+          _watches[literals[1]].push_back(position);
+          moved = true;
+          break;
+        }
+      }
+      if (moved) {
+        continue;
+      }
+      watches[kept++] = position;
+      if (literalValue(literals[0]) == NEGATIVE) {
+        // Conflict, keep the remaining watches
+        for (i++; i < watches.size(); i++) {
+          watches[kept++] = watches[i];
+        }
+        watches.resize(kept);
+        _propagated = _trail.size();
+        return position;
+      }
+      _statistics.propagations++;
+      assign(literals[0], position);
+    }
+    watches.resize(kept);
+  }
+  return NONE;
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::analyze(uint32_t conflict,
+  std::vector<uint32_t>* learned) {
+  learned->clear();
+  // Room for the asserting literal
+  learned->push_back(0);
+  int open = 0;
+  uint32_t literal = NONE;
+  size_t index = _trail.size();
+  uint32_t clause = conflict;
+  do {
+    const std::vector<uint32_t> &literals = _clauses[clause].literals;
+    // The first literal of a reason is the one it implied
+    for (size_t i = literal == NONE ? 0 : 1; i < literals.size(); i++) {
+      uint32_t variable = literals[i] >> 1;
+      if (!_seen[variable] && _levels[variable] > 0) {
+        _seen[variable] = true;
+        bumpVariable(variable);
+        if (_levels[variable] >= level()) {
+          open++;
+        } else {
+          learned->push_back(literals[i]);
+        }
+      }
+    }
+    // Continue with the latest assignment that is part of the conflict
+    while (!_seen[_trail[--index] >> 1]) {}
+    literal = _trail[index];
+    clause = _reasons[literal >> 1];
+    _seen[literal >> 1] = false;
+    open--;
+  } while (open > 0);
+  (*learned)[0] = literal ^ 1;
+
+  // Drop the literals that are implied by the others
+  size_t kept = 1;
+  for (size_t i = 1; i < learned->size(); i++) {
+    if (_reasons[(*learned)[i] >> 1] == NONE
+      || !isRedundant((*learned)[i])) {
+      std::swap((*learned)[kept++], (*learned)[i]);
+    }
+  }
+  for (size_t i = 1; i < learned->size(); i++) {
+    _seen[(*learned)[i] >> 1] = false;
+  }
+  learned->resize(kept);
+
+  if (learned->size() == 1) {
+    return 0;
+  }
+  // The literal of the highest level is watched, so the clause becomes
+  // unit right after going back to that level
+  size_t highest = 1;
+  for (size_t i = 2; i < learned->size(); i++) {
+    if (_levels[(*learned)[i] >> 1] > _levels[(*learned)[highest] >> 1]) {
+      highest = i;
+    }
+  }
+  std::swap((*learned)[1], (*learned)[highest]);
+  return _levels[(*learned)[1] >> 1];
+}
+
+// _____________________________________________________________________________
+
+bool SatSolver::isRedundant(uint32_t literal) const {
+  const auto &literals = _clauses[_reasons[literal >> 1]].literals;
+  for (size_t i = 1; i < literals.size(); i++) {
+    uint32_t variable = literals[i] >> 1;
+    if (!_seen[variable] && _levels[variable] > 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::countLevels(const std::vector<uint32_t> &literals) {
+  _stamp++;
+  uint32_t count = 0;
+  for (uint32_t literal : literals) {
+    uint32_t level = _levels[literal >> 1];
+    if (_levelStamps[level] != _stamp) {
+      _levelStamps[level] = _stamp;
+      count++;
+    }
+  }
+  return count;
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::backtrack(uint32_t target) {
+  if (level() <= target) {
+    return;
+  }
+  for (size_t i = _trail.size(); i > _levelStarts[target]; i--) {
+    uint32_t variable = _trail[i - 1] >> 1;
+    _phases[variable] = _values[variable];
+    _values[variable] = UNASSIGNED;
+    _reasons[variable] = NONE;
+    heapInsert(variable);
+  }
+  _trail.resize(_levelStarts[target]);
+  _levelStarts.resize(target);
+  _propagated = _trail.size();
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::reduceLearned() {
+  // Worst first: most levels, then longest
+  std::sort(_learned.begin(), _learned.end(),
+    [this](uint32_t one, uint32_t two) {
+      const Clause &first = _clauses[one];
+      const Clause &second = _clauses[two];
+      if (first.lbd != second.lbd) {
+        return first.lbd > second.lbd;
+      }
+      return first.literals.size() > second.literals.size();
+    });
+  size_t remove = _learned.size() / 2;
+  size_t kept = 0;
+  for (uint32_t position : _learned) {
+    Clause &clause = _clauses[position];
+    bool locked = _reasons[clause.literals[0] >> 1] == position;
+    // Clauses over 2 levels are worth keeping for good
+    if (remove > 0 && clause.lbd > 2 && !locked) {
+      clause.deleted = true;
+      std::vector<uint32_t>().swap(clause.literals);
+      remove--;
+    } else {
+      _learned[kept++] = position;
+    }
+  }
+  _learned.resize(kept);
+  for (auto &watches : _watches) {
+    watches.clear();
+  }
+  for (uint32_t position = 0; position < _clauses.size(); position++) {
+    if (!_clauses[position].deleted) {
+      _watches[_clauses[position].literals[0]].push_back(position);
+      _watches[_clauses[position].literals[1]].push_back(position);
+    }
+  }
+  _maxLearned += _maxLearned / 10;
+}
+
+// _____________________________________________________________________________
+
+SatSolver::Result SatSolver::solve() {
+  if (_unsatisfiable) {
+    return Result::UNSATISFIABLE;
+  }
+  uint64_t restarts = 0;
+  uint64_t conflictsLeft = luby(restarts) * 100;
+  std::vector<uint32_t> learned;
+  while (true) {
+    uint32_t conflict = propagate();
+    if (conflict != NONE) {
+      _statistics.conflicts++;
+      if (level() == 0) {
+        _unsatisfiable = true;
+        return Result::UNSATISFIABLE;
+      }
+      uint32_t target = analyze(conflict, &learned);
+      uint32_t lbd = countLevels(learned);
+      backtrack(target);
+      if (learned.size() == 1) {
+        assign(learned[0], NONE);
+      } else {
+        uint32_t position = attach(std::vector<uint32_t>(learned), true, lbd);
+        assign(learned[0], position);
+      }
+      _statistics.learned++;
+      // Instead of decaying all activities, later conflicts weigh more
+      _increment /= 0.95;
+      if (conflictsLeft > 0) {
+        conflictsLeft--;
+      }
+      continue;
+    }
+    if (conflictsLeft == 0) {
+      _statistics.restarts++;
+      backtrack(0);
+      conflictsLeft = luby(++restarts) * 100;
+      continue;
+    }
+    if (_learned.size() >= _maxLearned + _trail.size()) {
+      reduceLearned();
+    }
+    uint32_t variable = pickVariable();
+    if (variable == NONE) {
+      _model = _values;
+      backtrack(0);
+      return Result::SATISFIABLE;
+    }
+    _statistics.decisions++;
+    _levelStarts.push_back(_trail.size());
+    assign(2 * variable + (_phases[variable] == NEGATIVE), NONE);
+  }
+}
+
+// _____________________________________________________________________________
+
+uint32_t SatSolver::pickVariable() {
+  while (!_heap.empty()) {
+    uint32_t variable = _heap[0];
+    _heapPositions[variable] = NONE;
+    _heap[0] = _heap.back();
+    _heap.pop_back();
+    if (!_heap.empty()) {
+      _heapPositions[_heap[0]] = 0;
+      heapDown(0);
+    }
+    if (_values[variable] == UNASSIGNED) {
+      return variable;
+    }
+  }
+  return NONE;
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::bumpVariable(uint32_t variable) {
+  _activities[variable] += _increment;
+  if (_activities[variable] > 1e100) {
+    // Scale everything down before the doubles overflow
+    for (auto &activity : _activities) {
+      activity *= 1e-100;
+    }
+    _increment *= 1e-100;
+  }
+  if (_heapPositions[variable] != NONE) {
+    heapUp(_heapPositions[variable]);
+  }
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::heapUp(size_t position) {
+  uint32_t variable = _heap[position];
+  while (position > 0) {
+    size_t parent = (position - 1) / 2;
+    if (_activities[_heap[parent]] >= _activities[variable]) {
+      break;
+    }
+    _heap[position] = _heap[parent];
+    _heapPositions[_heap[position]] = position;
+    position = parent;
+  }
+  _heap[position] = variable;
+  _heapPositions[variable] = position;
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::heapDown(size_t position) {
+  uint32_t variable = _heap[position];
+  while (2 * position + 1 < _heap.size()) {
+    size_t child = 2 * position + 1;
+    if (child + 1 < _heap.size()
+      && _activities[_heap[child + 1]] > _activities[_heap[child]]) {
+      child++;
+    }
+    if (_activities[_heap[child]] <= _activities[variable]) {
+      break;
+    }
+    _heap[position] = _heap[child];
+    _heapPositions[_heap[position]] = position;
+    position = child;
+  }
+  _heap[position] = variable;
+  _heapPositions[variable] = position;
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::heapInsert(uint32_t variable) {
+  if (_heapPositions[variable] != NONE) {
+    return;
+  }
+  _heap.push_back(variable);
+  _heapPositions[variable] = _heap.size() - 1;
+  heapUp(_heap.size() - 1);
+}
+
+// _____________________________________________________________________________
+
+uint64_t SatSolver::luby(uint64_t index) {
+  // Find the finite subsequence that contains the index and its size
+  uint64_t size = 1;
+  uint64_t exponent = 0;
+  while (size < index + 1) {
+    exponent++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != index) {
+    size = (size - 1) >> 1;
+    exponent--;
+    index = index % size;
+  }
+  return 1ull << exponent;
+}
+
+// _____________________________________________________________________________
+
+void SatSolver::writeDimacs(std::ostream* out) const {
+  *out << "p cnf " << variables() << " " << clauses() << "\n";
+  for (const auto &clause : _original) {
+    for (int literal : clause) {
+      *out << literal << " ";
+    }
+    *out << "0\n";
+  }
+}
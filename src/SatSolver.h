@@ -0,0 +1,193 @@
+#ifndef SATSOLVER_H_
+#define SATSOLVER_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// Self-contained conflict driven clause learning SAT solver. Clauses are
+// passed in DIMACS notation, variables are numbered from 1 and a negative
+// number stands for the negated variable. Propagation uses 2 watched
+// literals per clause, conflicts are analyzed up to the first unique
+// implication point, the branching variable is picked by its activity
+// (VSIDS) with saved phases, and the search restarts after a Luby
+// sequence of conflicts. Clauses can be added between calls to solve,
+// the learned clauses are kept
+class SatSolver {
+  FRIEND_TEST(SatSolverTest, constructor);
+  FRIEND_TEST(SatSolverTest, luby);
+  FRIEND_TEST(SatSolverTest, reduceLearned);
+
+ public:
+  // The answer of a call to solve
+  enum class Result { SATISFIABLE, UNSATISFIABLE };
+
+  // Counters over all calls to solve
+  struct Statistics {
+    // how many variables have been picked as a decision
+    uint64_t decisions;
+    // how many literals have been implied by a clause
+    uint64_t propagations;
+    // how many conflicts have been analyzed
+    uint64_t conflicts;
+    // how many times the search started over at the top level
+    uint64_t restarts;
+    // how many clauses have been learned
+    uint64_t learned;
+  };
+
+  // Creates a solver without variables and clauses
+  SatSolver();
+
+  // Adds a variable and returns its number
+  uint32_t newVariable();
+
+  // Returns the amount of variables
+  size_t variables() const;
+
+  // Returns the amount of clauses that have been added, learned ones
+  // don't count
+  size_t clauses() const;
+
+  // Adds a clause over existing variables, returns false if the formula
+  // is unsatisfiable because of it, an empty clause always is
+  bool addClause(const std::vector<int>&);
+
+  // Searches an assignment that satisfies every clause
+  Result solve();
+
+  // Returns the value of the variable in the assignment found by the last
+  // call to solve that returned SATISFIABLE
+  bool value(uint32_t) const;
+
+  // Returns the counters of all searches so far
+  const Statistics& statistics() const;
+
+  // Writes the clauses that have been added in the DIMACS CNF format
+  void writeDimacs(std::ostream*) const;
+
+ private:
+  // marks the absence of a clause, e.g. as the reason of a decision
+  static const uint32_t NONE = UINT32_MAX;
+  // values of a variable or literal, see _values
+  static const int8_t NEGATIVE = 0;
+  static const int8_t POSITIVE = 1;
+  static const int8_t UNASSIGNED = 2;
+
+  // A clause in internal literals, the first 2 literals are watched
+  struct Clause {
+    std::vector<uint32_t> literals;
+    // true if the clause has been learned from a conflict
+    bool learned;
+    // amount of decision levels among the literals when it was learned,
+    // lower is better
+    uint32_t lbd;
+    // true if the clause has been removed, its slot stays unused
+    bool deleted;
+  };
+
+  // the clauses as they have been added in DIMACS notation
+  std::vector<std::vector<int>> _original;
+  // all clauses that are watched, added and learned ones
+  std::vector<Clause> _clauses;
+  // positions of the learned clauses in _clauses
+  std::vector<uint32_t> _learned;
+  // for every internal literal the clauses watching it, they are visited
+  // once the literal becomes false
+  std::vector<std::vector<uint32_t>> _watches;
+  // the value of every variable
+  std::vector<int8_t> _values;
+  // the decision level every variable has been assigned on
+  std::vector<uint32_t> _levels;
+  // the clause that implied every variable, NONE for decisions
+  std::vector<uint32_t> _reasons;
+  // the value every variable had the last time it was assigned
+  std::vector<int8_t> _phases;
+  // the activity of every variable, bumped for every conflict it is part of
+  std::vector<double> _activities;
+  // amount _activities are bumped by, grows after every conflict instead
+  // of decaying all activities
+  double _increment = 1;
+  // binary max heap of the variables by activity
+  std::vector<uint32_t> _heap;
+  // the position of every variable in _heap or NONE
+  std::vector<uint32_t> _heapPositions;
+  // the assigned literals in order
+  std::vector<uint32_t> _trail;
+  // the position in _trail every decision level starts at
+  std::vector<size_t> _levelStarts;
+  // the position in _trail of the next literal to propagate
+  size_t _propagated = 0;
+  // marks of the variables during conflict analysis
+  std::vector<bool> _seen;
+  // marks of the decision levels while computing the lbd
+  std::vector<uint64_t> _levelStamps;
+  // current mark in _levelStamps
+  uint64_t _stamp = 0;
+  // the assignment of the last satisfiable search
+  std::vector<int8_t> _model;
+  // set once the clauses can't be satisfied anymore
+  bool _unsatisfiable = false;
+  // amount of learned clauses that triggers their reduction
+  size_t _maxLearned = 2000;
+  // counters of all searches
+  Statistics _statistics = { 0, 0, 0, 0, 0 };
+
+  // Returns the value of the internal literal
+  int8_t literalValue(uint32_t) const;
+
+  // Returns the current decision level
+  uint32_t level() const;
+
+  // Assigns the internal literal because of the clause, NONE for decisions
+  void assign(uint32_t, uint32_t);
+
+  // Propagates all assigned literals, returns the clause that became
+  // false or NONE
+  uint32_t propagate();
+
+  // Learns a clause from the conflicting clause, stores it in the 2nd
+  // parameter with the asserting literal first and the literal of the
+  // highest remaining level second, returns the level to go back to
+  uint32_t analyze(uint32_t, std::vector<uint32_t>*);
+
+  // Returns the amount of different decision levels among the literals
+  uint32_t countLevels(const std::vector<uint32_t>&);
+
+  // Returns true if the literal of the learned clause is implied by the
+  // other literals of the clause, so it can be removed
+  bool isRedundant(uint32_t) const;
+
+  // Removes all assignments above the given decision level
+  void backtrack(uint32_t);
+
+  // Adds the clause and watches its first 2 literals, returns its position
+  uint32_t attach(std::vector<uint32_t>&&, bool, uint32_t);
+
+  // Removes the worse half of the learned clauses that aren't the reason
+  // of an assignment
+  void reduceLearned();
+
+  // Returns the unassigned variable with the highest activity or NONE
+  uint32_t pickVariable();
+
+  // Raises the activity of the variable
+  void bumpVariable(uint32_t);
+
+  // Moves the variable at the given heap position up or down until the
+  // heap is valid again
+  void heapUp(size_t);
+  void heapDown(size_t);
+
+  // Adds the variable to the heap if it isn't part of it
+  void heapInsert(uint32_t);
+
+  // Returns the i-th element of the Luby sequence 1 1 2 1 1 2 4 ...
+  static uint64_t luby(uint64_t);
+};
+
+#endif  // SATSOLVER_H_
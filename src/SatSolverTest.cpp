@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <vector>
+#include "./SatSolver.h"
+
+// _____________________________________________________________________________
+
+// Helper function that returns true if the assignment of the solver
+// satisfies every clause
+bool satisfiesAll(const SatSolver &solver,
+  const std::vector<std::vector<int>> &clauses) {
+  for (const auto &clause : clauses) {
+    bool satisfied = false;
+    for (int literal : clause) {
+      satisfied |= solver.value(std::abs(literal)) == (literal > 0);
+    }
+    if (!satisfied) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
+// Helper function that adds the clauses putting n + 1 pigeons into n holes
+// to the solver, variable p * n + h + 1 puts pigeon p into hole h
+std::vector<std::vector<int>> pigeonholes(SatSolver* solver, int holes) {
+  std::vector<std::vector<int>> clauses;
+  for (int i = 0; i < (holes + 1) * holes; i++) {
+    solver->newVariable();
+  }
+  for (int pigeon = 0; pigeon <= holes; pigeon++) {
+    std::vector<int> somewhere;
+    for (int hole = 0; hole < holes; hole++) {
+      somewhere.push_back(pigeon * holes + hole + 1);
+    }
+    clauses.push_back(somewhere);
+  }
+  for (int hole = 0; hole < holes; hole++) {
+    for (int one = 0; one <= holes; one++) {
+      for (int two = one + 1; two <= holes; two++) {
+        clauses.push_back({ -(one * holes + hole + 1),
+          -(two * holes + hole + 1) });
+      }
+    }
+  }
+  for (const auto &clause : clauses) {
+    solver->addClause(clause);
+  }
+  return clauses;
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, constructor) {
+  SatSolver solver;
+  EXPECT_EQ(0, solver.variables());
+  EXPECT_EQ(0, solver.clauses());
+  EXPECT_EQ(1, solver._levelStamps.size());
+  EXPECT_EQ(1, solver.newVariable());
+  EXPECT_EQ(2, solver.newVariable());
+  EXPECT_EQ(2, solver.variables());
+  EXPECT_EQ(4, solver._watches.size());
+  EXPECT_EQ(2, solver._heap.size());
+  // Without clauses anything goes
+  EXPECT_EQ(SatSolver::Result::SATISFIABLE, solver.solve());
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, addClause) {
+  SatSolver solver;
+  for (int i = 0; i < 3; i++) {
+    solver.newVariable();
+  }
+  // Tautologies and duplicates don't hurt
+  EXPECT_TRUE(solver.addClause({ 1, -1 }));
+  EXPECT_TRUE(solver.addClause({ 2, 2, 3 }));
+  EXPECT_TRUE(solver.addClause({ -2 }));
+  EXPECT_EQ(3, solver.clauses());
+  ASSERT_EQ(SatSolver::Result::SATISFIABLE, solver.solve());
+  EXPECT_FALSE(solver.value(2));
+  EXPECT_TRUE(solver.value(3));
+
+  // The units contradict each other
+  EXPECT_FALSE(solver.addClause({ -3 }));
+  EXPECT_EQ(SatSolver::Result::UNSATISFIABLE, solver.solve());
+  EXPECT_FALSE(solver.addClause({ 1 }));
+
+  SatSolver empty;
+  EXPECT_FALSE(empty.addClause({}));
+  EXPECT_EQ(SatSolver::Result::UNSATISFIABLE, empty.solve());
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, pigeonholes) {
+  // 5 pigeons don't fit into 4 holes
+  SatSolver crowded;
+  pigeonholes(&crowded, 4);
+  EXPECT_EQ(SatSolver::Result::UNSATISFIABLE, crowded.solve());
+  EXPECT_LT(0, crowded.statistics().conflicts);
+  EXPECT_LT(0, crowded.statistics().learned);
+
+  // 3 pigeons fit into 3 holes
+  SatSolver solver;
+  for (int i = 0; i < 9; i++) {
+    solver.newVariable();
+  }
+  std::vector<std::vector<int>> three;
+  for (int pigeon = 0; pigeon < 3; pigeon++) {
+    three.push_back({ pigeon * 3 + 1, pigeon * 3 + 2, pigeon * 3 + 3 });
+  }
+  for (int hole = 1; hole <= 3; hole++) {
+    for (int one = 0; one < 3; one++) {
+      for (int two = one + 1; two < 3; two++) {
+        three.push_back({ -(one * 3 + hole), -(two * 3 + hole) });
+      }
+    }
+  }
+  for (const auto &clause : three) {
+    solver.addClause(clause);
+  }
+  ASSERT_EQ(SatSolver::Result::SATISFIABLE, solver.solve());
+  EXPECT_TRUE(satisfiesAll(solver, three));
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, randomized) {
+  // Random 3-SAT close to the threshold, compared with trying every
+  // assignment
+  std::mt19937 generator(17);
+  const int variables = 12;
+  for (int round = 0; round < 50; round++) {
+    SatSolver solver;
+    for (int i = 0; i < variables; i++) {
+      solver.newVariable();
+    }
+    std::vector<std::vector<int>> clauses(52);
+    for (auto &clause : clauses) {
+      for (int i = 0; i < 3; i++) {
+        int variable = generator() % variables + 1;
+        clause.push_back(generator() % 2 ? variable : -variable);
+      }
+      solver.addClause(clause);
+    }
+    bool expected = false;
+    for (uint32_t bits = 0; bits < (1u << variables) && !expected; bits++) {
+      bool all = true;
+      for (const auto &clause : clauses) {
+        bool satisfied = false;
+        for (int literal : clause) {
+          bool value = bits & (1u << (std::abs(literal) - 1));
+          satisfied |= value == (literal > 0);
+        }
+        all &= satisfied;
+      }
+      expected = all;
+    }
+    auto result = solver.solve();
+    EXPECT_EQ(expected, result == SatSolver::Result::SATISFIABLE);
+    if (result == SatSolver::Result::SATISFIABLE) {
+      EXPECT_TRUE(satisfiesAll(solver, clauses));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, incremental) {
+  // Excluding every solution after it has been found counts them,
+  // x1 or x2 or x3 has 7 of them
+  SatSolver solver;
+  for (int i = 0; i < 3; i++) {
+    solver.newVariable();
+  }
+  solver.addClause({ 1, 2, 3 });
+  int solutions = 0;
+  while (solver.solve() == SatSolver::Result::SATISFIABLE) {
+    solutions++;
+    std::vector<int> block;
+    for (int variable = 1; variable <= 3; variable++) {
+      block.push_back(solver.value(variable) ? -variable : variable);
+    }
+    solver.addClause(block);
+  }
+  EXPECT_EQ(7, solutions);
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, reduceLearned) {
+  SatSolver solver;
+  pigeonholes(&solver, 6);
+  // Reduce early and often
+  solver._maxLearned = 20;
+  EXPECT_EQ(SatSolver::Result::UNSATISFIABLE, solver.solve());
+  EXPECT_LT(solver._learned.size(), solver.statistics().learned);
+  EXPECT_LT(20, solver._maxLearned);
+  for (uint32_t position : solver._learned) {
+    EXPECT_FALSE(solver._clauses[position].deleted);
+    EXPECT_TRUE(solver._clauses[position].learned);
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, luby) {
+  std::vector<uint64_t> expected = { 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2,
+    4, 8, 1 };
+  for (size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(expected[i], SatSolver::luby(i));
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SatSolverTest, writeDimacs) {
+  SatSolver solver;
+  for (int i = 0; i < 3; i++) {
+    solver.newVariable();
+  }
+  solver.addClause({ 1, -2 });
+  solver.addClause({ 3 });
+  std::ostringstream out;
+  solver.writeDimacs(&out);
+  EXPECT_EQ("p cnf 3 2\n1 -2 0\n3 0\n", out.str());
+}
@@ -0,0 +1,115 @@
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "./SearchPool.h"
+
+// _____________________________________________________________________________
+
+SearchPool::SearchPool(size_t workers): _queued(0), _pending(0), _idle(0),
+  _stopped(false) {
+  for (size_t i = 0; i < workers; i++) {
+    _deques.emplace_back(new Deque());
+  }
+}
+
+// _____________________________________________________________________________
+
+size_t SearchPool::workers() const {
+  return _deques.size();
+}
+
+// _____________________________________________________________________________
+
+void SearchPool::push(size_t worker, SearchTask &&task) {
+  _pending++;
+  {
+    std::lock_guard<std::mutex> lock(_deques[worker]->mutex);
+    _deques[worker]->tasks.push_back(std::move(task));
+    _queued++;
+  }
+  // Waiting workers check _queued while holding _mutex, so locking it
+  // here makes sure none of them misses the signal
+  std::lock_guard<std::mutex> lock(_mutex);
+  _signal.notify_one();
+}
+
+// _____________________________________________________________________________
+
+bool SearchPool::take(size_t worker, SearchTask* task) {
+  for (size_t i = 0; i < _deques.size(); i++) {
+    Deque &deque = *_deques[(worker + i) % _deques.size()];
+    std::lock_guard<std::mutex> lock(deque.mutex);
+    if (deque.tasks.empty()) {
+      continue;
+    }
+    // The own deque is used like a stack, the others like a queue
+    if (i == 0) {
+      *task = std::move(deque.tasks.back());
+      deque.tasks.pop_back();
+    } else {
+      *task = std::move(deque.tasks.front());
+      deque.tasks.pop_front();
+    }
+    _queued--;
+    return true;
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+
+bool SearchPool::pop(size_t worker, SearchTask* task) {
+  if (_stopped) {
+    return false;
+  }
+  if (take(worker, task)) {
+    return true;
+  }
+  std::unique_lock<std::mutex> lock(_mutex);
+  _idle++;
+  while (!_stopped && _pending > 0) {
+    if (_queued == 0) {
+      _signal.wait(lock);
+      continue;
+    }
+    lock.unlock();
+    bool taken = take(worker, task);
+    lock.lock();
+    if (taken) {
+      _idle--;
+      return true;
+    }
+  }
+  _idle--;
+  return false;
+}
+
+// _____________________________________________________________________________
+
+void SearchPool::finish() {
+  if (--_pending == 0) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _signal.notify_all();
+  }
+}
+
+// _____________________________________________________________________________
+
+bool SearchPool::hungry() const {
+  return !_stopped && _idle > _queued;
+}
+
+// _____________________________________________________________________________
+
+void SearchPool::stop() {
+  _stopped = true;
+  std::lock_guard<std::mutex> lock(_mutex);
+  _signal.notify_all();
+}
+
+// _____________________________________________________________________________
+
+bool SearchPool::stopped() const {
+  return _stopped;
+}
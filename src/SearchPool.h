@@ -0,0 +1,101 @@
+#ifndef SEARCHPOOL_H_
+#define SEARCHPOOL_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "./Game.h"
+#include "./EdgeSet.h"
+
+// _____________________________________________________________________________
+
+// A subtree of the search that has been split off to be solved by any
+// worker: the bridges at its root, the gaps that must not be used in it
+// and the gaps (see Game::edgeId) that are still to be tried in order
+struct SearchTask {
+  // the bridges at the root of the subtree, shared by all tasks split
+  // off at the same node
+  std::shared_ptr<const GameSnapshot> snapshot;
+  // the gaps that are guaranteed to be wrong in the subtree
+  EdgeSet forbidden = EdgeSet(0);
+  // the gaps that are still to be tried
+  std::vector<uint32_t> gaps;
+};
+
+// _____________________________________________________________________________
+
+// Distributes search tasks to a fixed amount of workers. Every worker
+// has its own deque, it pushes and pops the tasks it splits off at the
+// back, so it keeps working depth first, and idle workers steal the
+// oldest tasks, which are the largest subtrees, from the front of the
+// other deques
+class SearchPool {
+  FRIEND_TEST(SearchPoolTest, constructor);
+  FRIEND_TEST(SearchPoolTest, pushPop);
+  FRIEND_TEST(SearchPoolTest, threads);
+
+ public:
+  // Creates a pool without tasks for the given amount of workers
+  explicit SearchPool(size_t);
+
+  // Returns the amount of workers
+  size_t workers() const;
+
+  // Adds a task to the deque of the given worker
+  void push(size_t, SearchTask&&);
+
+  // Hands the next task to the given worker, its own newest task or the
+  // oldest task of another worker. Waits while there is none, but other
+  // workers are still busy and might split off more.
+  // Returns false once every task is finished or the pool is stopped
+  bool pop(size_t, SearchTask*);
+
+  // Marks a task that has been handed out by pop as finished
+  void finish();
+
+  // Returns true if any worker is waiting for a task, so splitting off
+  // a task pays off
+  bool hungry() const;
+
+  // Lets every worker give up its task and pop return false,
+  // called once a solution has been found
+  void stop();
+
+  // Returns true if the pool has been stopped
+  bool stopped() const;
+
+ private:
+  // The tasks of a single worker
+  struct Deque {
+    std::mutex mutex;
+    std::deque<SearchTask> tasks;
+  };
+
+  // one deque per worker, the mutexes keep them at fixed addresses
+  std::vector<std::unique_ptr<Deque>> _deques;
+  // guards waiting for tasks
+  std::mutex _mutex;
+  // signaled when a task is pushed, the last task finishes or the pool
+  // is stopped
+  std::condition_variable _signal;
+  // amount of tasks in the deques
+  std::atomic<size_t> _queued;
+  // amount of tasks pushed, but not finished yet
+  std::atomic<size_t> _pending;
+  // amount of workers waiting for a task
+  std::atomic<size_t> _idle;
+  // set once the search is over
+  std::atomic<bool> _stopped;
+
+  // Takes a task from the back of the own or the front of another deque,
+  // returns false if all of them are empty
+  bool take(size_t, SearchTask*);
+};
+
+#endif  // SEARCHPOOL_H_
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "./SearchPool.h"
+
+// _____________________________________________________________________________
+
+// Helper function that creates a task which is recognized by its only gap
+SearchTask taskWithGap(uint32_t gap) {
+  SearchTask task;
+  task.gaps.push_back(gap);
+  return task;
+}
+
+// _____________________________________________________________________________
+
+TEST(SearchPoolTest, constructor) {
+  SearchPool pool(3);
+  EXPECT_EQ(3, pool.workers());
+  EXPECT_EQ(3, pool._deques.size());
+  EXPECT_EQ(0, pool._queued);
+  EXPECT_EQ(0, pool._pending);
+  EXPECT_FALSE(pool.hungry());
+  EXPECT_FALSE(pool.stopped());
+
+  // Nothing to do at all
+  SearchTask task;
+  EXPECT_FALSE(pool.pop(0, &task));
+}
+
+// _____________________________________________________________________________
+
+TEST(SearchPoolTest, pushPop) {
+  SearchPool pool(2);
+  pool.push(0, taskWithGap(1));
+  pool.push(0, taskWithGap(2));
+  pool.push(0, taskWithGap(3));
+  pool.push(1, taskWithGap(4));
+
+  // The own deque is used newest first, the other ones oldest first
+  SearchTask task;
+  ASSERT_TRUE(pool.pop(0, &task));
+  EXPECT_EQ(3, task.gaps[0]);
+  ASSERT_TRUE(pool.pop(1, &task));
+  EXPECT_EQ(4, task.gaps[0]);
+  ASSERT_TRUE(pool.pop(1, &task));
+  EXPECT_EQ(1, task.gaps[0]);
+  ASSERT_TRUE(pool.pop(0, &task));
+  EXPECT_EQ(2, task.gaps[0]);
+
+  // All tasks are handed out, but not finished yet, so the workers
+  // could still split off more
+  EXPECT_EQ(0, pool._queued);
+  EXPECT_EQ(4, pool._pending);
+  for (int i = 0; i < 4; i++) {
+    pool.finish();
+  }
+  EXPECT_FALSE(pool.pop(0, &task));
+}
+
+// _____________________________________________________________________________
+
+TEST(SearchPoolTest, stop) {
+  SearchPool pool(2);
+  pool.push(1, taskWithGap(1));
+  pool.stop();
+  EXPECT_TRUE(pool.stopped());
+  EXPECT_FALSE(pool.hungry());
+  SearchTask task;
+  EXPECT_FALSE(pool.pop(0, &task));
+}
+
+// _____________________________________________________________________________
+
+TEST(SearchPoolTest, threads) {
+  // Every task splits off 2 smaller ones until they are empty, the
+  // workers have to share them to get through the whole tree
+  SearchPool pool(4);
+  pool.push(0, taskWithGap(10));
+  std::atomic<int> processed(0);
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < pool.workers(); i++) {
+    workers.emplace_back([&pool, &processed, i]() {
+      SearchTask task;
+      while (pool.pop(i, &task)) {
+        uint32_t depth = task.gaps[0];
+        if (depth > 0) {
+          pool.push(i, taskWithGap(depth - 1));
+          pool.push(i, taskWithGap(depth - 1));
+        }
+        processed++;
+        pool.finish();
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  EXPECT_EQ(2047, processed);
+  EXPECT_EQ(0, pool._pending);
+  EXPECT_EQ(0, pool._idle);
+  EXPECT_FALSE(pool.stopped());
+}
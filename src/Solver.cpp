@@ -1,59 +1,899 @@
 #include <algorithm>
+#include <functional>
 #include <utility>
 #include <deque>
 #include <tuple>
-#include <unordered_map>
 #include <vector>
 #include <cstdint>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <cmath>
 #include "./Solver.h"
 
+const size_t Solver::DEFAULT_NOGOOD_BUDGET;
+const size_t Solver::DEFAULT_TABLE_MEMORY;
+const uint32_t Solver::NONE;
+const uint32_t Solver::CLOCK_INTERVAL;
+const uint64_t Solver::RESTART_UNIT;
+
+// _____________________________________________________________________________
+
+Solver::Solver(Game* game, Branching branching): _game(game),
+  _branching(branching), _ranks(game->getIslands().size(), 0),
+  // Every candidate gap holds at most one single and one double bridge
+  // on the current path, is forbidden at most once and its domain is
+  // narrowed at most twice, every decision makes one of the bridges
+  _trail(game->edgeCount() * 5, game->edgeCount() * 2),
+  _forbidden(game->edgeCount()), _domains(game->edgeCount()),
+  _queue(game->getIslands().size()),
+  _islandGaps(game->getIslands().size() * 4, NONE),
+  _islandNeighbours(game->getIslands().size() * 4, NONE),
+  _reasonStarts(1, 0), _depths(game->edgeCount() * 5, 0),
+  _previousEntries(game->edgeCount() * 5, NONE),
+  _bridgeEntries(game->edgeCount(), NONE),
+  _forbidEntries(game->edgeCount(), NONE),
+  _domainEntries(game->edgeCount(), NONE),
+  _factMarks(game->edgeCount() * 5, 0),
+  _islandMarks(game->getIslands().size(), 0),
+  _visitMarks(game->edgeCount() * 5, 0),
+  _nogoods(game->edgeCount(), DEFAULT_NOGOOD_BUDGET),
+  _slots(game->getIslands().size() * 4, CutEdges::NONE),
+  _cutEdges(game->getIslands().size()) {
+  // A Bridge affects its Islands, their neighbours and the Islands of the
+  // gaps it crosses, which are in different rows or columns each
+  _affected.reserve(10 + 2 * game->getIslands().size());
+  for (const auto &island : game->getIslands()) {
+    for (size_t i = 0; i < 4; i++) {
+      uint32_t edge = game->neighbourGap(*island, *Direction::ALL[i]);
+      if (edge != NONE) {
+        auto ends = game->edgeIslands(edge);
+        _islandGaps[island->index() * 4 + i] = edge;
+        _islandNeighbours[island->index() * 4 + i] =
+          (ends.first == island ? ends.second : ends.first)->index();
+      }
+    }
+  }
+  _domains.reset(*game, _forbidden);
+}
+
 // _____________________________________________________________________________
 
-bool Solver::eliminateObvious(
-  const std::unordered_multimap<Island*, Island*> &forbiddenConnections,
-  std::deque<std::pair<Bridge*, Bridge*>>* steps) {
-  size_t iterationsWithoutChange = 0;
+void Solver::enqueueAll() {
+  for (const auto &island : _game->getIslands()) {
+    _queue.push(island->index());
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::enqueueAffected(const Bridge* bridge) {
+  _affected.clear();
+  _game->findAffectedIslands(bridge, &_affected);
+  for (const auto &island : _affected) {
+    _queue.push(island->index());
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::enqueueForbidden(size_t from) {
+  for (size_t i = from; i < _trail.size(); i++) {
+    if (_trail[i].kind == Trail::Kind::FORBIDDEN) {
+      auto islands = _game->edgeIslands(_trail[i].edge);
+      _queue.push(islands.first->index());
+      _queue.push(islands.second->index());
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::parseBranching(const std::string &name, Branching* branching) {
+  for (Branching candidate : { Branching::INPUT, Branching::MOST_CONSTRAINED,
+    Branching::FEWEST_OPTIONS, Branching::MAX_DEGREE }) {
+    if (name == branchingName(candidate)) {
+      *branching = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+
+const char* Solver::branchingName(Branching branching) {
+  switch (branching) {
+    case Branching::MOST_CONSTRAINED:
+      return "constrained";
+    case Branching::FEWEST_OPTIONS:
+      return "options";
+    case Branching::MAX_DEGREE:
+      return "degree";
+    default:
+      return "input";
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::parseRestarts(const std::string &name, Restarts* restarts) {
+  for (Restarts candidate : { Restarts::NONE, Restarts::LUBY,
+    Restarts::GEOMETRIC }) {
+    if (name == restartsName(candidate)) {
+      *restarts = candidate;
+      return true;
+    }
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+
+const char* Solver::restartsName(Restarts restarts) {
+  switch (restarts) {
+    case Restarts::LUBY:
+      return "luby";
+    case Restarts::GEOMETRIC:
+      return "geometric";
+    default:
+      return "none";
+  }
+}
+
+// _____________________________________________________________________________
+
+uint64_t Solver::luby(uint64_t position) {
+  // The sequence is made of blocks ending in 2^power, the block of size
+  // 2^(power + 1) - 1 consists of the block before it twice plus 2^power
+  uint64_t size = 1;
+  uint32_t power = 0;
+  while (size < position + 1) {
+    power++;
+    size = 2 * size + 1;
+  }
+  while (size - 1 != position) {
+    size = (size - 1) / 2;
+    power--;
+    position %= size;
+  }
+  return static_cast<uint64_t>(1) << power;
+}
+
+// _____________________________________________________________________________
+
+uint64_t Solver::restartInterval(uint64_t run) const {
+  switch (_restarts) {
+    case Restarts::LUBY:
+      return _restartUnit * luby(run);
+    case Restarts::GEOMETRIC:
+      // Far beyond any search, but still a valid amount of nodes
+      return static_cast<uint64_t>(
+        std::min(_restartUnit * std::pow(1.5, run), 1e18));
+    default:
+      return UINT64_MAX;
+  }
+}
+
+// _____________________________________________________________________________
+
+const Solver::Statistics& Solver::statistics() const {
+  return _statistics;
+}
+
+// _____________________________________________________________________________
+
+void Solver::setNogoodBudget(size_t budget) {
+  _nogoodBudget = budget;
+  _nogoods = NogoodStore(_game->edgeCount(), budget);
+}
+
+// _____________________________________________________________________________
+
+void Solver::setTableMemory(size_t bytes) {
+  _tableMemory = bytes;
+  _table = nullptr;
+}
+
+// _____________________________________________________________________________
+
+void Solver::setDeadline(std::chrono::steady_clock::time_point deadline) {
+  _deadline = deadline;
+}
+
+// _____________________________________________________________________________
+
+void Solver::setNodeLimit(uint64_t nodes) {
+  _nodeLimit = nodes == 0 ? UINT64_MAX : nodes;
+}
+
+// _____________________________________________________________________________
+
+void Solver::setCancellation(const std::atomic<bool>* cancellation) {
+  _cancellation = cancellation;
+}
+
+// _____________________________________________________________________________
+
+void Solver::setRestarts(Restarts restarts, uint64_t unit) {
+  _restarts = restarts;
+  _restartUnit = unit;
+}
+
+// _____________________________________________________________________________
+
+void Solver::setSeed(uint32_t seed) {
+  _seed = seed;
+}
+
+// _____________________________________________________________________________
+
+Solver::Status Solver::status() const {
+  return _status;
+}
+
+// _____________________________________________________________________________
+
+bool Solver::expired() {
+  if (_expired) {
+    return true;
+  }
+  if ((_cancelled != nullptr && *_cancelled)
+    || (_cancellation != nullptr && *_cancellation)) {
+    _expired = true;
+  } else if (_deadline != std::chrono::steady_clock::time_point::max()
+    && ++_clockChecks >= CLOCK_INTERVAL) {
+    _clockChecks = 0;
+    _expired = std::chrono::steady_clock::now() >= _deadline;
+  }
+  return _expired;
+}
+
+// _____________________________________________________________________________
+
+void Solver::createTable() {
+  if (_table || _tableMemory == 0) {
+    return;
+  }
+  _table = std::make_shared<TranspositionTable>(_tableMemory);
+  if (_table->capacity() == 0) {
+    _tableMemory = 0;
+    _table = nullptr;
+  }
+}
+
+// _____________________________________________________________________________
+
+int Solver::rankIsland(Island* island) const {
+  SmartConnector smart(_game, island, _domains);
+  switch (_branching) {
+    case Branching::MOST_CONSTRAINED:
+      return smart.availableConnections() - island->missingConnections();
+    case Branching::FEWEST_OPTIONS:
+      return smart.openGaps();
+    case Branching::MAX_DEGREE:
+      return -smart.openGaps();
+    default:
+      return 0;
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::orderGaps(std::deque<std::tuple<Island*, Island*,
+  const Direction*>>* gaps) {
+  if (gaps->size() < 2) {
+    return;
+  }
+  if (_restarts != Restarts::NONE) {
+    std::shuffle(gaps->begin(), gaps->end(), _random);
+  }
+  if (_branching == Branching::INPUT) {
+    return;
+  }
+  for (const auto &entry : *gaps) {
+    _ranks[std::get<0>(entry)->index()] = rankIsland(std::get<0>(entry));
+    _ranks[std::get<1>(entry)->index()] = rankIsland(std::get<1>(entry));
+  }
+  // A gap is as urgent as the more urgent one of its Islands
+  auto rank = [this](const std::tuple<Island*, Island*, const Direction*>
+    &entry) {
+    Island* start = std::get<0>(entry);
+    Island* stop = std::get<1>(entry);
+    return std::make_pair(
+      std::min(_ranks[start->index()], _ranks[stop->index()]),
+      start->missingConnections() + stop->missingConnections());
+  };
+  std::stable_sort(gaps->begin(), gaps->end(),
+    [&rank](const std::tuple<Island*, Island*, const Direction*> &one,
+      const std::tuple<Island*, Island*, const Direction*> &two) {
+      return rank(one) < rank(two);
+    });
+}
+
+// _____________________________________________________________________________
+
+void Solver::forbid(Island* one, Island* two) {
+  uint32_t edge = Game::edgeId(one, two);
+  if (_forbidden.insert(edge)) {
+    _trail.pushForbidden(edge, _domains.restrict(edge, gapBridges(edge)));
+    explain();
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::clearTrail() {
+  _trail.clear();
+  _reasons.clear();
+  _reasonStarts.assign(1, 0);
+  std::fill(_bridgeEntries.begin(), _bridgeEntries.end(), NONE);
+  std::fill(_forbidEntries.begin(), _forbidEntries.end(), NONE);
+  std::fill(_domainEntries.begin(), _domainEntries.end(), NONE);
+}
+
+// _____________________________________________________________________________
+
+int8_t Solver::gapBridges(uint32_t edge) const {
+  return _game->getIslands()[edge / 2]->multiplicity(
+    edge % 2 ? Direction::DOWN : Direction::RIGHT);
+}
+
+// _____________________________________________________________________________
+
+bool Solver::isAccessible(uint32_t edge) const {
+  auto islands = _game->edgeIslands(edge);
+  return _game->findAccessibleIsland(*islands.first,
+    edge % 2 ? Direction::DOWN : Direction::RIGHT) == islands.second;
+}
+
+// _____________________________________________________________________________
+
+void Solver::clearFacts() {
+  _why.clear();
+  _whyDepth = 0;
+  // Start over once the marks run out
+  if (++_factMark == 0) {
+    std::fill(_factMarks.begin(), _factMarks.end(), 0);
+    std::fill(_islandMarks.begin(), _islandMarks.end(), 0);
+    _factMark = 1;
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::addFact(uint32_t position) {
+  if (position == NONE || _factMarks[position] == _factMark) {
+    return;
+  }
+  _factMarks[position] = _factMark;
+  _why.push_back(position);
+  _whyDepth = std::max(_whyDepth, _depths[position]);
+}
+
+// _____________________________________________________________________________
+
+void Solver::addBridgeFacts(const Island* island) {
+  for (size_t i = 0; i < 4; i++) {
+    if (island->multiplicity(*Direction::ALL[i]) != 0) {
+      addFact(_bridgeEntries[_islandGaps[island->index() * 4 + i]]);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::addCrossingFacts(uint32_t edge) {
+  _crossing.clear();
+  _game->crossingGaps(edge, &_crossing);
+  for (uint32_t crossing : _crossing) {
+    addFact(_bridgeEntries[crossing]);
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::addComponentFacts(const Island* origin) {
+  if (_islandMarks[origin->index()] == _factMark) {
+    return;
+  }
+  const auto &islands = _game->getIslands();
+  _islandMarks[origin->index()] = _factMark;
+  _stack.clear();
+  _stack.push_back(origin->index());
+  while (!_stack.empty()) {
+    uint32_t index = _stack.back();
+    _stack.pop_back();
+    for (size_t i = 0; i < 4; i++) {
+      if (islands[index]->multiplicity(*Direction::ALL[i]) == 0) {
+        continue;
+      }
+      addFact(_bridgeEntries[_islandGaps[index * 4 + i]]);
+      uint32_t other = _islandNeighbours[index * 4 + i];
+      if (_islandMarks[other] != _factMark) {
+        _islandMarks[other] = _factMark;
+        _stack.push_back(other);
+      }
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::addBandwidthFacts(Island* one, Island* two, uint32_t edge) {
+  addFact(_bridgeEntries[edge]);
+  addBridgeFacts(one);
+  addBridgeFacts(two);
+  // See Game#maxBandwidth
+  int8_t missing = one->missingConnections();
+  if (missing != 0 && missing == two->missingConnections()
+    && missing <= 2 - gapBridges(edge)
+    && _game->wouldCreateDisjunctGroup(one, two)) {
+    addComponentFacts(one);
+    addComponentFacts(two);
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::addIslandFacts(Island* island) {
+  for (size_t i = island->index() * 4; i < island->index() * 4 + 4; i++) {
+    uint32_t edge = _islandGaps[i];
+    if (edge == NONE) {
+      continue;
+    }
+    addFact(_bridgeEntries[edge]);
+    addFact(_domainEntries[edge]);
+    addBridgeFacts(_game->getIslands()[_islandNeighbours[i]]);
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::addCappedFacts(Island* island) {
+  for (size_t i = island->index() * 4; i < island->index() * 4 + 4; i++) {
+    uint32_t edge = _islandGaps[i];
+    if (edge == NONE) {
+      continue;
+    }
+    auto ends = _game->edgeIslands(edge);
+    if (_forbidden.contains(edge)) {
+      addFact(_forbidEntries[edge]);
+    } else if (_domains.max(edge) == gapBridges(edge)) {
+      addFact(_bridgeEntries[edge]);
+      addFact(_domainEntries[edge]);
+    } else if (!isAccessible(edge)) {
+      addCrossingFacts(edge);
+    } else if (_game->maxBandwidth(ends.first, ends.second) == 0) {
+      addBandwidthFacts(ends.first, ends.second, edge);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
+bool Solver::isOpen(uint32_t edge) const {
+  auto ends = _game->edgeIslands(edge);
+  return !_forbidden.contains(edge) && ends.first->missingConnections() != 0
+    && ends.second->missingConnections() != 0 && isAccessible(edge);
+}
+
+// _____________________________________________________________________________
+
+void Solver::addClosedFacts(uint32_t edge) {
+  auto ends = _game->edgeIslands(edge);
+  if (_forbidden.contains(edge)) {
+    addFact(_forbidEntries[edge]);
+  } else if (ends.first->missingConnections() == 0) {
+    addBridgeFacts(ends.first);
+  } else if (ends.second->missingConnections() == 0) {
+    addBridgeFacts(ends.second);
+  } else {
+    addCrossingFacts(edge);
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::connectCuts() {
+  const auto &islands = _game->getIslands();
+  for (size_t i = 0; i < _slots.size(); i++) {
+    uint32_t edge = _islandGaps[i];
+    bool possible = edge != NONE && (gapBridges(edge) != 0 || isOpen(edge));
+    _slots[i] = possible ? _islandNeighbours[i] : CutEdges::NONE;
+  }
+  _cutEdges.find(_slots);
+  if (_cutEdges.visited() < islands.size()) {
+    // The Islands reachable from the first one are cut off from the rest
+    clearFacts();
+    for (size_t i = 0; i < _slots.size(); i++) {
+      if (_islandGaps[i] != NONE && _cutEdges.isVisited(i / 4)
+        && !_cutEdges.isVisited(_islandNeighbours[i])) {
+        addClosedFacts(_islandGaps[i]);
+      }
+    }
+    analyze();
+    return false;
+  }
+  for (const auto &cut : _cutEdges.cuts()) {
+    uint32_t edge = _islandGaps[cut.slot];
+    // An earlier cut may have closed it, the next round fails then
+    if (gapBridges(edge) != 0 || !isOpen(edge)) {
+      continue;
+    }
+    // Every other gap between both sides is closed
+    clearFacts();
+    for (size_t i = 0; i < _slots.size(); i++) {
+      if (_islandGaps[i] != NONE && _islandGaps[i] != edge
+        && _cutEdges.isBelow(cut, i / 4)
+        && !_cutEdges.isBelow(cut, _islandNeighbours[i])) {
+        addClosedFacts(_islandGaps[i]);
+      }
+    }
+    _trail.push(_game->connect(islands[cut.parent], islands[cut.child],
+      false), nullptr);
+    explain();
+    _statistics.cuts++;
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
+void Solver::narrow(uint32_t edge, int8_t most) {
+  _trail.pushDomain(edge, _domains.restrict(edge, most));
+  explain();
+}
+
+// _____________________________________________________________________________
+
+void Solver::narrowCapacity(Island* island) {
+  int8_t missing = island->missingConnections();
+  for (size_t i = 0; i < 4; i++) {
+    uint32_t edge = _islandGaps[island->index() * 4 + i];
+    if (edge == NONE) {
+      continue;
+    }
+    int8_t most = island->multiplicity(*Direction::ALL[i]) + missing;
+    if (_domains.max(edge) > most) {
+      clearFacts();
+      addBridgeFacts(island);
+      narrow(edge, most);
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::narrowConnectivity(Island* island) {
+  const auto &islands = _game->getIslands();
+  int8_t missing = island->missingConnections();
+  for (size_t i = island->index() * 4; i < island->index() * 4 + 4; i++) {
+    uint32_t edge = _islandGaps[i];
+    if (edge == NONE) {
+      continue;
+    }
+    // See Game#maxBandwidth
+    Island* other = islands[_islandNeighbours[i]];
+    int8_t most = gapBridges(edge) + missing;
+    if (missing == 0 || other->missingConnections() != missing
+      || _domains.max(edge) < most
+      || !_game->wouldCreateDisjunctGroup(island, other)) {
+      continue;
+    }
+    clearFacts();
+    addBridgeFacts(island);
+    addBridgeFacts(other);
+    addComponentFacts(island);
+    addComponentFacts(other);
+    narrow(edge, most - 1);
+    _queue.push(other->index());
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::narrowDomains(size_t from) {
+  size_t end = _trail.size();
+  for (size_t i = from; i < end; i++) {
+    if (_trail[i].kind != Trail::Kind::CONNECTION) {
+      continue;
+    }
+    uint32_t edge = Game::edgeId(_trail[i].bridge);
+    // Only a new bridge crosses gaps, a double one replaces a single one
+    if (_trail[i].replaced == nullptr) {
+      _crossing.clear();
+      _game->acrossGaps(edge, &_crossing);
+      for (uint32_t crossing : _crossing) {
+        if (_domains.max(crossing) > 0) {
+          clearFacts();
+          addFact(i);
+          narrow(crossing, 0);
+        }
+      }
+    }
+    auto ends = _game->edgeIslands(edge);
+    narrowCapacity(ends.first);
+    narrowCapacity(ends.second);
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::explain() {
+  // The entries of one step share the facts of the first one
+  uint32_t first = NONE;
+  for (size_t i = _reasonStarts.size() - 1; i < _trail.size(); i++) {
+    const Trail::Entry &entry = _trail[i];
+    uint32_t depth = 0;
+    if (entry.kind != Trail::Kind::CONNECTION) {
+      // A domain is explained by its last narrowing alone
+      _previousEntries[i] = _domainEntries[entry.edge];
+      _domainEntries[entry.edge] = i;
+      if (entry.kind == Trail::Kind::FORBIDDEN) {
+        _forbidEntries[entry.edge] = i;
+      }
+    } else {
+      uint32_t edge = Game::edgeId(entry.bridge);
+      _previousEntries[i] = _bridgeEntries[edge];
+      _bridgeEntries[edge] = i;
+      // A connection adds to the bridge that has been there before
+      if (_previousEntries[i] != NONE) {
+        _reasons.push_back(_previousEntries[i]);
+        depth = _depths[_previousEntries[i]];
+      }
+    }
+    if (_trail.level() > 0 && i == _trail.levelStart()) {
+      depth = _trail.level();
+    } else if (first == NONE) {
+      _reasons.insert(_reasons.end(), _why.begin(), _why.end());
+      depth = std::max(depth, _whyDepth);
+      first = i;
+    } else {
+      _reasons.push_back(first);
+      depth = std::max(depth, _depths[first]);
+    }
+    _depths[i] = depth;
+    _reasonStarts.push_back(_reasons.size());
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::analyze() {
+  _conflict.clear();
+  if (++_visitMark == 0) {
+    std::fill(_visitMarks.begin(), _visitMarks.end(), 0);
+    _visitMark = 1;
+  }
+  _stack.assign(_why.begin(), _why.end());
+  while (!_stack.empty()) {
+    uint32_t position = _stack.back();
+    _stack.pop_back();
+    // Facts that don't depend on any decision end the search early
+    if (_visitMarks[position] == _visitMark || _depths[position] == 0) {
+      continue;
+    }
+    _visitMarks[position] = _visitMark;
+    if (position == _trail.levelStart(_depths[position])) {
+      _conflict.push_back(_depths[position]);
+    }
+    _stack.insert(_stack.end(), _reasons.begin() + _reasonStarts[position],
+      _reasons.begin() + _reasonStarts[position + 1]);
+  }
+}
+
+// _____________________________________________________________________________
+
+void Solver::analyzeExhaustion() {
+  Island* best = nullptr;
+  uint32_t bestDepth = NONE;
+  for (const auto &island : _game->getIslands()) {
+    if (island->missingConnections() == 0) {
+      continue;
+    }
+    clearFacts();
+    if (addCappedFacts(island) && _whyDepth < bestDepth) {
+      best = island;
+      bestDepth = _whyDepth;
+      if (bestDepth == 0) {
+        break;
+      }
+    }
+  }
+  clearFacts();
+  if (best != nullptr) {
+    addCappedFacts(best);
+    analyze();
+    return;
+  }
+  // Every Island is full, so they fall apart into closed groups
+  for (const auto &island : _game->getIslands()) {
+    if (_game->isPartOfDisjunctGroup(island)) {
+      addComponentFacts(island);
+      analyze();
+      return;
+    }
+  }
+  // Gaps have been split off to other workers, so there is no Island
+  // that can't be completed anymore, every decision may matter
+  _conflict.clear();
+  for (uint32_t level = 1; level <= _trail.level(); level++) {
+    _conflict.push_back(level);
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::checkNogoods(size_t from) {
+  NogoodStore::Counter bridges = [this](uint32_t edge) {
+    return gapBridges(edge);
+  };
+  size_t end = _trail.size();
+  for (size_t i = from; i < end; i++) {
+    if (_trail[i].kind != Trail::Kind::CONNECTION) {
+      continue;
+    }
+    _candidates.clear();
+    _nogoods.update(Game::edgeId(_trail[i].bridge), bridges, &_candidates);
+    for (uint32_t id : _candidates) {
+      const auto &literals = _nogoods[id];
+      const NogoodStore::Literal* open = nullptr;
+      bool several = false;
+      for (const auto &literal : literals) {
+        if (gapBridges(literal.edge) < literal.bridges) {
+          several = open != nullptr;
+          open = &literal;
+          if (several) {
+            break;
+          }
+        }
+      }
+      if (several || (open != nullptr
+        && (_forbidden.contains(open->edge)
+        || gapBridges(open->edge) != open->bridges - 1))) {
+        continue;
+      }
+      clearFacts();
+      for (const auto &literal : literals) {
+        if (&literal != open) {
+          addFact(_bridgeEntries[literal.edge]);
+        }
+      }
+      _nogoods.touch(id);
+      _statistics.prunes++;
+      if (open == nullptr) {
+        analyze();
+        return false;
+      }
+      // The last literal must not become true
+      auto islands = _game->edgeIslands(open->edge);
+      forbid(islands.first, islands.second);
+      _queue.push(islands.first->index());
+      _queue.push(islands.second->index());
+    }
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
+void Solver::learn(const NogoodStore::Literal &decision) {
+  // The literals that are undone first are watched
+  _literals.clear();
+  _literals.push_back(decision);
+  std::sort(_conflict.begin(), _conflict.end(), std::greater<uint32_t>());
+  for (uint32_t level : _conflict) {
+    const Bridge* bridge = _trail[_trail.levelStart(level)].bridge;
+    _literals.push_back({ Game::edgeId(bridge), Game::multiplicity(bridge) });
+  }
+  if (_nogoods.add(_literals)) {
+    _statistics.nogoods++;
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::eliminateObvious() {
+  // The domains and nogoods haven't seen the decision of this level yet
+  narrowDomains(_trail.levelStart());
+  if (!checkNogoods(_trail.levelStart())) {
+    _queue.clear();
+    return false;
+  }
   const auto &islands = _game->getIslands();
-  size_t islandCount = islands.size();
   while (true) {
-    for (const auto &island : islands) {
-      size_t stepAmount = steps->size();
+    while (!_queue.empty()) {
+      if (expired()) {
+        // Giving up fails every node up to the root at once
+        _aborts++;
+        _conflict.clear();
+        _queue.clear();
+        return false;
+      }
+      Island* island = islands[_queue.pop()];
       int8_t conn = island->missingConnections();
-      if (conn != 0) {
-        SmartConnector smart(_game, island, forbiddenConnections);
-        if (!smart.connectSmart(conn, steps)) {
-          return false;
+      if (conn == 0) {
+        continue;
+      }
+      narrowConnectivity(island);
+      size_t stepAmount = _trail.size();
+      SmartConnector smart(_game, island, _domains);
+      bool connectivity = smart.needsConnectivity(conn);
+      bool consistent = smart.connectSmart(conn, &_trail);
+      if (!consistent || _trail.size() > stepAmount) {
+        clearFacts();
+        addIslandFacts(island);
+        if (connectivity || !consistent) {
+          addComponentFacts(island);
+          for (size_t i = island->index() * 4; i < island->index() * 4 + 4;
+            i++) {
+            if (_islandNeighbours[i] != NONE) {
+              addComponentFacts(islands[_islandNeighbours[i]]);
+            }
+          }
         }
+        explain();
       }
-      // Once we iterated over all islands without a single
-      // change, our strategies no longer achieve anything
-      if (steps->size() == stepAmount) {
-        iterationsWithoutChange++;
-      } else {
-        iterationsWithoutChange = 0;
+      if (!consistent) {
+        analyze();
+        // The remaining Islands don't matter, the changes are reverted anyway
+        _queue.clear();
+        return false;
+      }
+      // Only the surroundings of the new bridges can reveal new connections
+      for (size_t i = stepAmount; i < _trail.size(); i++) {
+        enqueueAffected(_trail[i].bridge);
       }
-      if (iterationsWithoutChange == islandCount) {
-        return true;
+      narrowDomains(stepAmount);
+      if (!checkNogoods(stepAmount)) {
+        _queue.clear();
+        return false;
       }
     }
+    // Nothing is obvious about a single Island anymore, but the board
+    // as a whole still has to be connected
+    size_t cutAmount = _trail.size();
+    if (!connectCuts()) {
+      return false;
+    }
+    if (_trail.size() == cutAmount) {
+      return true;
+    }
+    for (size_t i = cutAmount; i < _trail.size(); i++) {
+      enqueueAffected(_trail[i].bridge);
+    }
+    narrowDomains(cutAmount);
+    if (!checkNogoods(cutAmount)) {
+      _queue.clear();
+      return false;
+    }
   }
 }
 
 // _____________________________________________________________________________
 
-// Helper function that deallocates the "overridden bridges" from the
-// given step deque when a solution has been found
-void deleteReplacedBridges(std::deque<std::pair<Bridge*, Bridge*>>* steps) {
-  // Clear the steps, so we dont store any references to potentially
-  // deallocated memory
-  for (const auto &entry : *steps) {
-    delete entry.second;
+// Helper function that recycles the "overridden bridges" from the
+// given trail when the search is over
+void recycleReplacedBridges(Game* game, const Trail &trail) {
+  for (size_t i = 0; i < trail.size(); i++) {
+    if (trail[i].replaced != nullptr) {
+      game->recycle(trail[i].replaced);
+    }
   }
 }
 
 // _____________________________________________________________________________
 
-bool Solver::solve() {
+std::deque<std::tuple<Island*, Island*, const Direction*>> Solver::
+  collectGaps() const {
   std::deque<std::tuple<Island*, Island*, const Direction*>> all;
   // Gather all connections that can be made on the map
   for (const auto &start : _game->getIslands()) {
@@ -68,31 +908,319 @@ bool Solver::solve() {
       all.push_back(std::make_tuple(start, right, &Direction::RIGHT));
     }
   }
-  std::unordered_multimap<Island*, Island*> forbidden;
-  std::deque<std::pair<Bridge*, Bridge*>> steps;
+  return all;
+}
+
+// _____________________________________________________________________________
+
+bool Solver::solve() {
+  return countSolutions(1) == 1;
+}
+
+// _____________________________________________________________________________
+
+uint64_t Solver::countSolutions(uint64_t limit) {
+  return enumerate(limit);
+}
+
+// _____________________________________________________________________________
+
+uint64_t Solver::enumerateSolutions(
+  const std::function<bool(const Solution&)> &visitor) {
+  _visitor = &visitor;
+  uint64_t solutions = enumerate(0);
+  _visitor = nullptr;
+  return solutions;
+}
+
+// _____________________________________________________________________________
+
+uint64_t Solver::enumerate(uint64_t limit) {
+  auto all = collectGaps();
+  clearTrail();
+  _forbidden.clear();
+  _domains.reset(*_game, _forbidden);
+  _queue.clear();
+  _nogoods.clear();
+  _statistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  _limit = limit == 0 ? UINT64_MAX : limit;
+  _solutions = 0;
+  _firstSolution = nullptr;
+  _clockChecks = 0;
+  _expired = false;
+  _random.seed(_seed);
+  // Counted solutions would be counted again after a restart
+  bool restarts = _restarts != Restarts::NONE && _limit == 1;
+  _restartNodes = restarts ? restartInterval(0) : UINT64_MAX;
+  // Nothing has been analyzed yet
+  enqueueAll();
   // Start recursion
-  bool solved = solve(all, forbidden, &steps);
-  deleteReplacedBridges(&steps);
+  solve(all);
+  while (_restarting) {
+    // Only the decisions are undone, so the next run starts with
+    // everything learned so far
+    _restarting = false;
+    _statistics.restarts++;
+    _restartNodes = _statistics.nodes
+      + restartInterval(_statistics.restarts);
+    enqueueAll();
+    solve(all);
+  }
+  _status = _expired ? Status::TIMED_OUT
+    : _solutions > 0 ? Status::SOLVED : Status::UNSOLVABLE;
+  recycleReplacedBridges(_game, _trail);
+  // Clear the trail, so we dont store any references to potentially
+  // recycled memory
+  clearTrail();
+  if (_firstSolution) {
+    _game->restore(*_firstSolution);
+    _firstSolution = nullptr;
+  }
+  _limit = 1;
+  return _solutions;
+}
+
+// _____________________________________________________________________________
+
+bool Solver::countSolution() {
+  _solutions++;
+  if (_visitor != nullptr) {
+    collectSolution();
+    if (!(*_visitor)(_solution)) {
+      return true;
+    }
+  }
+  if (_solutions >= _limit) {
+    return true;
+  }
+  if (_solutions == 1 && _visitor == nullptr) {
+    _firstSolution.reset(new GameSnapshot(_game->snapshot()));
+  }
+  _conflict.clear();
+  for (uint32_t level = 1; level <= _trail.level(); level++) {
+    _conflict.push_back(level);
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+
+void Solver::collectSolution() {
+  _solution.clear();
+  for (uint32_t edge = 0; edge < _game->edgeCount(); edge++) {
+    int8_t bridges = gapBridges(edge);
+    if (bridges > 0) {
+      _solution.push_back(std::make_pair(edge, bridges));
+    }
+  }
+}
+
+// _____________________________________________________________________________
+
+bool Solver::solveParallel(size_t threads) {
+  if (threads <= 1) {
+    return solve();
+  }
+  SearchPool pool(threads);
+  // The whole search is the first task
+  SearchTask root;
+  root.snapshot = std::make_shared<GameSnapshot>(_game->snapshot());
+  root.forbidden = EdgeSet(_game->edgeCount());
+  for (const auto &entry : collectGaps()) {
+    root.gaps.push_back(Game::edgeId(std::get<0>(entry), std::get<1>(entry)));
+  }
+  pool.push(0, std::move(root));
+
+  // Every worker searches on its own clone of the game
+  std::vector<Game> games;
+  games.reserve(threads);
+  std::vector<std::unique_ptr<Solver>> solvers;
+  for (size_t i = 0; i < threads; i++) {
+    games.push_back(_game->clone());
+    solvers.emplace_back(new Solver(&games[i], _branching));
+    solvers[i]->setNogoodBudget(_nogoodBudget);
+    solvers[i]->setTableMemory(0);
+    solvers[i]->_deadline = _deadline;
+    solvers[i]->_nodeLimit = _nodeLimit;
+    solvers[i]->_cancellation = _cancellation;
+    solvers[i]->_pool = &pool;
+    solvers[i]->_worker = i;
+  }
+
+  std::mutex solutionMutex;
+  std::unique_ptr<GameSnapshot> solution;
+  std::vector<std::thread> workers;
+  for (size_t i = 0; i < threads; i++) {
+    workers.emplace_back([&, i]() {
+      SearchTask task;
+      while (pool.pop(i, &task)) {
+        if (solvers[i]->solveTask(task)) {
+          std::lock_guard<std::mutex> lock(solutionMutex);
+          if (!solution) {
+            solution.reset(new GameSnapshot(games[i].snapshot()));
+          }
+          pool.stop();
+        } else if (solvers[i]->_expired) {
+          // The others would give up as well
+          pool.stop();
+        }
+        pool.finish();
+      }
+    });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+
+  _statistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  for (const auto &solver : solvers) {
+    _statistics.nodes += solver->_statistics.nodes;
+    _statistics.decisions += solver->_statistics.decisions;
+    _statistics.backtracks += solver->_statistics.backtracks;
+    _statistics.backjumps += solver->_statistics.backjumps;
+    _statistics.nogoods += solver->_statistics.nogoods;
+    _statistics.prunes += solver->_statistics.prunes;
+    _statistics.tableHits += solver->_statistics.tableHits;
+    _statistics.tableMisses += solver->_statistics.tableMisses;
+    _statistics.cuts += solver->_statistics.cuts;
+    _statistics.restarts += solver->_statistics.restarts;
+  }
+  _status = Status::UNSOLVABLE;
+  for (const auto &solver : solvers) {
+    if (solver->_expired) {
+      _status = Status::TIMED_OUT;
+    }
+  }
+  if (solution) {
+    _game->restore(*solution);
+    _status = Status::SOLVED;
+    return true;
+  }
+  return false;
+}
+
+// _____________________________________________________________________________
+
+bool Solver::solvePortfolio(const std::vector<Branching> &branchings,
+  Branching* winner) {
+  if (branchings.empty()) {
+    *winner = _branching;
+    return solve();
+  }
+  // Every configuration searches on its own clone of the game
+  std::atomic<bool> cancelled(false);
+  createTable();
+  std::vector<Game> games;
+  games.reserve(branchings.size());
+  std::vector<std::unique_ptr<Solver>> solvers;
+  for (size_t i = 0; i < branchings.size(); i++) {
+    games.push_back(_game->clone());
+    solvers.emplace_back(new Solver(&games[i], branchings[i]));
+    solvers[i]->setNogoodBudget(_nogoodBudget);
+    // A state that fails for one strategy fails for all of them
+    solvers[i]->setTableMemory(_tableMemory);
+    solvers[i]->_table = _table;
+    solvers[i]->_deadline = _deadline;
+    solvers[i]->_nodeLimit = _nodeLimit;
+    solvers[i]->_cancellation = _cancellation;
+    solvers[i]->_cancelled = &cancelled;
+    // Racers with the same strategy still make different decisions
+    solvers[i]->_restarts = _restarts;
+    solvers[i]->_restartUnit = _restartUnit;
+    solvers[i]->_seed = _seed + i;
+  }
+
+  std::mutex winnerMutex;
+  size_t first = branchings.size();
+  bool solved = false;
+  std::vector<std::thread> racers;
+  for (size_t i = 0; i < branchings.size(); i++) {
+    racers.emplace_back([&, i]() {
+      bool result = solvers[i]->solve();
+      // Only the winner cancels, so every Solver that gets here before
+      // a winner has been chosen has finished its search
+      std::lock_guard<std::mutex> lock(winnerMutex);
+      if (first == branchings.size()) {
+        first = i;
+        solved = result;
+        cancelled = true;
+      }
+    });
+  }
+  for (auto &racer : racers) {
+    racer.join();
+  }
+
+  *winner = branchings[first];
+  _statistics = solvers[first]->_statistics;
+  _status = solvers[first]->_status;
+  // A winner that gave up holds its partial result
+  if (solved || _status == Status::TIMED_OUT) {
+    _game->restore(games[first].snapshot());
+  }
+  return solved;
+}
+
+// _____________________________________________________________________________
+
+bool Solver::solveTask(const SearchTask &task) {
+  _game->restore(*task.snapshot);
+  clearTrail();
+  _forbidden = task.forbidden;
+  _domains.reset(*_game, _forbidden);
+  _queue.clear();
+  // The nogoods only hold together with the snapshot and forbidden gaps
+  // of the task they have been learned in
+  _nogoods.clear();
+  // Nothing has been analyzed on this game yet
+  enqueueAll();
+  std::deque<std::tuple<Island*, Island*, const Direction*>> gaps;
+  for (uint32_t edge : task.gaps) {
+    auto islands = _game->edgeIslands(edge);
+    gaps.push_back(std::make_tuple(islands.first, islands.second,
+      edge % 2 ? &Direction::DOWN : &Direction::RIGHT));
+  }
+  bool solved = solve(gaps);
+  recycleReplacedBridges(_game, _trail);
+  clearTrail();
   return solved;
 }
 
 // _____________________________________________________________________________
 
+void Solver::splitGaps(std::deque<std::tuple<Island*, Island*,
+  const Direction*>>* gaps) {
+  // The task continues where this Solver would continue once the first
+  // gap failed
+  SearchTask task;
+  task.snapshot = std::make_shared<GameSnapshot>(_game->snapshot());
+  task.forbidden = _forbidden;
+  task.forbidden.insert(Game::edgeId(std::get<0>(gaps->front()),
+    std::get<1>(gaps->front())));
+  for (auto it = gaps->begin() + 1; it != gaps->end(); it++) {
+    task.gaps.push_back(Game::edgeId(std::get<0>(*it), std::get<1>(*it)));
+  }
+  gaps->erase(gaps->begin() + 1, gaps->end());
+  _pool->push(_worker, std::move(task));
+}
+
+// _____________________________________________________________________________
+
 bool Solver::solve(const std::deque<std::tuple<Island*, Island*,
-  const Direction*>> &possibleGaps,
-  const std::unordered_multimap<Island*, Island*> &forbidden,
-  std::deque<std::pair<Bridge*, Bridge*>>* steps) {
-  if (eliminateObvious(forbidden, steps)) {
+  const Direction*>> &possibleGaps) {
+  _statistics.nodes++;
+  if (eliminateObvious()) {
     if (_game->isSolved()) {
       // Game is solved, hooray
-      return true;
+      return countSolution();
     }
 
-    std::unordered_multimap<Island*, Island*> curForbidden(forbidden);
-    // Gather gaps that are still valid
-    auto newGaps = extractValidGaps(possibleGaps, &curForbidden);
+    // Gather gaps that are still valid, the gaps forbidden from here on
+    // are reverted together with the decision that lead here
+    auto newGaps = extractValidGaps(possibleGaps);
+    orderGaps(&newGaps);
     // Try them exclusively
-    return tryGaps(&newGaps, &curForbidden);
+    return tryGaps(&newGaps);
   }
   return false;
 }
@@ -101,13 +1229,16 @@ bool Solver::solve(const std::deque<std::tuple<Island*, Island*,
 
 std::deque<std::tuple<Island*, Island*, const Direction*>> Solver::
   extractValidGaps(const std::deque<std::tuple<Island*, Island*,
-  const Direction*>> &possibleGaps,
-  std::unordered_multimap<Island*, Island*>* forbidden) const {
+  const Direction*>> &possibleGaps) {
   std::deque<std::tuple<Island*, Island*, const Direction*>> newGaps;
   for (const auto &entry : possibleGaps) {
     Island* start = std::get<0>(entry);
     Island* stop = std::get<1>(entry);
-    if (_game->findAccessibleIsland(*start, *std::get<2>(entry)) == stop) {
+    // Nogoods may have forbidden gaps that haven't been tried yet
+    uint32_t edge = Game::edgeId(start, stop);
+    if (_game->findAccessibleIsland(*start, *std::get<2>(entry)) == stop
+      && !_forbidden.contains(edge)
+      && _domains.max(edge) > gapBridges(edge)) {
       int8_t maxBandwidth = _game->maxBandwidth(start, stop);
       if (maxBandwidth > 0) {
         if (maxBandwidth != start->missingConnections()
@@ -115,7 +1246,11 @@ std::deque<std::tuple<Island*, Island*, const Direction*>> Solver::
             || !_game->wouldCreateDisjunctGroup(start, stop)) {
           newGaps.push_back(entry);
         } else {
-          forbidden->insert(std::make_pair(start, stop));
+          clearFacts();
+          addBandwidthFacts(start, stop, edge);
+          addComponentFacts(start);
+          addComponentFacts(stop);
+          forbid(start, stop);
         }
       }
     }
@@ -126,86 +1261,155 @@ std::deque<std::tuple<Island*, Island*, const Direction*>> Solver::
 // _____________________________________________________________________________
 
 bool Solver::tryGaps(std::deque<std::tuple<Island*, Island*,
-  const Direction*>>* newGaps,
-  std::unordered_multimap<Island*, Island*>* forbidden) {
+  const Direction*>>* newGaps) {
+  // The gaps forbidden on this level haven't been analyzed by
+  // eliminateObvious yet
+  size_t levelStart = _trail.levelStart();
+  // The table is only needed once the search has to guess
+  createTable();
   // Consume all gaps in the deque
   while (!newGaps->empty()) {
+    if (_statistics.nodes >= _nodeLimit) {
+      _expired = true;
+    }
+    // Giving up or starting over fails every node up to the root at once
+    if (expired() || _statistics.nodes >= _restartNodes) {
+      _restarting = !_expired;
+      _aborts++;
+      _conflict.clear();
+      return false;
+    }
+    if (_pool != nullptr) {
+      if (_pool->stopped()) {
+        // Another worker found a solution
+        _aborts++;
+        _conflict.clear();
+        return false;
+      }
+      if (newGaps->size() > 1 && _pool->hungry()) {
+        splitGaps(newGaps);
+      }
+    }
     const auto &entry = newGaps->front();
     Island* start = std::get<0>(entry);
     Island* stop = std::get<1>(entry);
     Bridge* oldBridge = nullptr;
     Bridge* newBridge = _game->connect(start, stop, false, &oldBridge);
+    NogoodStore::Literal decision = { Game::edgeId(start, stop),
+      Game::multiplicity(newBridge) };
 
-    std::deque<std::pair<Bridge*, Bridge*>> steps;
-    steps.push_back({newBridge, oldBridge});
-    if (solve(*newGaps, *forbidden, &steps)) {
+    _statistics.decisions++;
+    enqueueForbidden(levelStart);
+    enqueueAffected(newBridge);
+    _trail.openLevel();
+    _trail.push(newBridge, oldBridge);
+    clearFacts();
+    explain();
+    // A state that is known to fail doesn't need to be searched again
+    uint64_t state = _game->hash();
+    bool known = false;
+    if (_table) {
+      known = _table->contains(state);
+      if (known) {
+        _statistics.tableHits++;
+      } else {
+        _statistics.tableMisses++;
+      }
+    }
+    uint64_t aborts = _aborts;
+    if (!known && solve(*newGaps)) {
       // Solved, hooray
-      deleteReplacedBridges(&steps);
       return true;
     }
     // That didn't work, abort
-    revertSteps(&steps);
+    _statistics.backtracks++;
+    size_t level = _trail.level();
+    if (known) {
+      // The table doesn't know why, so every decision may matter
+      _conflict.clear();
+      for (uint32_t other = 1; other <= level; other++) {
+        _conflict.push_back(other);
+      }
+    } else if (_table && _aborts == aborts && _solutions == 0) {
+      // Once a solution has been counted, a failure may be due to gaps
+      // forbidden for having been counted already
+      _table->insert(state);
+    }
+    revertLevel();
     newGaps->pop_front();
-    forbidden->insert(std::make_pair(start, stop));
+    auto own = std::find(_conflict.begin(), _conflict.end(), level);
+    if (own == _conflict.end()) {
+      // The failure doesn't depend on this decision, so every other gap
+      // fails the same way, the conflict is handed up unchanged
+      _statistics.backjumps++;
+      return false;
+    }
+    _conflict.erase(own);
+    if (_solutions == 0) {
+      learn(decision);
+    }
+    // The remaining decisions of the conflict rule the gap out
+    clearFacts();
+    for (uint32_t other : _conflict) {
+      addFact(_trail.levelStart(other));
+    }
+    forbid(start, stop);
   }
+  analyzeExhaustion();
   return false;
 }
 
 // _____________________________________________________________________________
 
-void Solver::revertSteps(std::deque<std::pair<Bridge*, Bridge*>>* steps) {
-  while (!steps->empty()) {
-    auto bridgePair = steps->back();
-    steps->pop_back();
-    _game->disconnect(bridgePair.first);
-    delete bridgePair.first;
-    if (bridgePair.second != nullptr) {
-      // Old bridge was replaced, reattach it to the Game
-      _game->reconnect(bridgePair.second);
+void Solver::revertLevel() {
+  while (!_trail.isLevelEmpty()) {
+    size_t position = _trail.size() - 1;
+    Trail::Entry entry = _trail.pop();
+    if (position + 1 < _reasonStarts.size()) {
+      if (entry.kind == Trail::Kind::CONNECTION) {
+        _bridgeEntries[Game::edgeId(entry.bridge)] = _previousEntries[position];
+      } else {
+        _domainEntries[entry.edge] = _previousEntries[position];
+        if (entry.kind == Trail::Kind::FORBIDDEN) {
+          _forbidEntries[entry.edge] = NONE;
+        }
+      }
+      _reasonStarts.pop_back();
+      _reasons.resize(_reasonStarts.back());
     }
-  }
-}
-
-// _____________________________________________________________________________
-
-int8_t SmartConnector::maxBandwidthRegardingForbidden(Island* one, Island* two,
-  const std::unordered_multimap<Island*, Island*> &forbidden) const {
-  auto iterators = forbidden.equal_range(one);
-  for (auto it = iterators.first; it != iterators.second; it++) {
-    if (it->second == two) {
-      return 0;
+    if (entry.kind != Trail::Kind::CONNECTION) {
+      _domains.assign(entry.edge, entry.domain);
+      if (entry.kind == Trail::Kind::FORBIDDEN) {
+        _forbidden.erase(entry.edge);
+      }
+      continue;
     }
+    if (entry.replaced != nullptr) {
+      // Old bridge was replaced, reattach it to the Game
+      _game->replace(entry.bridge, entry.replaced);
+    } else {
+      _game->disconnect(entry.bridge);
+    }
+    _game->recycle(entry.bridge);
   }
-  return _game->maxBandwidth(one, two);
+  _trail.closeLevel();
 }
 
 // _____________________________________________________________________________
 
-std::pair<Island*, int8_t> SmartConnector::createPair(Island* one, Island* two,
-  const std::unordered_multimap<Island*, Island*> &forbidden) const {
-  return {_island == one ? two : one,
-    maxBandwidthRegardingForbidden(one, two, forbidden)};
-}
-
 const std::vector<std::pair<Island*, int8_t>> SmartConnector::createNeighbours(
-  const std::unordered_multimap<Island*, Island*> &forbidden) const {
+  const Domains &domains) const {
   std::vector<std::pair<Island*, int8_t>> result;
-  Island* north = _game->findAccessibleIsland(*_island, Direction::UP);
-  Island* east = _game->findAccessibleIsland(*_island, Direction::RIGHT);
-  Island* south = _game->findAccessibleIsland(*_island, Direction::DOWN);
-  Island* west = _game->findAccessibleIsland(*_island, Direction::LEFT);
-
-  if (north != nullptr) {
-    result.push_back(createPair(north, _island, forbidden));
-  }
-  if (east != nullptr) {
-    result.push_back(createPair(_island, east, forbidden));
-  }
-  if (south != nullptr) {
-    result.push_back(createPair(_island, south, forbidden));
-  }
-  if (west != nullptr) {
-    result.push_back(createPair(west, _island, forbidden));
+  result.reserve(4);
+  for (const Direction* direction : Direction::ALL) {
+    uint32_t edge = _game->neighbourGap(*_island, *direction);
+    if (edge == UINT32_MAX) {
+      continue;
+    }
+    auto ends = _game->edgeIslands(edge);
+    int8_t bandwidth = domains.max(edge) - _island->multiplicity(*direction);
+    result.push_back({ ends.first == _island ? ends.second : ends.first,
+      bandwidth });
   }
   return result;
 }
@@ -213,13 +1417,12 @@ const std::vector<std::pair<Island*, int8_t>> SmartConnector::createNeighbours(
 // _____________________________________________________________________________
 
 SmartConnector::SmartConnector(Game* game, Island* island,
-  const std::unordered_multimap<Island*, Island*> &forbidden):
-  _island(island), _game(game), _neighbours(createNeighbours(forbidden)) {}
+  const Domains &domains):
+  _island(island), _game(game), _neighbours(createNeighbours(domains)) {}
 
 // _____________________________________________________________________________
 
-bool SmartConnector::connectSmart(int8_t conn,
-  std::deque<std::pair<Bridge*, Bridge*>>* steps) const {
+bool SmartConnector::connectSmart(int8_t conn, Trail* trail) const {
   int8_t sum = availableConnections();
   int8_t diff = sum - conn;
   if (diff < 0) {
@@ -236,7 +1439,7 @@ bool SmartConnector::connectSmart(int8_t conn,
           Bridge* oldBridge = nullptr;
           Bridge* newBridge = _game->connect(_island, neighbour.first,
             neighbour.second == 2, &oldBridge);
-          steps->push_back({newBridge, oldBridge});
+          trail->push(newBridge, oldBridge);
         }
       }
       return !_game->isPartOfDisjunctGroup(_island);
@@ -246,8 +1449,8 @@ bool SmartConnector::connectSmart(int8_t conn,
       // a double bridge would be possible
       for (const auto &neighbour : _neighbours) {
         if (neighbour.second == 2) {
-          steps->push_back({ _game->connect(_island, neighbour.first, false),
-            nullptr });
+          trail->push(_game->connect(_island, neighbour.first, false),
+            nullptr);
           somethingChangedCase1 = true;
         }
       }
@@ -257,7 +1460,7 @@ bool SmartConnector::connectSmart(int8_t conn,
         break;
       }
     case 2:
-      reversedFindConnection(conn, steps);
+      reversedFindConnection(conn, trail);
       break;
   }
   return true;
@@ -265,12 +1468,12 @@ bool SmartConnector::connectSmart(int8_t conn,
 
 // _____________________________________________________________________________
 
-void SmartConnector::reversedFindConnection(int8_t conn,
-  std::deque<std::pair<Bridge*, Bridge*>>* steps) const {
+void SmartConnector::reversedFindConnection(int8_t conn, Trail* trail)
+  const {
   for (const auto &island : findReverseConnectIslands(conn)) {
     Bridge* oldBridge = nullptr;
     Bridge* newBridge = _game->connect(_island, island, false, &oldBridge);
-    steps->push_back({ newBridge, oldBridge});
+    trail->push(newBridge, oldBridge);
   }
 }
 
@@ -308,6 +1511,32 @@ std::vector<Island*> SmartConnector::findReverseConnectIslands(int8_t conn)
 
 // _____________________________________________________________________________
 
+int8_t SmartConnector::openGaps() const {
+  int8_t count = 0;
+  for (const auto &pair : _neighbours) {
+    count += pair.second != 0;
+  }
+  return count;
+}
+
+// _____________________________________________________________________________
+
+bool SmartConnector::needsConnectivity(int8_t conn) const {
+  int8_t diff = availableConnections() - conn;
+  if (diff == 1) {
+    // Unless there is a gap that takes a double bridge
+    for (const auto &neighbour : _neighbours) {
+      if (neighbour.second == 2) {
+        return false;
+      }
+    }
+    return true;
+  }
+  return diff == 2;
+}
+
+// _____________________________________________________________________________
+
 int8_t SmartConnector::availableConnections() const {
   int8_t sum = 0;
   for (const auto &pair : _neighbours) {
@@ -7,76 +7,558 @@
 #include <vector>
 #include <utility>
 #include <tuple>
-#include <unordered_map>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <random>
 #include "./Game.h"
+#include "./Trail.h"
+#include "./EdgeSet.h"
+#include "./WorkQueue.h"
+#include "./SearchPool.h"
+#include "./NogoodStore.h"
+#include "./TranspositionTable.h"
+#include "./CutEdges.h"
+#include "./Domains.h"
 
 // _____________________________________________________________________________
 
 // Main class to solve a game instance
 class Solver {
   FRIEND_TEST(SolverTest, constructor);
-  FRIEND_TEST(SolverTest, revertSteps);
+  FRIEND_TEST(SolverTest, revertLevel);
   FRIEND_TEST(SolverTest, eliminateObvious);
   FRIEND_TEST(SolverTest, extractValidGaps);
   FRIEND_TEST(SolverTest, solvePrivate);
   FRIEND_TEST(SolverTest, tryGaps);
+  FRIEND_TEST(SolverTest, orderGaps);
+  FRIEND_TEST(SolverTest, splitGaps);
+  FRIEND_TEST(SolverTest, cancelled);
+  FRIEND_TEST(SolverTest, explain);
+  FRIEND_TEST(SolverTest, backjump);
+  FRIEND_TEST(SolverTest, checkNogoods);
+  FRIEND_TEST(SolverTest, connectCuts);
+  FRIEND_TEST(SolverTest, narrowDomains);
+  FRIEND_TEST(SolverTest, countSolution);
+  FRIEND_TEST(SolverTest, collectSolution);
+  FRIEND_TEST(SolverTest, expired);
+  FRIEND_TEST(SolverTest, restartInterval);
+  FRIEND_TEST(SolverTest, orderGapsRandomly);
+
+ public:
+  // The order in which the remaining gaps are tried at every node of the
+  // search. INPUT keeps the order they have been collected in, the others
+  // prefer the gaps at the Island with the least slack between the
+  // connections it could make and the ones it needs, with the fewest
+  // gaps left or with the most gaps left. Ties are broken by the
+  // remaining capacity of both Islands, the smaller one first
+  enum class Branching { INPUT, MOST_CONSTRAINED, FEWEST_OPTIONS, MAX_DEGREE };
+
+  // Counters of the last search
+  struct Statistics {
+    // how many nodes of the search tree have been visited
+    uint64_t nodes;
+    // how many gaps have been tried
+    uint64_t decisions;
+    // how many of those gaps had to be reverted again
+    uint64_t backtracks;
+    // how many times the remaining gaps of a node have been skipped,
+    // because the failure of a gap didn't depend on it
+    uint64_t backjumps;
+    // how many nogoods have been learned
+    uint64_t nogoods;
+    // how many gaps have been forbidden and branches cut off by nogoods
+    uint64_t prunes;
+    // how many decisions led to a state the transposition table knew to
+    // fail and how many to one it didn't know
+    uint64_t tableHits;
+    uint64_t tableMisses;
+    // how many bridges have been made because their gap was the only
+    // way left to connect two parts of the board
+    uint64_t cuts;
+    // how many times the search started over
+    uint64_t restarts;
+  };
+
+  // When the search starts over from the root: never, after node counts
+  // that follow the Luby sequence 1, 1, 2, 1, 1, 2, 4, ... or after node
+  // counts that grow by half each time, in units of a number of nodes
+  enum class Restarts { NONE, LUBY, GEOMETRIC };
+
+  // How many nodes the shortest run between two restarts visits by
+  // default
+  static const uint64_t RESTART_UNIT = 100;
+
+  // A solution as the list of the gaps that have bridges, see Game::EdgeList
+  typedef Game::EdgeList Solution;
+
+  // How the last search ended: with a solution, with the proof that
+  // there is none or by giving up at the deadline, the node limit or
+  // because it has been cancelled
+  enum class Status { SOLVED, UNSOLVABLE, TIMED_OUT };
+
+  // How many bytes the learned nogoods may occupy by default
+  static const size_t DEFAULT_NOGOOD_BUDGET = 4 << 20;
+
+  // How many bytes the transposition table occupies by default
+  static const size_t DEFAULT_TABLE_MEMORY = 256 << 10;
+
+ private:
+  // marks a trail position that doesn't exist
+  static const uint32_t NONE = UINT32_MAX;
+
+  // how many checks for giving up read the clock once, so checking
+  // costs next to nothing
+  static const uint32_t CLOCK_INTERVAL = 32;
+
   // store the game instance
   Game* const _game;
+  // the order of the gaps
+  const Branching _branching;
+  // counters of the last search
+  Statistics _statistics = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+  // rank of every Island for the branching strategy, only up to date
+  // for the Islands of the gaps that are being ordered
+  std::vector<int> _ranks;
+  // every connection made, every gap forbidden and every domain narrowed
+  // during the search, reserved once for the deepest possible search so
+  // backtracking never allocates
+  Trail _trail;
+  // the gaps that are guaranteed to be wrong in the current branch
+  // of the search
+  EdgeSet _forbidden;
+  // the amounts of bridges every gap may still end up with in the
+  // current branch of the search
+  Domains _domains;
+  // the indices of the Islands that need to be analyzed again by
+  // eliminateObvious, because their surroundings changed
+  WorkQueue _queue;
+  // buffer for Game#findAffectedIslands, reused for every Bridge
+  std::vector<Island*> _affected;
+  // the gap to the nearest Island in every direction and the index of
+  // that Island, 4 entries per Island ordered by the direction index,
+  // NONE if there is no Island in a direction
+  std::vector<uint32_t> _islandGaps;
+  std::vector<uint32_t> _islandNeighbours;
+  // the facts, i.e. trail positions, every entry of the trail has been
+  // derived from: the ones of entry i are _reasons[_reasonStarts[i]] up
+  // to, but excluding, _reasons[_reasonStarts[i + 1]]. Only the entries
+  // below _reasonStarts.size() - 1 have been explained
+  std::vector<uint32_t> _reasons;
+  std::vector<size_t> _reasonStarts;
+  // the highest decision level every explained entry depends on,
+  // decisions depend on their own level
+  std::vector<uint32_t> _depths;
+  // the entry every connection on the trail has added a bridge to,
+  // or NONE
+  std::vector<uint32_t> _previousEntries;
+  // the entry that made the current bridge of every gap, NONE if the
+  // search didn't make it
+  std::vector<uint32_t> _bridgeEntries;
+  // the entry that forbade every gap, NONE if the search didn't
+  std::vector<uint32_t> _forbidEntries;
+  // the entry that narrowed the domain of every gap last, NONE if the
+  // search didn't. Domains are only narrowed from above, so the last
+  // narrowing alone explains the current domain. _previousEntries holds
+  // the one before for these entries
+  std::vector<uint32_t> _domainEntries;
+  // the facts the current step depends on, without duplicates
+  std::vector<uint32_t> _why;
+  // the highest depth of the facts in _why
+  uint32_t _whyDepth = 0;
+  // the decision levels the last failure depends on
+  std::vector<uint32_t> _conflict;
+  // marks of the facts in _why, the Islands whose components have been
+  // added to it and the entries visited by analyze, an element is marked
+  // if it holds the current value of the counter of its vector
+  std::vector<uint32_t> _factMarks;
+  std::vector<uint32_t> _islandMarks;
+  std::vector<uint32_t> _visitMarks;
+  uint32_t _factMark = 0;
+  uint32_t _visitMark = 0;
+  // buffers for the gaps and entries that are visited by the analysis
+  std::vector<uint32_t> _stack;
+  std::vector<uint32_t> _crossing;
+  std::vector<uint32_t> _candidates;
+  std::vector<NogoodStore::Literal> _literals;
+  // how many bytes the nogoods of _nogoods may occupy
+  size_t _nogoodBudget = DEFAULT_NOGOOD_BUDGET;
+  // the nogoods learned during the current search
+  NogoodStore _nogoods;
+  // the states proven to fail, kept across searches, because whether a
+  // state of the Game can be solved doesn't depend on the search. Shared
+  // by the Solvers of a portfolio, nullptr for the workers of a parallel
+  // search, whose tasks assume their forbidden gaps to be wrong
+  std::shared_ptr<TranspositionTable> _table;
+  // how many bytes _table occupies once it is needed
+  size_t _tableMemory = DEFAULT_TABLE_MEMORY;
+  // the other Island of every gap that has a bridge or could still take
+  // one, in the layout of _islandNeighbours, and the cut edges of that
+  // graph
+  std::vector<uint32_t> _slots;
+  CutEdges _cutEdges;
+  // how many times the search gave up on a node without proving that it
+  // fails, such nodes must not be stored in _table
+  uint64_t _aborts = 0;
+  // the pool this Solver works for during a parallel search, nullptr
+  // during a sequential one
+  SearchPool* _pool = nullptr;
+  // the index of the worker in _pool
+  size_t _worker = 0;
+  // set by another thread to make the search give up, nullptr if the
+  // search can't be cancelled. _cancelled belongs to the portfolio this
+  // Solver races in, _cancellation to the caller
+  const std::atomic<bool>* _cancelled = nullptr;
+  const std::atomic<bool>* _cancellation = nullptr;
+  // the search gives up once this time has passed or once it has visited
+  // this many nodes
+  std::chrono::steady_clock::time_point _deadline =
+    std::chrono::steady_clock::time_point::max();
+  uint64_t _nodeLimit = UINT64_MAX;
+  // how many times expired has been called since it read the clock
+  uint32_t _clockChecks = 0;
+  // set once the search has given up, until the next search starts
+  bool _expired = false;
+  // how the last search ended
+  Status _status = Status::UNSOLVABLE;
+  // when the search starts over, the search of the current run starts
+  // over once it has visited _restartNodes nodes in total, and
+  // _restarting is set while the nodes of the run are given up on
+  Restarts _restarts = Restarts::NONE;
+  uint64_t _restartUnit = RESTART_UNIT;
+  uint64_t _restartNodes = UINT64_MAX;
+  bool _restarting = false;
+  // breaks ties of the branching strategy while restarts are enabled,
+  // seeded with _seed at the start of every search
+  std::mt19937 _random;
+  uint32_t _seed = 0;
+  // how many solutions the search stops at and how many it has found
+  uint64_t _limit = 1;
+  uint64_t _solutions = 0;
+  // the first solution found while counting, the search goes on past it
+  std::unique_ptr<GameSnapshot> _firstSolution;
+  // called with every solution found during an enumeration instead of
+  // keeping the first one, nullptr otherwise
+  const std::function<bool(const Solution&)>* _visitor = nullptr;
+  // buffer for the solution handed to _visitor, reused for every one
+  Solution _solution;
+
+  // Counts the solution the game is in, returns true if that reaches
+  // _limit. Otherwise the search goes on as if the node failed because
+  // of every decision: the gaps forbidden afterwards stand for
+  // solutions that have been counted, not for failures
+  bool countSolution();
+
+  // Fills _solution with the bridges of the game
+  void collectSolution();
+
+  // Searches for solutions with the bridges of the game until the given
+  // amount has been found, see countSolutions, and returns how many
+  // have been found
+  uint64_t enumerate(uint64_t);
+
+  // Returns true if the search has to give up, because it has been
+  // cancelled or the deadline has passed, and remembers that in _expired.
+  // Only every CLOCK_INTERVAL-th call reads the clock
+  bool expired();
+
+  // Returns the element of the Luby sequence 1, 1, 2, 1, 1, 2, 4, 1, ...
+  // at the given position, starting at 0
+  static uint64_t luby(uint64_t);
+
+  // Returns how many nodes the run of the search with the given number,
+  // starting at 0, may visit before it starts over
+  uint64_t restartInterval(uint64_t) const;
+
+  // Returns every gap of the game that could currently take a bridge
+  std::deque<std::tuple<Island*, Island*, const Direction*>> collectGaps()
+    const;
+
+  // Splits every gap but the first one off into a task of the pool and
+  // removes them from the deque, the task forbids the first gap
+  void splitGaps(std::deque<std::tuple<Island*, Island*, const Direction*>>*);
+
+  // Searches the subtree of the task on the game of this Solver, returns
+  // true if it contains a solution
+  bool solveTask(const SearchTask&);
+
+  // Queues every Island of the game
+  void enqueueAll();
+
+  // Queues the Islands whose possible connections are changed by the
+  // given connected Bridge
+  void enqueueAffected(const Bridge*);
+
+  // Queues both Islands of every forbidden gap on the trail from the
+  // given position on
+  void enqueueForbidden(size_t);
+
+  // Returns the rank of the Island for the branching strategy,
+  // gaps at Islands with lower ranks are tried first
+  int rankIsland(Island*) const;
+
+  // Sorts the gaps for the branching strategy, gaps with the same
+  // rank keep their order, or end up in a random order while restarts
+  // are enabled
+  void orderGaps(std::deque<std::tuple<Island*, Island*, const Direction*>>*);
+
+  // Forbids the gap between the two Islands for the rest of the current
+  // decision level and records that on the trail, justified by the
+  // facts in _why
+  void forbid(Island*, Island*);
+
+  // Removes all entries from the trail and forgets their reasons
+  void clearTrail();
+
+  // Returns the amount of bridges in the gap with the given id
+  int8_t gapBridges(uint32_t) const;
+
+  // Returns true if a bridge could be connected in the gap with the given
+  // id, i.e. no bridge crosses it
+  bool isAccessible(uint32_t) const;
+
+  // Empties _why to collect the facts of the next step
+  void clearFacts();
+
+  // Adds the entry at the given trail position to _why, unless it is
+  // NONE or already part of it
+  void addFact(uint32_t);
+
+  // Adds the entries that made the bridges of the Island to _why
+  void addBridgeFacts(const Island*);
+
+  // Adds the entries that made the bridges crossing the gap with the
+  // given id to _why
+  void addCrossingFacts(uint32_t);
+
+  // Adds the entries that made the bridges of the component of the
+  // Island to _why, i.e. everything its closedness depends on
+  void addComponentFacts(const Island*);
+
+  // Adds the entries Game#maxBandwidth of the two Islands depends on
+  // to _why, the 3rd parameter is the id of their gap
+  void addBandwidthFacts(Island*, Island*, uint32_t);
+
+  // Adds the entries the possible connections of the Island depend on
+  // to _why, apart from the connectivity of the Islands: its bridges,
+  // the ones of its neighbours and the narrowings of the domains of
+  // its gaps
+  void addIslandFacts(Island*);
+
+  // Adds the entries to _why that keep every gap of the Island from
+  // taking another bridge, returns false if one of the gaps still could
+  bool addCappedFacts(Island*);
+
+  // Returns true if the gap with the given id could still take a bridge
+  // as far as its Islands, the forbidden gaps and crossing bridges are
+  // concerned
+  bool isOpen(uint32_t) const;
+
+  // Adds the entries to _why that keep the gap with the given id, which
+  // has no bridge, from taking one according to isOpen
+  void addClosedFacts(uint32_t);
+
+  // Looks at the graph of the gaps that have a bridge or are open. A
+  // solution connects all Islands, so the search fails if that graph
+  // isn't connected, and every cut edge of it needs a bridge, which is
+  // made. Returns false if the graph isn't connected
+  bool connectCuts();
+
+  // Narrows the domain of the gap with the given id to at most the given
+  // amount of bridges and records that on the trail, justified by the
+  // facts in _why
+  void narrow(uint32_t, int8_t);
+
+  // Narrows the domains of the gaps of the Island to the bridges they
+  // have plus the connections the Island is missing
+  void narrowCapacity(Island*);
+
+  // Narrows the domain of every gap of the Island that could take all
+  // connections both of its Islands are missing, if that would close a
+  // group of Islands, and queues the Islands of such gaps
+  void narrowConnectivity(Island*);
+
+  // Narrows the domains the connections on the trail from the given
+  // position on affect: the gaps they cross and the gaps of their Islands
+  void narrowDomains(size_t);
+
+  // Records _why as the reason of every entry on the trail that hasn't
+  // been explained yet and remembers which entries made the bridges and
+  // forbade the gaps or narrowed the domains. Decisions only depend on
+  // the bridge they add to
+  void explain();
+
+  // Collects the decision levels the facts in _why depend on in _conflict
+  void analyze();
+
+  // Collects the decision levels in _conflict that the failure of the
+  // current node depends on after all of its gaps failed. The node fails
+  // because an Island still misses connections none of its gaps can
+  // take, of all such Islands the one that depends on the lowest
+  // decision levels is picked
+  void analyzeExhaustion();
+
+  // Creates _table with _tableMemory bytes unless it exists already
+  void createTable();
+
+  // Checks the nogoods watching the gaps of the connections on the
+  // trail from the given position on. A nogood with all but one
+  // literal satisfied forbids the gap of the last one if it misses just
+  // one more bridge, returns false if a nogood is satisfied completely
+  bool checkNogoods(size_t);
+
+  // Learns the decisions of _conflict together with the given literal
+  // of the decision that has just failed as a nogood
+  void learn(const NogoodStore::Literal&);
 
   // cheap solving function that tries to use simple
-  // tricks to solve the game, stricly ignores connections
-  // that are pointed out in the first parameter,
-  // stores the individual steps in the second parameter
-  bool eliminateObvious(const std::unordered_multimap<Island*, Island*>&,
-    std::deque<std::pair<Bridge*, Bridge*>>*);
+  // tricks to solve the game, stricly ignores forbidden connections,
+  // records the individual steps on the trail.
+  // Only analyzes the queued Islands, every connection queues the Islands
+  // it affects, so it stops once the queue is empty
+  bool eliminateObvious();
 
-  // function to revert the provided steps deque in order to try a different
-  // step if the last step and following didn't work out so well
-  void revertSteps(std::deque<std::pair<Bridge*, Bridge*>>*);
+  // function to revert all steps and forbidden gaps of the current decision
+  // level of the trail and to close it in order to try a different step
+  // if the last step and following didn't work out so well
+  void revertLevel();
 
   // internal function to try to solve the given game instance recursively
   // does only try gaps in the given deque in order to reduce the tree
   // of possible combinations
-  // The first parameter contains the connections that remain that
+  // The parameter contains the connections that remain that
   // still need to be tried
-  // The second parameter contains the forbidden connections that
-  // should be strictly ignored in order to improve performance by a lot
-  // by not trying connections that are guaranteed to be wrong twice.
-  // All individual steps are stored in the third parameter
+  // Forbidden connections are strictly ignored in order to improve
+  // performance by a lot by not trying connections that are guaranteed
+  // to be wrong twice.
+  // All individual steps are recorded on the trail
   bool solve(
-    const std::deque<std::tuple<Island*, Island*, const Direction*>>&,
-    const std::unordered_multimap<Island*, Island*>&,
-    std::deque<std::pair<Bridge*, Bridge*>>*);
+    const std::deque<std::tuple<Island*, Island*, const Direction*>>&);
 
   // Checks if the passed Island Gaps steps can still be made
   // without a logical contradiction i.e. an unsolvable Game
   // if the steps cannot be made, they are not in the returned
   // deque, this is to massively cut down the tree of possible
   // combinations
-  // Only processes the connections "in" the first parameter
-  // and adds all connections that don't make it into
-  // the return value into the second parameter
+  // Only processes the connections "in" the parameter
+  // and forbids all connections that don't make it into
+  // the return value
   std::deque<std::tuple<Island*, Island*, const Direction*>>
     extractValidGaps(const std::deque<std::tuple<Island*, Island*,
-    const Direction*>>&, std::unordered_multimap<Island*, Island*>*) const;
+    const Direction*>>&);
 
   // Tries the gaps between the islands in the tuple of the passed deque
   // recursively, if a solution can be made this way, the function
   // returns true, false if a logical contradiction occurs
-  // The first parameter indicates which connections still need to be processed
-  // The if any steps are encountered that don't work, they are filled
-  // into the second parameter
-  bool tryGaps(std::deque<std::tuple<Island*, Island*, const Direction*>>*,
-  std::unordered_multimap<Island*, Island*>*);
+  // The parameter indicates which connections still need to be processed
+  // The if any steps are encountered that don't work, they are forbidden
+  bool tryGaps(std::deque<std::tuple<Island*, Island*, const Direction*>>*);
 
  public:
-  // constructs a Solver object using a given game state
-  explicit Solver(Game* game): _game(game) {}
+  // constructs a Solver object using a given game state and
+  // the given order of the gaps
+  explicit Solver(Game*, Branching = Branching::INPUT);
+
+  // Returns the branching strategy with the given name, see
+  // branchingName, returns false if there is none
+  static bool parseBranching(const std::string&, Branching*);
+
+  // Returns the name of the branching strategy for the command line
+  static const char* branchingName(Branching);
+
+  // Returns the restart strategy with the given name, see restartsName,
+  // returns false if there is none
+  static bool parseRestarts(const std::string&, Restarts*);
+
+  // Returns the name of the restart strategy for the command line
+  static const char* restartsName(Restarts);
+
+  // Returns the counters of the last search
+  const Statistics& statistics() const;
+
+  // Sets how many bytes the nogoods learned by the search may occupy,
+  // 0 learns none. Conflicts are analyzed either way, so the search
+  // still jumps back over decisions a failure doesn't depend on
+  void setNogoodBudget(size_t);
+
+  // Replaces the transposition table by an empty one that occupies at
+  // most the given amount of bytes, 0 disables it
+  void setTableMemory(size_t);
+
+  // Makes every following search give up once the given time has passed,
+  // time_point::max() never gives up
+  void setDeadline(std::chrono::steady_clock::time_point);
+
+  // Makes every following search give up instead of visiting more than
+  // the given amount of nodes, 0 never gives up. Every thread of a
+  // parallel search has the whole amount
+  void setNodeLimit(uint64_t);
+
+  // Makes every following search give up as soon as another thread sets
+  // the given flag, nullptr can't be cancelled
+  void setCancellation(const std::atomic<bool>*);
+
+  // Makes every following search start over from the root on the given
+  // schedule, whose unit is the given amount of nodes, until it finds a
+  // solution or proves there is none. The nogoods, the transposition table
+  // and the gaps forbidden before the first decision are kept, and ties of
+  // the branching strategy are broken randomly, so every run tries
+  // different gaps first. Counting solutions never starts over
+  void setRestarts(Restarts, uint64_t = RESTART_UNIT);
+
+  // Sets the seed of the random tie-breaking, every search with the same
+  // seed makes the same decisions
+  void setSeed(uint32_t);
+
+  // Returns how the last search ended. A search that gave up has undone
+  // all of its decisions, so the game holds the bridges propagation made
+  // before the first one, unless it was a parallel search, which leaves
+  // the game as it was
+  Status status() const;
+
   // public method which modifies the given game state
   // and returns true if a solution could be found
   // and false otherwise calls an internal function with the same name
   // with generated arguments in order to start
   bool solve();
+
+  // Like solve, but goes on searching after a solution until the given
+  // amount of solutions has been found, 0 finds all of them, and returns
+  // how many there are up to that amount, e.g. 2 tells whether the
+  // solution is unique. Only solutions with the bridges the game already
+  // has count. All propagation is the same as for solve, only nothing is
+  // learned or stored in the transposition table once a solution has
+  // been counted. The first solution found is copied into the game. If
+  // the search gives up, see status, more solutions may exist
+  uint64_t countSolutions(uint64_t);
+
+  // Like countSolutions without a limit, but hands every solution to the
+  // given function as soon as it has been found instead of keeping one.
+  // The search holds nothing but its current branch, so the memory stays
+  // the same no matter how many solutions there are. The function
+  // returns false to stop the search, the game then holds that solution,
+  // otherwise it ends up with the bridges that are forced before the
+  // first decision, like after a failed solve. Returns how many
+  // solutions have been handed to the function
+  uint64_t enumerateSolutions(const std::function<bool(const Solution&)>&);
+
+  // Like solve, but searches with the given amount of threads, each on
+  // its own clone of the game. Whenever a thread runs out of work, the
+  // others split the remaining gaps of their current node off for it.
+  // The first solution found stops all threads and is copied into the
+  // game, the first thread that gives up stops them as well. The
+  // statistics are summed up over all threads
+  bool solveParallel(size_t);
+
+  // Races one Solver per given branching strategy against each other,
+  // each on its own thread and clone of the game. The first one to
+  // finish, no matter whether it found a solution or proved there is
+  // none, cancels the others, its solution is copied into the game and
+  // its statistics become the ones of this Solver. Its strategy is
+  // stored in the 2nd parameter. Without strategies this is solve
+  bool solvePortfolio(const std::vector<Branching>&, Branching*);
 };
 
 // _____________________________________________________________________________
@@ -84,8 +566,6 @@ class Solver {
 // A Helper class to do the 100% obligatory connections for the current Island
 class SmartConnector {
   FRIEND_TEST(SmartConnectorTest, constructor);
-  FRIEND_TEST(SmartConnectorTest, maxBandwidthRegardingForbidden);
-  FRIEND_TEST(SmartConnectorTest, createPair);
   FRIEND_TEST(SmartConnectorTest, createNeighbours);
   FRIEND_TEST(SmartConnectorTest, reversedFindConnection);
   FRIEND_TEST(SmartConnectorTest, findReverseConnectIslands);
@@ -93,25 +573,16 @@ class SmartConnector {
   Island* const _island;
   // The game to operate on
   Game* const _game;
-  // A vector of all reachable neighbours and their maximum
+  // A vector of all neighbours and their maximum
   // amount of connections they can make with the current island
   const std::vector<std::pair<Island*, int8_t>> _neighbours;
 
-  // Returns 0 if this island combination is part of the provided 3rd parameter
-  // Returns Game#maxBandwidth(Island*, Island*) otherwise
-  int8_t maxBandwidthRegardingForbidden(Island*, Island*,
-    const std::unordered_multimap<Island*, Island*>&) const;
-
-  // Creates a pair entry to push to _neighbours based on the Island
-  // combination and their value calculated by maxBandwidthRegardingForbidden
-  std::pair<Island*, int8_t> createPair(Island*, Island*,
-    const std::unordered_multimap<Island*, Island*>&) const;
-
   // Creates a neighbour vector to initialize the member variable of this class
   // creates a pair for every neighbour Island and pushes it to the resulting
-  // vector
+  // vector, the maximum amount of connections is read from the domain
+  // of their gap
   const std::vector<std::pair<Island*, int8_t>> createNeighbours(
-    const std::unordered_multimap<Island*, Island*>&) const;
+    const Domains&) const;
 
   // A special tactic to find obligatory connections.
   // If all remaining connections were made to all other neighbours
@@ -119,9 +590,8 @@ class SmartConnector {
   // must be to the current neighbour
   // The first parameter is an optimization, so the current amount
   // of missing connections doesn't need to be calculated multiple times
-  // Steps are filled into the second parameter
-  void reversedFindConnection(int8_t, std::deque<std::pair<Bridge*, Bridge*>>*)
-    const;
+  // Steps are recorded on the trail in the second parameter
+  void reversedFindConnection(int8_t, Trail*) const;
 
   // Helper function that finds all Islands that need to be connected to this
   // Islands for reversedFindConnection
@@ -131,21 +601,32 @@ class SmartConnector {
 
  public:
   // Constructor, 1st the game instance to be modified, 2nd the Island
-  // to be analyzed and made connections to, 3rd the forbidden connections
-  SmartConnector(Game*, Island*,
-    const std::unordered_multimap<Island*, Island*>&);
+  // to be analyzed and made connections to, 3rd the domains of the gaps
+  SmartConnector(Game*, Island*, const Domains&);
 
   // Connects the current island with neighbour Islands if the connection
   // must be made in any case
   // The first parameter is an optimization, so the current amount
   // of missing connections doesn't need to be calculated multiple times
-  // The second parameter is filled with steps that are being made during
-  // this function call
-  bool connectSmart(int8_t, std::deque<std::pair<Bridge*, Bridge*>>*) const;
+  // The steps that are being made during this function call are recorded
+  // on the trail in the second parameter
+  bool connectSmart(int8_t, Trail*) const;
 
   // Returns how many connections the current Island could currently make
   // regardless of how many it should have in the end
   int8_t availableConnections() const;
+
+  // Returns to how many neighbours the current Island could currently
+  // make a connection
+  int8_t openGaps() const;
+
+  // Returns true if the connections connectSmart makes for the given
+  // amount of missing connections depend on which Islands are connected
+  // to each other, i.e. if they can only be found by
+  // reversedFindConnection. Whether the Island ends up in a closed group
+  // itself isn't covered, neither are domains that have been narrowed
+  // to avoid closed groups. Has to be called before connectSmart
+  bool needsConnectivity(int8_t) const;
 };
 
 #endif  // SOLVER_H_
@@ -1,37 +1,362 @@
 #include <iostream>
+#include <atomic>
 #include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
 #include <string>
+#include <vector>
 #include "./Solver.h"
+#include "./SatEngine.h"
 #include "./Game.h"
 #include "./GameParser.h"
 #include "./GamePrinter.h"
 
 // _____________________________________________________________________________
 
+// Prints how the solver is supposed to be called
+void printUsage(const char* program) {
+  std::cerr << "Usage: " << program << " [--branching=input|constrained"
+    << "|options|degree] [--threads=N | --portfolio=NAME,NAME,...]"
+    << " [--engine=native|sat] [--dimacs=/path/to/cnf]"
+    << " [--nogood-memory=BYTES] [--table-memory=BYTES] [--count=N]"
+    << " [--enumerate] [--timeout=MILLISECONDS] [--node-limit=N]"
+    << " [--restarts=none|luby|geometric] [--seed=N]"
+    << " /path/to/input /path/to/output" << std::endl;
+}
+
+// _____________________________________________________________________________
+
+// Set by an interrupt (Ctrl+C) to make the search give up
+std::atomic<bool> interrupted(false);
+
+// Signal handler for SIGINT
+void interrupt(int) {
+  interrupted = true;
+}
+
+// _____________________________________________________________________________
+
+// Parses the comma separated branching strategies of a portfolio,
+// returns false if any of them is unknown
+bool parsePortfolio(const std::string &list,
+  std::vector<Solver::Branching>* portfolio) {
+  size_t start = 0;
+  while (start <= list.size()) {
+    size_t end = list.find(',', start);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    Solver::Branching branching;
+    if (!Solver::parseBranching(list.substr(start, end - start),
+      &branching)) {
+      std::cerr << "Unknown branching strategy '"
+        << list.substr(start, end - start) << "'" << std::endl;
+      return false;
+    }
+    portfolio->push_back(branching);
+    start = end + 1;
+  }
+  return true;
+}
+
+// _____________________________________________________________________________
+
 // Main solver function
 int main(int argc, char** argv) {
-  if (argc != 3) {
+  Solver::Branching branching = Solver::Branching::INPUT;
+  size_t threads = 1;
+  std::vector<Solver::Branching> portfolio;
+  bool sat = false;
+  std::string dimacsPath;
+  size_t nogoodBudget = Solver::DEFAULT_NOGOOD_BUDGET;
+  size_t tableMemory = Solver::DEFAULT_TABLE_MEMORY;
+  bool counting = false;
+  bool enumerating = false;
+  uint64_t timeout = 0;
+  uint64_t nodeLimit = 0;
+  Solver::Restarts restarts = Solver::Restarts::NONE;
+  uint32_t seed = 0;
+  uint64_t limit = 0;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    const std::string branchingFlag = "--branching=";
+    const std::string threadsFlag = "--threads=";
+    const std::string portfolioFlag = "--portfolio=";
+    const std::string engineFlag = "--engine=";
+    const std::string dimacsFlag = "--dimacs=";
+    const std::string nogoodFlag = "--nogood-memory=";
+    const std::string tableFlag = "--table-memory=";
+    const std::string countFlag = "--count=";
+    const std::string timeoutFlag = "--timeout=";
+    const std::string nodeLimitFlag = "--node-limit=";
+    const std::string restartsFlag = "--restarts=";
+    const std::string seedFlag = "--seed=";
+    if (argument.compare(0, branchingFlag.size(), branchingFlag) == 0) {
+      if (!Solver::parseBranching(argument.substr(branchingFlag.size()),
+        &branching)) {
+        std::cerr << "Unknown branching strategy '"
+          << argument.substr(branchingFlag.size()) << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, threadsFlag.size(), threadsFlag) == 0) {
+      const char* value = argument.c_str() + threadsFlag.size();
+      char* end = nullptr;
+      threads = std::strtoul(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || threads == 0) {
+        std::cerr << "Invalid amount of threads '" << value << "'"
+          << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, portfolioFlag.size(), portfolioFlag)
+      == 0) {
+      if (!parsePortfolio(argument.substr(portfolioFlag.size()),
+        &portfolio)) {
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, engineFlag.size(), engineFlag) == 0) {
+      std::string engine = argument.substr(engineFlag.size());
+      if (engine != "native" && engine != "sat") {
+        std::cerr << "Unknown engine '" << engine << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+      sat = engine == "sat";
+    } else if (argument.compare(0, dimacsFlag.size(), dimacsFlag) == 0) {
+      dimacsPath = argument.substr(dimacsFlag.size());
+    } else if (argument.compare(0, nogoodFlag.size(), nogoodFlag) == 0) {
+      const char* value = argument.c_str() + nogoodFlag.size();
+      char* end = nullptr;
+      nogoodBudget = std::strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0') {
+        std::cerr << "Invalid nogood memory '" << value << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, tableFlag.size(), tableFlag) == 0) {
+      const char* value = argument.c_str() + tableFlag.size();
+      char* end = nullptr;
+      tableMemory = std::strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0') {
+        std::cerr << "Invalid table memory '" << value << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, countFlag.size(), countFlag) == 0) {
+      const char* value = argument.c_str() + countFlag.size();
+      char* end = nullptr;
+      limit = std::strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0') {
+        std::cerr << "Invalid amount of solutions '" << value << "'"
+          << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+      counting = true;
+    } else if (argument.compare(0, timeoutFlag.size(), timeoutFlag) == 0) {
+      const char* value = argument.c_str() + timeoutFlag.size();
+      char* end = nullptr;
+      timeout = std::strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || timeout == 0) {
+        std::cerr << "Invalid timeout '" << value << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, nodeLimitFlag.size(), nodeLimitFlag)
+      == 0) {
+      const char* value = argument.c_str() + nodeLimitFlag.size();
+      char* end = nullptr;
+      nodeLimit = std::strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || nodeLimit == 0) {
+        std::cerr << "Invalid node limit '" << value << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, restartsFlag.size(), restartsFlag) == 0) {
+      if (!Solver::parseRestarts(argument.substr(restartsFlag.size()),
+        &restarts)) {
+        std::cerr << "Unknown restart strategy '"
+          << argument.substr(restartsFlag.size()) << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+    } else if (argument.compare(0, seedFlag.size(), seedFlag) == 0) {
+      const char* value = argument.c_str() + seedFlag.size();
+      char* end = nullptr;
+      unsigned long long parsed = std::strtoull(value, &end, 10);
+      if (*value == '\0' || *end != '\0' || parsed > UINT32_MAX) {
+        std::cerr << "Invalid seed '" << value << "'" << std::endl;
+        printUsage(argv[0]);
+        return -1;
+      }
+      seed = static_cast<uint32_t>(parsed);
+    } else if (argument == "--enumerate") {
+      enumerating = true;
+      counting = true;
+    } else {
+      paths.push_back(argument);
+    }
+  }
+  if (threads > 1 && !portfolio.empty()) {
+    std::cerr << "A portfolio runs one thread per strategy, it can't be"
+      << " combined with --threads" << std::endl;
+    printUsage(argv[0]);
+    return -1;
+  }
+  if (sat && (threads > 1 || !portfolio.empty())) {
+    std::cerr << "The SAT engine runs on a single thread" << std::endl;
+    printUsage(argv[0]);
+    return -1;
+  }
+  if (counting && (sat || threads > 1 || !portfolio.empty())) {
+    std::cerr << "Counting solutions runs the native search on a single"
+      << " thread" << std::endl;
+    printUsage(argv[0]);
+    return -1;
+  }
+  if ((sat || threads > 1) && restarts != Solver::Restarts::NONE) {
+    std::cerr << "Only the native search on a single thread or a portfolio"
+      << " can start over" << std::endl;
+    printUsage(argv[0]);
+    return -1;
+  }
+  if (sat && (timeout != 0 || nodeLimit != 0)) {
+    std::cerr << "Only the native search can give up early" << std::endl;
+    printUsage(argv[0]);
+    return -1;
+  }
+  if (!sat && !dimacsPath.empty()) {
+    std::cerr << "Only the SAT engine can write DIMACS" << std::endl;
+    printUsage(argv[0]);
+    return -1;
+  }
+  if (paths.size() != 2) {
     std::cerr << "Missing arguments" << std::endl;
-    std::cerr << "Usage: " << argv[0] << " /path/to/input /path/to/output"
-      << std::endl;
+    printUsage(argv[0]);
     return -1;
   }
   try {
-    Game game = GameParser::autoParse(argv[1]);
+    Game game = GameParser::autoParse(paths[0]);
 
-    Solver solver(&game);
+    Solver solver(&game, branching);
+    solver.setNogoodBudget(nogoodBudget);
+    solver.setTableMemory(tableMemory);
+    solver.setNodeLimit(nodeLimit);
+    solver.setRestarts(restarts);
+    solver.setSeed(seed);
+    solver.setCancellation(&interrupted);
+    std::signal(SIGINT, interrupt);
     PlainPrinter plainPrinter(game);
     XYPrinter xyPrinter(game);
 
     auto start = std::chrono::high_resolution_clock::now();
-    bool solved = solver.solve();
+    if (timeout != 0) {
+      solver.setDeadline(std::chrono::steady_clock::now()
+        + std::chrono::milliseconds(timeout));
+    }
+    std::unique_ptr<SatEngine> engine;
+    bool solved;
+    uint64_t solutions = 0;
+    if (enumerating) {
+      // Every solution goes to the file right away, none is kept
+      std::string path = paths[1] + ".xy.solutions";
+      std::ofstream file(path);
+      if (!file.is_open()) {
+        std::cerr << "Invalid output File: " << path << std::endl;
+        throw 6;
+      }
+      XYSolutionWriter writer(game, &file);
+      solutions = solver.enumerateSolutions(
+        [&writer, limit](const Solver::Solution &solution) {
+          writer.write(solution);
+          return writer.written() != limit;
+        });
+      solved = solutions > 0;
+    } else if (counting) {
+      solutions = solver.countSolutions(limit);
+      solved = solutions > 0;
+    } else if (sat) {
+      engine.reset(new SatEngine(&game));
+      solved = engine->solve();
+    } else if (portfolio.empty()) {
+      solved = solver.solveParallel(threads);
+    } else {
+      solved = solver.solvePortfolio(portfolio, &branching);
+    }
     auto time = std::chrono::high_resolution_clock::now() - start;
 
-    std::string outputTemplate = argv[2];
-    std::string fileExtension = solved ? ".solution" : ".error";
-    plainPrinter.printToFile(outputTemplate + ".plain" + fileExtension);
-    xyPrinter.printToFile(outputTemplate + ".xy" + fileExtension);
-    if (solved) {
+    std::string outputTemplate = paths[1];
+    bool timedOut = !engine && solver.status() == Solver::Status::TIMED_OUT;
+    // The game holds what propagation found before the search gave up
+    std::string fileExtension = solved ? ".solution"
+      : timedOut ? ".timeout" : ".error";
+    // An enumeration has written its solutions already
+    if (!enumerating) {
+      plainPrinter.printToFile(outputTemplate + ".plain" + fileExtension);
+      xyPrinter.printToFile(outputTemplate + ".xy" + fileExtension);
+    }
+    if (engine) {
+      const auto &statistics = engine->statistics();
+      std::cout << "SAT engine: " << engine->variables() << " variables, "
+                << engine->clauses() << " clauses (" << engine->cuts()
+                << " connectivity cuts), " << statistics.conflicts
+                << " conflicts, " << statistics.decisions << " decisions"
+                << std::endl;
+      if (!dimacsPath.empty()) {
+        std::ofstream dimacs(dimacsPath);
+        if (!dimacs.is_open()) {
+          std::cerr << "Invalid output File: " << dimacsPath << std::endl;
+          throw 6;
+        }
+        engine->writeDimacs(&dimacs);
+      }
+    } else {
+      const auto &statistics = solver.statistics();
+      std::cout << "Search nodes: " << statistics.nodes << " (branching "
+                << Solver::branchingName(branching) << ", "
+                << threads << (threads == 1 ? " thread, " : " threads, ")
+                << statistics.decisions << " decisions, "
+                << statistics.backtracks << " backtracks)" << std::endl;
+      std::cout << "Conflicts: " << statistics.backjumps << " backjumps, "
+                << statistics.nogoods << " nogoods learned, "
+                << statistics.prunes << " nogood prunes" << std::endl;
+      if (restarts != Solver::Restarts::NONE) {
+        std::cout << "Restarts: " << statistics.restarts << " ("
+                  << Solver::restartsName(restarts) << ", seed " << seed
+                  << ")" << std::endl;
+      }
+      std::cout << "Connectivity: " << statistics.cuts
+                << " bridges forced by cut edges" << std::endl;
+      uint64_t lookups = statistics.tableHits + statistics.tableMisses;
+      std::cout << "Transposition table: " << statistics.tableHits
+                << " hits, " << statistics.tableMisses << " misses ("
+                << (lookups == 0 ? 0 : 100 * statistics.tableHits / lookups)
+                << "% hit rate)" << std::endl;
+      if (counting) {
+        std::cout << "Solutions: " << solutions
+                  << (timedOut ? " (timed out, there may be more)"
+                      : limit != 0 && solutions == limit
+                      ? " (stopped at the limit)" : "")
+                  << std::endl;
+      }
+      if (!portfolio.empty()) {
+        std::cout << "Portfolio winner: " << Solver::branchingName(branching)
+                  << " of " << portfolio.size() << " configurations"
+                  << std::endl;
+      }
+    }
+    if (timedOut) {
+      std::cout << "Timed out after " << std::chrono::
+                   duration_cast<std::chrono::nanoseconds>(time).count()
+                << "ns" << std::endl;
+      return 2;
+    } else if (solved) {
       std::cout << "Solved in " << std::chrono::
                    duration_cast<std::chrono::nanoseconds>(time).count()
                 << "ns" << std::endl;
@@ -1,16 +1,67 @@
 #include <gtest/gtest.h>
 #include <deque>
-#include <unordered_map>
 #include <utility>
 #include <algorithm>
 #include <vector>
 #include <tuple>
+#include <atomic>
+#include <chrono>
 #include "./Game.h"
 #include "./Solver.h"
+#include "./EdgeSet.h"
+#include "./Domains.h"
+#include "./SearchPool.h"
 #include "./GamePrinter.h"
 
 // _____________________________________________________________________________
 
+// Helper function that forbids the gaps between the given Island pairs
+EdgeSet forbiddenEdges(const Game &game,
+  const std::vector<std::pair<Island*, Island*>> &pairs) {
+  EdgeSet result(game.edgeCount());
+  for (const auto &pair : pairs) {
+    result.insert(Game::edgeId(pair.first, pair.second));
+  }
+  return result;
+}
+
+// _____________________________________________________________________________
+
+// Helper function that returns the domains of all gaps of the game if the
+// gaps between the given Island pairs are forbidden
+Domains forbiddenDomains(const Game &game,
+  const std::vector<std::pair<Island*, Island*>> &pairs) {
+  Domains result(game.edgeCount());
+  result.reset(game, forbiddenEdges(game, pairs));
+  return result;
+}
+
+// _____________________________________________________________________________
+
+// Helper function that returns the Islands of an unsolvable riddle,
+// whose search finds out in a branch that doesn't depend on the
+// decision above it
+std::vector<Island> backjumpIslands() {
+  return {
+    Island(8, 0, 1),
+    Island(2, 1, 3),
+    Island(5, 1, 5),
+    Island(7, 1, 2),
+    Island(2, 5, 2),
+    Island(5, 6, 2),
+    Island(8, 6, 5),
+    Island(10, 6, 2),
+    Island(2, 8, 2),
+    Island(4, 8, 3),
+    Island(6, 8, 4),
+    Island(8, 8, 5),
+    Island(6, 11, 2),
+    Island(8, 11, 3)
+  };
+}
+
+// _____________________________________________________________________________
+
 TEST(SolverTest, constructor) {
   Game game({});
   Solver solver(&game);
@@ -19,7 +70,7 @@ TEST(SolverTest, constructor) {
 
 // _____________________________________________________________________________
 
-TEST(SolverTest, revertSteps) {
+TEST(SolverTest, revertLevel) {
   Game game({
     Island(0, 0, 1),
     Island(0, 9, 2),
@@ -32,27 +83,37 @@ TEST(SolverTest, revertSteps) {
   auto island4 = game.getIsland(9, 9);
   Bridge* oldBridge = nullptr;
   game.connect(island1, island2, false);
-  auto bridge = game.connect(island1, island2, false, &oldBridge);
-  std::deque<std::pair<Bridge*, Bridge*>> steps({
-    { bridge, oldBridge },
-    { game.connect(island2, island4, false), nullptr },
-    { game.connect(island3, island4, true), nullptr }
-  });
   Solver solver(&game);
-  solver.revertSteps(&steps);
-
-  EXPECT_EQ(0, steps.size());
-
-  ASSERT_EQ(1, island1->_bridges.size());
-  ASSERT_EQ(1, island2->_bridges.size());
-  EXPECT_EQ(0, island3->_bridges.size());
-  EXPECT_EQ(0, island4->_bridges.size());
-
-  EXPECT_EQ(oldBridge, island1->_bridges[0]);
-  EXPECT_EQ(oldBridge, island2->_bridges[0]);
-
-  EXPECT_FALSE(island1->_bridges[0]->_doubleBridge);
-  EXPECT_FALSE(island2->_bridges[0]->_doubleBridge);
+  solver._trail.openLevel();
+  auto bridge = game.connect(island1, island2, false, &oldBridge);
+  solver._trail.push(bridge, oldBridge);
+  solver._trail.push(game.connect(island2, island4, false), nullptr);
+  solver._trail.openLevel();
+  solver._trail.push(game.connect(island3, island4, true), nullptr);
+  solver.forbid(island1, island3);
+  EXPECT_TRUE(solver._forbidden.contains(Game::edgeId(island1, island3)));
+
+  // Only the last level is reverted
+  solver.revertLevel();
+  EXPECT_EQ(0, solver._forbidden.size());
+  EXPECT_EQ(2, solver._trail.size());
+  EXPECT_EQ(1, solver._trail.level());
+  EXPECT_EQ(0, island3->bridgeCount());
+  EXPECT_EQ(1, island4->bridgeCount());
+
+  solver.revertLevel();
+  EXPECT_EQ(0, solver._trail.size());
+  EXPECT_EQ(0, solver._trail.level());
+
+  ASSERT_EQ(1, island1->bridgeCount());
+  ASSERT_EQ(1, island2->bridgeCount());
+  EXPECT_EQ(0, island3->bridgeCount());
+  EXPECT_EQ(0, island4->bridgeCount());
+
+  EXPECT_EQ(oldBridge, island1->_bridges[Direction::DOWN._index]);
+  EXPECT_EQ(oldBridge, island2->_bridges[Direction::UP._index]);
+
+  EXPECT_FALSE(oldBridge->_doubleBridge);
 }
 
 // _____________________________________________________________________________
@@ -79,61 +140,64 @@ TEST(SolverTest, eliminateObvious) {
   auto i78 = game.getIsland(7, 8);
 
   Solver solver(&game);
-  std::deque<std::pair<Bridge*, Bridge*>> steps;
-  ASSERT_TRUE(solver.eliminateObvious({}, &steps));
+  solver.enqueueAll();
+  ASSERT_TRUE(solver.eliminateObvious());
+  EXPECT_TRUE(solver._queue.empty());
 
-  EXPECT_EQ(i00->_bridges.size(), 1);
+  EXPECT_EQ(i00->bridgeCount(), 1);
   EXPECT_EQ(1, i00->isConnected(i50));
 
-  EXPECT_EQ(i50->_bridges.size(), 2);
+  EXPECT_EQ(i50->bridgeCount(), 2);
   EXPECT_EQ(1, i50->isConnected(i00));
   EXPECT_EQ(1, i50->isConnected(i70));
 
-  EXPECT_EQ(i70->_bridges.size(), 1);
+  EXPECT_EQ(i70->bridgeCount(), 1);
   EXPECT_EQ(1, i70->isConnected(i50));
 
-  EXPECT_EQ(i05->_bridges.size(), 2);
+  EXPECT_EQ(i05->bridgeCount(), 2);
   EXPECT_EQ(2, i05->isConnected(i07));
   EXPECT_EQ(1, i05->isConnected(i55));
 
-  EXPECT_EQ(i55->_bridges.size(), 2);
+  EXPECT_EQ(i55->bridgeCount(), 2);
   EXPECT_EQ(1, i55->isConnected(i05));
   EXPECT_EQ(1, i55->isConnected(i75));
 
-  EXPECT_EQ(i75->_bridges.size(), 2);
+  EXPECT_EQ(i75->bridgeCount(), 2);
   EXPECT_EQ(1, i75->isConnected(i78));
   EXPECT_EQ(1, i75->isConnected(i55));
 
-  EXPECT_EQ(i07->_bridges.size(), 1);
+  EXPECT_EQ(i07->bridgeCount(), 1);
   EXPECT_EQ(2, i07->isConnected(i05));
 
-  EXPECT_EQ(i78->_bridges.size(), 1);
+  EXPECT_EQ(i78->bridgeCount(), 1);
   EXPECT_EQ(1, i78->isConnected(i75));
 
-  ASSERT_EQ(steps.size(), 6);
+  // The other entries narrow the domains of the gaps around the bridges
+  std::vector<Bridge*> steps;
+  for (size_t i = 0; i < solver._trail.size(); i++) {
+    if (solver._trail[i].kind == Trail::Kind::CONNECTION) {
+      EXPECT_EQ(nullptr, solver._trail[i].replaced);
+      steps.push_back(solver._trail[i].bridge);
+    }
+  }
+  ASSERT_EQ(6, steps.size());
   // Order of the pointers might differ, but this is okay
   std::vector<Bridge*> bridges = {
-    i50->_bridges[0],
-    i50->_bridges[1],
-    i05->_bridges[0],
-    i05->_bridges[1],
-    i75->_bridges[0],
-    i75->_bridges[1]
+    i50->_bridges[Direction::LEFT._index],
+    i50->_bridges[Direction::RIGHT._index],
+    i05->_bridges[Direction::RIGHT._index],
+    i05->_bridges[Direction::DOWN._index],
+    i75->_bridges[Direction::LEFT._index],
+    i75->_bridges[Direction::DOWN._index]
   };
   std::sort(steps.begin(), steps.end());
   std::sort(bridges.begin(), bridges.end());
-  EXPECT_EQ(bridges[0], steps[0].first);
-  EXPECT_EQ(bridges[1], steps[1].first);
-  EXPECT_EQ(bridges[2], steps[2].first);
-  EXPECT_EQ(bridges[3], steps[3].first);
-  EXPECT_EQ(bridges[4], steps[4].first);
-  EXPECT_EQ(bridges[5], steps[5].first);
-  EXPECT_EQ(nullptr, steps[0].second);
-  EXPECT_EQ(nullptr, steps[1].second);
-  EXPECT_EQ(nullptr, steps[2].second);
-  EXPECT_EQ(nullptr, steps[3].second);
-  EXPECT_EQ(nullptr, steps[4].second);
-  EXPECT_EQ(nullptr, steps[5].second);
+  EXPECT_EQ(bridges[0], steps[0]);
+  EXPECT_EQ(bridges[1], steps[1]);
+  EXPECT_EQ(bridges[2], steps[2]);
+  EXPECT_EQ(bridges[3], steps[3]);
+  EXPECT_EQ(bridges[4], steps[4]);
+  EXPECT_EQ(bridges[5], steps[5]);
 }
 
 // _____________________________________________________________________________
@@ -157,14 +221,13 @@ TEST(SolverTest, extractValidGaps) {
   auto i04 = game.getIsland(0, 4);
 
   Solver solver(&game);
-  std::unordered_multimap<Island*, Island*> forbidden;
 
   game.connect(i02, i42, false);
   auto gap1 = std::make_tuple(i02, i42, &Direction::RIGHT);
   auto result = solver.extractValidGaps({
     gap1,
     std::make_tuple(i20, i24, &Direction::DOWN)
-  }, &forbidden);
+  });
   ASSERT_EQ(result.size(), 1);
   ASSERT_EQ(result[0], gap1);
 
@@ -173,10 +236,164 @@ TEST(SolverTest, extractValidGaps) {
   game.connect(i02, i04, true);
   auto result2 = solver.extractValidGaps({
     std::make_tuple(i04, i42, &Direction::DOWN)
-  }, &forbidden);
+  });
   ASSERT_EQ(result2.size(), 0);
 
-  ASSERT_EQ(0, forbidden.size());
+  ASSERT_EQ(0, solver._forbidden.size());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, orderGaps) {
+  Game game({
+    Island(0, 0, 1),
+    Island(2, 0, 3),
+    Island(4, 0, 2),
+    Island(2, 2, 2)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+  auto i40 = game.getIsland(4, 0);
+  auto i22 = game.getIsland(2, 2);
+  std::deque<std::tuple<Island*, Island*, const Direction*>> input = {
+    std::make_tuple(i20, i40, &Direction::RIGHT),
+    std::make_tuple(i20, i22, &Direction::DOWN),
+    std::make_tuple(i00, i20, &Direction::RIGHT)
+  };
+
+  // The input order is kept as it is
+  Solver inputSolver(&game);
+  auto gaps = input;
+  inputSolver.orderGaps(&gaps);
+  EXPECT_EQ(input, gaps);
+
+  // Every gap touches an Island with a single open gap, the one with
+  // the least remaining capacity comes first, ties keep the input order
+  Solver optionsSolver(&game, Solver::Branching::FEWEST_OPTIONS);
+  gaps = input;
+  optionsSolver.orderGaps(&gaps);
+  ASSERT_EQ(3, gaps.size());
+  EXPECT_EQ(input[2], gaps[0]);
+  EXPECT_EQ(input[0], gaps[1]);
+  EXPECT_EQ(input[1], gaps[2]);
+  EXPECT_EQ(1, optionsSolver._ranks[i00->index()]);
+  EXPECT_EQ(3, optionsSolver._ranks[i20->index()]);
+
+  // Once the single gap of the left Island is forbidden its gap ranks
+  // first, it has no options left at all
+  optionsSolver.forbid(i00, i20);
+  gaps = input;
+  optionsSolver.orderGaps(&gaps);
+  EXPECT_EQ(input[2], gaps[0]);
+  EXPECT_EQ(0, optionsSolver._ranks[i00->index()]);
+  EXPECT_EQ(2, optionsSolver._ranks[i20->index()]);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, parseBranching) {
+  for (auto branching : { Solver::Branching::INPUT,
+    Solver::Branching::MOST_CONSTRAINED, Solver::Branching::FEWEST_OPTIONS,
+    Solver::Branching::MAX_DEGREE }) {
+    Solver::Branching parsed = Solver::Branching::INPUT;
+    EXPECT_TRUE(Solver::parseBranching(Solver::branchingName(branching),
+      &parsed));
+    EXPECT_EQ(branching, parsed);
+  }
+  Solver::Branching unchanged = Solver::Branching::MAX_DEGREE;
+  EXPECT_FALSE(Solver::parseBranching("random", &unchanged));
+  EXPECT_EQ(Solver::Branching::MAX_DEGREE, unchanged);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, orderGapsRandomly) {
+  Game game({
+    Island(0, 0, 1),
+    Island(2, 0, 3),
+    Island(4, 0, 2),
+    Island(2, 2, 2)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+  auto i40 = game.getIsland(4, 0);
+  auto i22 = game.getIsland(2, 2);
+  std::deque<std::tuple<Island*, Island*, const Direction*>> input = {
+    std::make_tuple(i20, i40, &Direction::RIGHT),
+    std::make_tuple(i20, i22, &Direction::DOWN),
+    std::make_tuple(i00, i20, &Direction::RIGHT)
+  };
+
+  // Every order of the input is possible, the same seed picks the same
+  Solver inputSolver(&game);
+  inputSolver.setRestarts(Solver::Restarts::LUBY);
+  std::vector<std::deque<std::tuple<Island*, Island*, const Direction*>>>
+    orders;
+  for (uint32_t seed = 0; seed < 20; seed++) {
+    auto gaps = input;
+    inputSolver._random.seed(seed);
+    inputSolver.orderGaps(&gaps);
+    auto again = input;
+    inputSolver._random.seed(seed);
+    inputSolver.orderGaps(&again);
+    EXPECT_EQ(gaps, again);
+    EXPECT_TRUE(std::is_permutation(gaps.begin(), gaps.end(),
+      input.begin()));
+    orders.push_back(gaps);
+  }
+  std::sort(orders.begin(), orders.end());
+  EXPECT_LT(1, std::unique(orders.begin(), orders.end()) - orders.begin());
+
+  // The branching strategy still decides, the gap of the Island with
+  // a single open gap comes first
+  Solver optionsSolver(&game, Solver::Branching::FEWEST_OPTIONS);
+  optionsSolver.setRestarts(Solver::Restarts::GEOMETRIC);
+  for (uint32_t seed = 0; seed < 20; seed++) {
+    auto gaps = input;
+    optionsSolver._random.seed(seed);
+    optionsSolver.orderGaps(&gaps);
+    EXPECT_EQ(input[2], gaps[0]);
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, parseRestarts) {
+  for (auto restarts : { Solver::Restarts::NONE, Solver::Restarts::LUBY,
+    Solver::Restarts::GEOMETRIC }) {
+    Solver::Restarts parsed = Solver::Restarts::NONE;
+    EXPECT_TRUE(Solver::parseRestarts(Solver::restartsName(restarts),
+      &parsed));
+    EXPECT_EQ(restarts, parsed);
+  }
+  Solver::Restarts unchanged = Solver::Restarts::LUBY;
+  EXPECT_FALSE(Solver::parseRestarts("always", &unchanged));
+  EXPECT_EQ(Solver::Restarts::LUBY, unchanged);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, restartInterval) {
+  std::vector<uint64_t> sequence;
+  for (uint64_t i = 0; i < 15; i++) {
+    sequence.push_back(Solver::luby(i));
+  }
+  EXPECT_EQ(std::vector<uint64_t>({ 1, 1, 2, 1, 1, 2, 4, 1, 1, 2, 1, 1, 2,
+    4, 8 }), sequence);
+
+  Game game({ Island(0, 0, 1), Island(2, 0, 1) });
+  Solver solver(&game);
+  EXPECT_EQ(UINT64_MAX, solver.restartInterval(0));
+  solver.setRestarts(Solver::Restarts::LUBY);
+  EXPECT_EQ(Solver::RESTART_UNIT, solver.restartInterval(0));
+  EXPECT_EQ(4 * Solver::RESTART_UNIT, solver.restartInterval(6));
+  solver.setRestarts(Solver::Restarts::LUBY, 3);
+  EXPECT_EQ(6, solver.restartInterval(2));
+  solver.setRestarts(Solver::Restarts::GEOMETRIC);
+  EXPECT_EQ(Solver::RESTART_UNIT, solver.restartInterval(0));
+  EXPECT_EQ(Solver::RESTART_UNIT * 9 / 4, solver.restartInterval(2));
+  EXPECT_LT(solver.restartInterval(50), solver.restartInterval(51));
+  EXPECT_LT(0, solver.restartInterval(1000));
 }
 
 // _____________________________________________________________________________
@@ -201,29 +418,28 @@ TEST(SolverTest, tryGaps) {
     std::make_tuple(leftIsland, middleIsland, &Direction::LEFT)
   };
 
-  std::unordered_multimap<Island*, Island*> forbidden = {
-    { leftIsland, middleIsland }
-  };
+  solver.forbid(leftIsland, middleIsland);
 
-  EXPECT_FALSE(solver.tryGaps(&gaps, &forbidden));
+  EXPECT_FALSE(solver.tryGaps(&gaps));
 
   EXPECT_EQ(0, gaps.size());
 
-  EXPECT_EQ(0, middleIsland->_bridges.size());
-  EXPECT_EQ(0, rightIsland->_bridges.size());
-  EXPECT_EQ(0, topIsland->_bridges.size());
-  EXPECT_EQ(0, rightIsland->_bridges.size());
-  EXPECT_EQ(0, leftIsland->_bridges.size());
-
-  ASSERT_EQ(3, forbidden.size());
-  std::vector<std::pair<Island*, Island*>> fvector(forbidden.begin(),
-    forbidden.end());
-  EXPECT_EQ(topIsland, fvector[0].first);
-  EXPECT_EQ(middleIsland, fvector[0].second);
-  EXPECT_EQ(leftIsland, fvector[1].first);
-  EXPECT_EQ(middleIsland, fvector[1].second);
-  EXPECT_EQ(leftIsland, fvector[2].first);
-  EXPECT_EQ(middleIsland, fvector[2].second);
+  EXPECT_EQ(0, middleIsland->bridgeCount());
+  EXPECT_EQ(0, rightIsland->bridgeCount());
+  EXPECT_EQ(0, topIsland->bridgeCount());
+  EXPECT_EQ(0, rightIsland->bridgeCount());
+  EXPECT_EQ(0, leftIsland->bridgeCount());
+
+  // Both gaps failed, the left one already was forbidden before
+  ASSERT_EQ(2, solver._forbidden.size());
+  EXPECT_TRUE(solver._forbidden.contains(
+    Game::edgeId(topIsland, middleIsland)));
+  EXPECT_TRUE(solver._forbidden.contains(
+    Game::edgeId(leftIsland, middleIsland)));
+  ASSERT_EQ(2, solver._trail.size());
+  EXPECT_EQ(Trail::Kind::FORBIDDEN, solver._trail[0].kind);
+  EXPECT_EQ(Trail::Kind::FORBIDDEN, solver._trail[1].kind);
+  EXPECT_EQ(0, solver._trail.level());
 }
 
 // _____________________________________________________________________________
@@ -244,20 +460,24 @@ TEST(SolverTest, solvePublicSolvable) {
   EXPECT_TRUE(solver.solve());
   EXPECT_TRUE(game.isSolved());
 
-  ASSERT_EQ(2, i00->_bridges.size());
-  ASSERT_EQ(2, i20->_bridges.size());
-  ASSERT_EQ(2, i02->_bridges.size());
-  ASSERT_EQ(2, i22->_bridges.size());
-
-  EXPECT_EQ(i00->_bridges[0], i02->_bridges[0]);
-  EXPECT_EQ(i00->_bridges[1], i20->_bridges[1]);
-  EXPECT_EQ(i02->_bridges[1], i22->_bridges[1]);
-  EXPECT_EQ(i20->_bridges[0], i22->_bridges[0]);
-
-  EXPECT_FALSE(i02->_bridges[0]->_doubleBridge);
-  EXPECT_TRUE(i20->_bridges[1]->_doubleBridge);
-  EXPECT_TRUE(i22->_bridges[1]->_doubleBridge);
-  EXPECT_FALSE(i22->_bridges[0]->_doubleBridge);
+  ASSERT_EQ(2, i00->bridgeCount());
+  ASSERT_EQ(2, i20->bridgeCount());
+  ASSERT_EQ(2, i02->bridgeCount());
+  ASSERT_EQ(2, i22->bridgeCount());
+
+  // There are 2 valid solutions, single and double bridges alternate
+  // around the square, which one is found depends on the search order
+  EXPECT_EQ(3, i00->isConnected(i02) + i00->isConnected(i20));
+  EXPECT_NE(0, i00->isConnected(i02));
+  EXPECT_NE(0, i00->isConnected(i20));
+  EXPECT_EQ(i00->isConnected(i02), i20->isConnected(i22));
+  EXPECT_EQ(i00->isConnected(i20), i02->isConnected(i22));
+
+  // Only the 4 Bridges of the solution are still alive, everything tried
+  // during the search has been handed back to the pool
+  auto statistics = game.bridgeStatistics();
+  EXPECT_EQ(4, statistics.acquired - statistics.recycled);
+  EXPECT_EQ(1, statistics.blockAllocations);
 }
 
 // _____________________________________________________________________________
@@ -278,10 +498,776 @@ TEST(SolverTest, solvePublicUnsolvable) {
   EXPECT_FALSE(solver.solve());
   EXPECT_FALSE(game.isSolved());
 
-  EXPECT_EQ(0, i00->_bridges.size());
-  EXPECT_EQ(0, i20->_bridges.size());
-  EXPECT_EQ(0, i02->_bridges.size());
-  EXPECT_EQ(0, i22->_bridges.size());
+  EXPECT_EQ(0, i00->bridgeCount());
+  EXPECT_EQ(0, i20->bridgeCount());
+  EXPECT_EQ(0, i02->bridgeCount());
+  EXPECT_EQ(0, i22->bridgeCount());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, splitGaps) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+
+  SearchPool pool(1);
+  Solver solver(&game);
+  solver._pool = &pool;
+  auto gaps = solver.collectGaps();
+  ASSERT_EQ(4, gaps.size());
+  auto first = gaps[0];
+  auto rest = gaps;
+  rest.pop_front();
+  game.connect(i00, i20, false);
+
+  solver.splitGaps(&gaps);
+  ASSERT_EQ(1, gaps.size());
+  EXPECT_EQ(first, gaps[0]);
+
+  SearchTask task;
+  ASSERT_TRUE(pool.pop(0, &task));
+  ASSERT_EQ(3, task.gaps.size());
+  for (size_t i = 0; i < rest.size(); i++) {
+    EXPECT_EQ(Game::edgeId(std::get<0>(rest[i]), std::get<1>(rest[i])),
+      task.gaps[i]);
+  }
+  EXPECT_EQ(1, task.forbidden.size());
+  EXPECT_TRUE(task.forbidden.contains(Game::edgeId(std::get<0>(first),
+    std::get<1>(first))));
+
+  // The task starts at the bridges of the split, but every solution needs
+  // a bridge in the forbidden gap
+  Game clone = game.clone();
+  Solver worker(&clone);
+  EXPECT_FALSE(worker.solveTask(task));
+  EXPECT_EQ(1, worker.statistics().nodes);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, solveParallel) {
+  for (size_t threads : { 1, 2, 4 }) {
+    Game game({
+      Island(0, 0, 3),
+      Island(2, 0, 3),
+      Island(0, 2, 3),
+      Island(2, 2, 3)
+    });
+    Solver solver(&game);
+    EXPECT_TRUE(solver.solveParallel(threads));
+    EXPECT_TRUE(game.isSolved());
+    EXPECT_LE(2, solver.statistics().nodes);
+    auto statistics = game.bridgeStatistics();
+    EXPECT_EQ(4, statistics.acquired - statistics.recycled);
+
+    Game unsolvable({
+      Island(0, 0, 1),
+      Island(2, 0, 1),
+      Island(0, 2, 1),
+      Island(2, 2, 1)
+    });
+    Solver unsolvableSolver(&unsolvable);
+    EXPECT_FALSE(unsolvableSolver.solveParallel(threads));
+    EXPECT_FALSE(unsolvable.isSolved());
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, solvePortfolio) {
+  std::vector<Solver::Branching> portfolio = {
+    Solver::Branching::INPUT, Solver::Branching::MOST_CONSTRAINED,
+    Solver::Branching::FEWEST_OPTIONS, Solver::Branching::MAX_DEGREE
+  };
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  Solver solver(&game);
+  Solver::Branching winner = Solver::Branching::INPUT;
+  EXPECT_TRUE(solver.solvePortfolio(portfolio, &winner));
+  EXPECT_TRUE(game.isSolved());
+  EXPECT_NE(portfolio.end(), std::find(portfolio.begin(), portfolio.end(),
+    winner));
+  EXPECT_LE(2, solver.statistics().nodes);
+
+  Game unsolvable({
+    Island(0, 0, 1),
+    Island(2, 0, 1),
+    Island(0, 2, 1),
+    Island(2, 2, 1)
+  });
+  Solver unsolvableSolver(&unsolvable);
+  EXPECT_FALSE(unsolvableSolver.solvePortfolio(portfolio, &winner));
+  EXPECT_FALSE(unsolvable.isSolved());
+
+  // Without strategies the Solver runs on its own
+  Game single({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  Solver singleSolver(&single, Solver::Branching::FEWEST_OPTIONS);
+  EXPECT_TRUE(singleSolver.solvePortfolio({}, &winner));
+  EXPECT_EQ(Solver::Branching::FEWEST_OPTIONS, winner);
+  EXPECT_TRUE(single.isSolved());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, cancelled) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  std::atomic<bool> cancelled(true);
+  Solver solver(&game);
+  solver._cancelled = &cancelled;
+  // Nothing is forced, so the search gives up before its first decision
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(1, solver.statistics().nodes);
+  EXPECT_EQ(0, solver.statistics().decisions);
+
+  cancelled = false;
+  EXPECT_TRUE(solver.solve());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, expired) {
+  Game game(backjumpIslands());
+  Solver solver(&game);
+  EXPECT_FALSE(solver.expired());
+  std::atomic<bool> cancellation(true);
+  solver.setCancellation(&cancellation);
+  EXPECT_TRUE(solver.expired());
+  // Giving up sticks until the next search
+  cancellation = false;
+  EXPECT_TRUE(solver.expired());
+  solver._expired = false;
+  EXPECT_FALSE(solver.expired());
+
+  // The clock is only read every CLOCK_INTERVAL-th time
+  solver.setDeadline(std::chrono::steady_clock::now());
+  for (uint32_t i = 1; i < Solver::CLOCK_INTERVAL; i++) {
+    EXPECT_FALSE(solver.expired());
+  }
+  EXPECT_TRUE(solver.expired());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, giveUp) {
+  Game game(backjumpIslands());
+  Solver solver(&game);
+  solver.setTableMemory(0);
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(Solver::Status::UNSOLVABLE, solver.status());
+  uint64_t nodes = solver.statistics().nodes;
+  ASSERT_LT(3, nodes);
+  auto propagated = game.hash();
+
+  // The search gives up and keeps what propagation found before the
+  // first decision
+  solver.setNodeLimit(3);
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(Solver::Status::TIMED_OUT, solver.status());
+  EXPECT_EQ(3, solver.statistics().nodes);
+  EXPECT_EQ(propagated, game.hash());
+  solver.setNodeLimit(0);
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(Solver::Status::UNSOLVABLE, solver.status());
+  EXPECT_EQ(nodes, solver.statistics().nodes);
+
+  // A deadline in the past gives up as soon as the clock is read
+  solver.setDeadline(std::chrono::steady_clock::now());
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(Solver::Status::TIMED_OUT, solver.status());
+  EXPECT_GT(nodes, solver.statistics().nodes);
+  EXPECT_EQ(propagated, game.hash());
+  solver.setDeadline(std::chrono::steady_clock::time_point::max());
+
+  std::atomic<bool> cancellation(true);
+  solver.setCancellation(&cancellation);
+  EXPECT_FALSE(solver.solveParallel(2));
+  EXPECT_EQ(Solver::Status::TIMED_OUT, solver.status());
+  Solver::Branching winner;
+  EXPECT_FALSE(solver.solvePortfolio({ Solver::Branching::INPUT,
+    Solver::Branching::MAX_DEGREE }, &winner));
+  EXPECT_EQ(Solver::Status::TIMED_OUT, solver.status());
+  cancellation = false;
+  EXPECT_FALSE(solver.solveParallel(2));
+  EXPECT_EQ(Solver::Status::UNSOLVABLE, solver.status());
+
+  Game solvable({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  Solver solvableSolver(&solvable);
+  solvableSolver.setNodeLimit(1);
+  EXPECT_FALSE(solvableSolver.solve());
+  EXPECT_EQ(Solver::Status::TIMED_OUT, solvableSolver.status());
+  EXPECT_EQ(0, solvableSolver.countSolutions(0));
+  EXPECT_EQ(Solver::Status::TIMED_OUT, solvableSolver.status());
+  solvableSolver.setNodeLimit(0);
+  EXPECT_TRUE(solvableSolver.solve());
+  EXPECT_EQ(Solver::Status::SOLVED, solvableSolver.status());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, restarts) {
+  for (auto restarts : { Solver::Restarts::LUBY,
+    Solver::Restarts::GEOMETRIC }) {
+    for (uint32_t seed = 0; seed < 5; seed++) {
+      Game riddle(backjumpIslands());
+      Solver restarting(&riddle);
+      restarting.setRestarts(restarts, 2);
+      restarting.setSeed(seed);
+      EXPECT_FALSE(restarting.solve());
+      EXPECT_EQ(Solver::Status::UNSOLVABLE, restarting.status());
+      uint64_t nodes = restarting.statistics().nodes;
+      uint64_t runs = restarting.statistics().restarts;
+      EXPECT_LT(0, runs);
+
+      // The same seed makes the same decisions
+      Game again(backjumpIslands());
+      Solver repeated(&again);
+      repeated.setRestarts(restarts, 2);
+      repeated.setSeed(seed);
+      EXPECT_FALSE(repeated.solve());
+      EXPECT_EQ(nodes, repeated.statistics().nodes);
+      EXPECT_EQ(runs, repeated.statistics().restarts);
+    }
+  }
+
+  // Short runs start over several times, but still find the solution
+  Game solvable({
+    Island(0, 1, 2), Island(3, 1, 3), Island(5, 1, 3), Island(8, 1, 2),
+    Island(0, 3, 4), Island(3, 3, 3), Island(5, 3, 4), Island(8, 3, 3),
+    Island(1, 5, 2), Island(3, 5, 4),
+    Island(0, 7, 3), Island(3, 7, 3), Island(5, 7, 4), Island(8, 7, 2)
+  });
+  Solver restarting(&solvable, Solver::Branching::MOST_CONSTRAINED);
+  restarting.setRestarts(Solver::Restarts::LUBY, 1);
+  restarting.setNogoodBudget(0);
+  restarting.setTableMemory(0);
+  for (uint32_t seed = 0; seed < 5; seed++) {
+    auto empty = solvable.snapshot();
+    restarting.setSeed(seed);
+    EXPECT_TRUE(restarting.solve());
+    EXPECT_TRUE(solvable.isSolved());
+    EXPECT_EQ(Solver::Status::SOLVED, restarting.status());
+    solvable.restore(empty);
+  }
+
+  // Every run counts against the node limit
+  Game limited(backjumpIslands());
+  Solver limitedSolver(&limited);
+  limitedSolver.setRestarts(Solver::Restarts::LUBY, 1);
+  limitedSolver.setNodeLimit(4);
+  EXPECT_FALSE(limitedSolver.solve());
+  EXPECT_EQ(Solver::Status::TIMED_OUT, limitedSolver.status());
+  EXPECT_EQ(4, limitedSolver.statistics().nodes);
+  EXPECT_LT(0, limitedSolver.statistics().restarts);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, countSolution) {
+  Game game({
+    Island(0, 0, 1),
+    Island(2, 0, 1)
+  });
+  game.connect(game.getIsland(0, 0), game.getIsland(2, 0), false);
+  Solver solver(&game);
+  solver._limit = 2;
+  solver._trail.openLevel();
+  solver._trail.openLevel();
+  // The search goes on as if the solution failed because of every decision
+  EXPECT_FALSE(solver.countSolution());
+  EXPECT_EQ(1, solver._solutions);
+  EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), solver._conflict);
+  EXPECT_NE(nullptr, solver._firstSolution);
+  EXPECT_TRUE(solver.countSolution());
+  EXPECT_EQ(2, solver._solutions);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, countSolutions) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  auto empty = game.snapshot();
+  Solver solver(&game);
+  EXPECT_EQ(1, solver.countSolutions(1));
+  EXPECT_TRUE(game.isSolved());
+  // Only the solutions with the bridges of the game are counted
+  EXPECT_EQ(1, solver.countSolutions(0));
+  game.restore(empty);
+  EXPECT_EQ(2, solver.countSolutions(0));
+  game.restore(empty);
+  EXPECT_EQ(2, solver.countSolutions(2));
+  game.restore(empty);
+  EXPECT_EQ(2, solver.countSolutions(5));
+  // The game holds the first solution, everything else has been handed
+  // back to the pool
+  EXPECT_TRUE(game.isSolved());
+  auto statistics = game.bridgeStatistics();
+  EXPECT_EQ(4, statistics.acquired - statistics.recycled);
+
+  Game unsolvable(backjumpIslands());
+  Solver unsolvableSolver(&unsolvable);
+  EXPECT_EQ(0, unsolvableSolver.countSolutions(0));
+  EXPECT_FALSE(unsolvableSolver.solve());
+
+  // Counted solutions must neither be learned as nogoods nor be stored in
+  // the table, whatever order the gaps are tried in
+  for (auto branching : { Solver::Branching::INPUT,
+    Solver::Branching::MOST_CONSTRAINED, Solver::Branching::FEWEST_OPTIONS,
+    Solver::Branching::MAX_DEGREE }) {
+    Game loose({
+      Island(0, 1, 2), Island(3, 1, 3), Island(5, 1, 3), Island(8, 1, 2),
+      Island(0, 3, 4), Island(3, 3, 3), Island(5, 3, 4), Island(8, 3, 3),
+      Island(1, 5, 2), Island(3, 5, 4),
+      Island(0, 7, 3), Island(3, 7, 3), Island(5, 7, 4), Island(8, 7, 2)
+    });
+    auto looseEmpty = loose.snapshot();
+    Solver looseSolver(&loose, branching);
+    EXPECT_EQ(26, looseSolver.countSolutions(0));
+    EXPECT_TRUE(loose.isSolved());
+    loose.restore(looseEmpty);
+    EXPECT_EQ(26, looseSolver.countSolutions(0));
+    loose.restore(looseEmpty);
+    EXPECT_EQ(10, looseSolver.countSolutions(10));
+    loose.restore(looseEmpty);
+    looseSolver.setNogoodBudget(0);
+    looseSolver.setTableMemory(0);
+    EXPECT_EQ(26, looseSolver.countSolutions(0));
+    loose.restore(looseEmpty);
+    EXPECT_TRUE(looseSolver.solve());
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, collectSolution) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  auto i00 = game.getIsland(0, 0);
+  auto i20 = game.getIsland(2, 0);
+  auto i02 = game.getIsland(0, 2);
+  Solver solver(&game);
+  solver.collectSolution();
+  EXPECT_TRUE(solver._solution.empty());
+  game.connect(i00, i02, false);
+  game.connect(i00, i20, true);
+  solver.collectSolution();
+  EXPECT_EQ(Solver::Solution({ { Game::edgeId(i00, i20), 2 },
+    { Game::edgeId(i00, i02), 1 } }), solver._solution);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, enumerateSolutions) {
+  Game game({
+    Island(0, 0, 3),
+    Island(2, 0, 3),
+    Island(0, 2, 3),
+    Island(2, 2, 3)
+  });
+  Solver solver(&game);
+  std::vector<Solver::Solution> solutions;
+  auto collect = [&solutions](const Solver::Solution &solution) {
+    solutions.push_back(solution);
+    return true;
+  };
+  EXPECT_EQ(2, solver.enumerateSolutions(collect));
+  ASSERT_EQ(2, solutions.size());
+  EXPECT_NE(solutions[0], solutions[1]);
+  for (const auto &solution : solutions) {
+    EXPECT_EQ(4, solution.size());
+  }
+  // The game ends up with the bridges forced before the first decision,
+  // a single one in every gap
+  EXPECT_FALSE(game.isSolved());
+  for (const auto &island : game.getIslands()) {
+    EXPECT_EQ(1, island->missingConnections());
+  }
+
+  // Stopping after the first solution keeps it in the game
+  solutions.clear();
+  EXPECT_EQ(1, solver.enumerateSolutions(
+    [&solutions](const Solver::Solution &solution) {
+      solutions.push_back(solution);
+      return false;
+    }));
+  EXPECT_EQ(1, solutions.size());
+  EXPECT_TRUE(game.isSolved());
+
+  // Every solution is found once, whatever order the gaps are tried in
+  for (auto branching : { Solver::Branching::INPUT,
+    Solver::Branching::MOST_CONSTRAINED, Solver::Branching::FEWEST_OPTIONS,
+    Solver::Branching::MAX_DEGREE }) {
+    Game loose({
+      Island(0, 1, 2), Island(3, 1, 3), Island(5, 1, 3), Island(8, 1, 2),
+      Island(0, 3, 4), Island(3, 3, 3), Island(5, 3, 4), Island(8, 3, 3),
+      Island(1, 5, 2), Island(3, 5, 4),
+      Island(0, 7, 3), Island(3, 7, 3), Island(5, 7, 4), Island(8, 7, 2)
+    });
+    Solver looseSolver(&loose, branching);
+    solutions.clear();
+    EXPECT_EQ(26, looseSolver.enumerateSolutions(collect));
+    std::sort(solutions.begin(), solutions.end());
+    EXPECT_EQ(solutions.end(),
+      std::unique(solutions.begin(), solutions.end()));
+  }
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, explain) {
+  Game game({
+    Island(0, 0, 2),
+    Island(2, 0, 2),
+    Island(0, 2, 2),
+    Island(2, 2, 2)
+  });
+  auto topLeft = game.getIsland(0, 0);
+  auto topRight = game.getIsland(2, 0);
+  auto bottomLeft = game.getIsland(0, 2);
+  auto bottomRight = game.getIsland(2, 2);
+  uint32_t top = Game::edgeId(topLeft, topRight);
+  Solver solver(&game);
+
+  // Entries before the first decision don't depend on any
+  solver._trail.push(game.connect(topLeft, topRight, false), nullptr);
+  solver.clearFacts();
+  solver.explain();
+  EXPECT_EQ(0, solver._depths[0]);
+  EXPECT_EQ(0, solver._bridgeEntries[top]);
+
+  // A decision only depends on itself
+  solver._trail.openLevel();
+  solver._trail.push(game.connect(bottomLeft, bottomRight, false), nullptr);
+  solver.clearFacts();
+  solver.explain();
+  EXPECT_EQ(1, solver._depths[1]);
+  EXPECT_EQ(solver._reasonStarts[1], solver._reasonStarts[2]);
+
+  // The entries of a step share the facts of the first one
+  solver._trail.push(game.connect(topLeft, bottomLeft, false), nullptr);
+  solver._trail.push(game.connect(topRight, bottomRight, false), nullptr);
+  solver.clearFacts();
+  solver.addFact(1);
+  solver.explain();
+  EXPECT_EQ(1, solver._depths[2]);
+  EXPECT_EQ(1, solver._depths[3]);
+  EXPECT_EQ(std::vector<uint32_t>({ 1, 2 }), std::vector<uint32_t>(
+    solver._reasons.begin() + solver._reasonStarts[2], solver._reasons.end()));
+
+  // The second bridge of a gap depends on the first one
+  Bridge* oldBridge = nullptr;
+  Bridge* bridge = game.connect(topLeft, topRight, false, &oldBridge);
+  solver._trail.push(bridge, oldBridge);
+  solver.clearFacts();
+  solver.explain();
+  EXPECT_EQ(0, solver._depths[4]);
+  EXPECT_EQ(0, solver._previousEntries[4]);
+  EXPECT_EQ(4, solver._bridgeEntries[top]);
+
+  solver.clearFacts();
+  solver.addFact(3);
+  solver.addFact(4);
+  solver.analyze();
+  EXPECT_EQ(std::vector<uint32_t>({ 1 }), solver._conflict);
+
+  // Undoing the level undoes its bookkeeping
+  solver.revertLevel();
+  EXPECT_EQ(0, solver._bridgeEntries[top]);
+  EXPECT_EQ(2, solver._reasonStarts.size());
+  EXPECT_TRUE(solver._reasons.empty());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, backjump) {
+  std::vector<Island> islands = backjumpIslands();
+  Game game(islands);
+  Solver solver(&game);
+  EXPECT_FALSE(solver.solve());
+  EXPECT_LT(0, solver.statistics().backjumps);
+  EXPECT_LT(0, solver.statistics().nogoods);
+  EXPECT_GT(solver.statistics().backtracks, solver.statistics().backjumps);
+
+  // Without nogoods the search still jumps back
+  Game again(islands);
+  Solver forgetful(&again);
+  forgetful.setNogoodBudget(0);
+  EXPECT_FALSE(forgetful.solve());
+  EXPECT_EQ(solver.statistics().backjumps,
+    forgetful.statistics().backjumps);
+  EXPECT_EQ(0, forgetful.statistics().nogoods);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, transpositionTable) {
+  Game game(backjumpIslands());
+  Solver solver(&game);
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(0, solver.statistics().tableHits);
+  EXPECT_EQ(solver.statistics().decisions,
+    solver.statistics().tableMisses);
+  uint64_t nodes = solver.statistics().nodes;
+
+  // The table is kept, so the second search gives up on the states of
+  // the first one right away
+  EXPECT_FALSE(solver.solve());
+  EXPECT_LT(0, solver.statistics().tableHits);
+  EXPECT_GT(nodes, solver.statistics().nodes);
+
+  solver.setTableMemory(0);
+  EXPECT_FALSE(solver.solve());
+  EXPECT_EQ(0, solver.statistics().tableHits);
+  EXPECT_EQ(0, solver.statistics().tableMisses);
+  EXPECT_EQ(nodes, solver.statistics().nodes);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, checkNogoods) {
+  Game game({
+    Island(0, 0, 2),
+    Island(2, 0, 2),
+    Island(0, 2, 2),
+    Island(2, 2, 2)
+  });
+  auto topLeft = game.getIsland(0, 0);
+  auto topRight = game.getIsland(2, 0);
+  auto bottomLeft = game.getIsland(0, 2);
+  auto bottomRight = game.getIsland(2, 2);
+  uint32_t top = Game::edgeId(topLeft, topRight);
+  uint32_t bottom = Game::edgeId(bottomLeft, bottomRight);
+  uint32_t left = Game::edgeId(topLeft, bottomLeft);
+  Solver solver(&game);
+  ASSERT_TRUE(solver._nogoods.add({ { top, 1 }, { bottom, 1 } }));
+  ASSERT_TRUE(solver._nogoods.add({ { top, 2 } }));
+
+  // A bridge at the top rules out one at the bottom and a second one
+  // at the top
+  solver._trail.push(game.connect(topLeft, topRight, false), nullptr);
+  solver.clearFacts();
+  solver.explain();
+  EXPECT_TRUE(solver.checkNogoods(0));
+  EXPECT_TRUE(solver._forbidden.contains(bottom));
+  EXPECT_TRUE(solver._forbidden.contains(top));
+  EXPECT_FALSE(solver._forbidden.contains(left));
+  EXPECT_EQ(2, solver.statistics().prunes);
+  ASSERT_EQ(3, solver._trail.size());
+  EXPECT_EQ(bottom, solver._trail[1].edge);
+  EXPECT_EQ(std::vector<uint32_t>({ 0 }), std::vector<uint32_t>(
+    solver._reasons.begin() + solver._reasonStarts[1],
+    solver._reasons.begin() + solver._reasonStarts[2]));
+
+  // A double bridge anyway satisfies the other nogood completely
+  Bridge* oldBridge = nullptr;
+  Bridge* bridge = game.connect(topLeft, topRight, false, &oldBridge);
+  solver._trail.push(bridge, oldBridge);
+  solver.clearFacts();
+  solver.explain();
+  EXPECT_FALSE(solver.checkNogoods(3));
+  EXPECT_EQ(3, solver.statistics().prunes);
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, connectCuts) {
+  // Two squares, the gap between the middle ones and the one below them
+  // are the only ways from one to the other
+  Game game({
+    Island(4, 0, 2),
+    Island(6, 0, 2),
+    Island(0, 2, 2),
+    Island(2, 2, 3),
+    Island(4, 2, 3),
+    Island(6, 2, 2),
+    Island(0, 4, 2),
+    Island(2, 4, 3),
+    Island(4, 4, 1)
+  });
+  auto topLeft = game.getIsland(0, 2);
+  auto left = game.getIsland(2, 2);
+  auto right = game.getIsland(4, 2);
+  auto bottomLeft = game.getIsland(0, 4);
+  auto bottom = game.getIsland(2, 4);
+  auto below = game.getIsland(4, 4);
+  Solver solver(&game);
+  EXPECT_TRUE(solver.connectCuts());
+  EXPECT_EQ(0, solver._trail.size());
+
+  solver._trail.openLevel();
+  solver._trail.push(game.connect(topLeft, bottomLeft, false), nullptr);
+  solver.clearFacts();
+  solver.explain();
+  solver.clearFacts();
+  solver.addFact(0);
+  solver.forbid(bottom, below);
+  // Once the lower gap is forbidden, the middle one is a cut edge, and
+  // so is the only gap left at the Island below
+  EXPECT_TRUE(solver.connectCuts());
+  ASSERT_EQ(4, solver._trail.size());
+  EXPECT_EQ(1, left->isConnected(right));
+  EXPECT_EQ(1, right->isConnected(below));
+  EXPECT_EQ(2, solver.statistics().cuts);
+  size_t middle = Game::edgeId(solver._trail[2].bridge)
+    == Game::edgeId(left, right) ? 2 : 3;
+  EXPECT_EQ(1, solver._depths[middle]);
+  EXPECT_EQ(std::vector<uint32_t>({ 1 }), std::vector<uint32_t>(
+    solver._reasons.begin() + solver._reasonStarts[middle],
+    solver._reasons.begin() + solver._reasonStarts[middle + 1]));
+  solver.revertLevel();
+
+  // Without both gaps the board falls apart
+  solver.clearFacts();
+  solver.forbid(left, right);
+  solver.forbid(bottom, below);
+  EXPECT_FALSE(solver.connectCuts());
+  EXPECT_TRUE(solver._conflict.empty());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, narrowDomains) {
+  Game game({
+    Island(1, 0, 2),
+    Island(0, 1, 3),
+    Island(2, 1, 2),
+    Island(1, 2, 2),
+    Island(0, 3, 2)
+  });
+  auto top = game.getIsland(1, 0);
+  auto left = game.getIsland(0, 1);
+  auto right = game.getIsland(2, 1);
+  auto bottom = game.getIsland(1, 2);
+  auto below = game.getIsland(0, 3);
+  uint32_t vertical = Game::edgeId(top, bottom);
+  uint32_t down = Game::edgeId(left, below);
+  Solver solver(&game);
+  // Both gaps could close a group on their own with a double bridge
+  EXPECT_EQ(3, solver._domains[vertical]);
+  EXPECT_EQ(Domains::ALL, solver._domains[down]);
+
+  solver._trail.openLevel();
+  solver._trail.push(game.connect(left, right, true), nullptr);
+  solver.clearFacts();
+  solver.explain();
+  solver.narrowDomains(0);
+  // The bridge crosses the vertical gap and leaves one connection for
+  // the other gap of the left Island
+  ASSERT_EQ(3, solver._trail.size());
+  EXPECT_EQ(Trail::Kind::DOMAIN, solver._trail[1].kind);
+  EXPECT_EQ(vertical, solver._trail[1].edge);
+  EXPECT_EQ(3, solver._trail[1].domain);
+  EXPECT_EQ(1, solver._domains[vertical]);
+  EXPECT_EQ(1, solver._domainEntries[vertical]);
+  EXPECT_EQ(down, solver._trail[2].edge);
+  EXPECT_EQ(Domains::ALL, solver._trail[2].domain);
+  EXPECT_EQ(3, solver._domains[down]);
+  EXPECT_EQ(2, solver._domainEntries[down]);
+  for (size_t i = 1; i < 3; i++) {
+    EXPECT_EQ(1, solver._depths[i]);
+    EXPECT_EQ(std::vector<uint32_t>({ 0 }), std::vector<uint32_t>(
+      solver._reasons.begin() + solver._reasonStarts[i],
+      solver._reasons.begin() + solver._reasonStarts[i + 1]));
+  }
+  // Nothing changes the second time
+  solver.narrowDomains(0);
+  EXPECT_EQ(3, solver._trail.size());
+
+  solver.revertLevel();
+  EXPECT_EQ(0, solver._trail.size());
+  EXPECT_EQ(3, solver._domains[vertical]);
+  EXPECT_EQ(Domains::ALL, solver._domains[down]);
+  EXPECT_EQ(UINT32_MAX, solver._domainEntries[vertical]);
+  EXPECT_EQ(UINT32_MAX, solver._domainEntries[down]);
+
+  Game group({
+    Island(0, 0, 2),
+    Island(2, 0, 1),
+    Island(0, 2, 1),
+    Island(4, 4, 1)
+  });
+  auto corner = group.getIsland(0, 0);
+  auto side = group.getIsland(2, 0);
+  uint32_t gap = Game::edgeId(corner, side);
+  Solver other(&group);
+  other._trail.push(group.connect(corner, group.getIsland(0, 2), false),
+    nullptr);
+  other.clearFacts();
+  other.explain();
+  other.narrowDomains(0);
+  EXPECT_EQ(1, other._trail.size());
+  EXPECT_EQ(3, other._domains[gap]);
+  // A bridge to the Island on the side would close the group of the
+  // three Islands, that Island is analyzed again
+  other._queue.clear();
+  other.narrowConnectivity(corner);
+  ASSERT_EQ(2, other._trail.size());
+  EXPECT_EQ(Trail::Kind::DOMAIN, other._trail[1].kind);
+  EXPECT_EQ(gap, other._trail[1].edge);
+  EXPECT_EQ(1, other._domains[gap]);
+  EXPECT_EQ(1, other._domainEntries[gap]);
+  EXPECT_EQ(side->index(), other._queue.pop());
+  EXPECT_TRUE(other._queue.empty());
+  // The SmartConnector reads the domains
+  SmartConnector smart(&group, corner, other._domains);
+  EXPECT_EQ(0, smart.availableConnections());
+}
+
+// _____________________________________________________________________________
+
+TEST(SolverTest, solveBranching) {
+  for (auto branching : { Solver::Branching::INPUT,
+    Solver::Branching::MOST_CONSTRAINED, Solver::Branching::FEWEST_OPTIONS,
+    Solver::Branching::MAX_DEGREE }) {
+    // Nothing is forced here, the search has to decide
+    Game game({
+      Island(0, 0, 3),
+      Island(2, 0, 3),
+      Island(0, 2, 3),
+      Island(2, 2, 3)
+    });
+    Solver solver(&game, branching);
+    EXPECT_TRUE(solver.solve());
+    EXPECT_TRUE(game.isSolved());
+    auto statistics = solver.statistics();
+    EXPECT_LE(2, statistics.nodes);
+    EXPECT_LE(1, statistics.decisions);
+    EXPECT_EQ(statistics.nodes, statistics.decisions + 1);
+    EXPECT_GE(statistics.decisions, statistics.backtracks);
+  }
 }
 
 
@@ -298,29 +1284,33 @@ TEST(SolverTest, solvePrivate) {
   auto middleIsland = game.getIsland(2, 2);
   auto topIsland = game.getIsland(2, 0);
   auto leftIsland = game.getIsland(0, 2);
-  auto bottomIsland = game.getIsland(2, 4);
 
-  std::deque<std::pair<Bridge*, Bridge*>> steps;
   Solver solver(&game);
+  solver.forbid(leftIsland, middleIsland);
+  solver.enqueueAll();
   EXPECT_FALSE(solver.solve({
     // Even though we effectively only provide 2 Islands
     // al neighbour Islands should be tested as well.
     std::make_tuple(topIsland, middleIsland, &Direction::DOWN),
     std::make_tuple(leftIsland, middleIsland, &Direction::LEFT)
-  }, {
-    { leftIsland, middleIsland }
-  }, &steps));
+  }));
   EXPECT_FALSE(game.isSolved());
 
+  // Islands are visited in the order they were passed to the Game, so
+  // the top Island is connected before the left one reveals the contradiction
+  // after the initially forbidden gap
+  const Trail &steps = solver._trail;
   ASSERT_EQ(2, steps.size());
+  EXPECT_EQ(Trail::Kind::FORBIDDEN, steps[0].kind);
 
-  EXPECT_TRUE(steps[0].first->_doubleBridge);
-  ASSERT_EQ(1, bottomIsland->_bridges.size());
-  EXPECT_EQ(bottomIsland->_bridges[0], steps[0].first);
-  EXPECT_EQ(middleIsland->_bridges[0], steps[0].first);
-  EXPECT_EQ(nullptr, steps[0].second);
+  EXPECT_EQ(Trail::Kind::CONNECTION, steps[1].kind);
+  EXPECT_TRUE(steps[1].bridge->_doubleBridge);
+  ASSERT_EQ(1, topIsland->bridgeCount());
+  EXPECT_EQ(topIsland->_bridges[Direction::DOWN._index], steps[1].bridge);
+  EXPECT_EQ(middleIsland->_bridges[Direction::UP._index], steps[1].bridge);
+  EXPECT_EQ(nullptr, steps[1].replaced);
 
-  ASSERT_EQ(0, leftIsland->_bridges.size());
+  ASSERT_EQ(0, leftIsland->bridgeCount());
 }
 
 // _____________________________________________________________________________
@@ -339,16 +1329,11 @@ TEST(SmartConnectorTest, constructor) {
   auto rightIsland = game.getIsland(4, 2);
   auto bottomIsland = game.getIsland(2, 4);
 
-  // The constructor expects a specific scheme from
-  // the forbidden multimap in order to avoid duplicates
-  // therefore only 2 of those forbidden connections should
-  // actually be ignored
-  SmartConnector smartConnector(&game, middleIsland, {
-    { middleIsland, topIsland },
-    { middleIsland, leftIsland },
-    { middleIsland, rightIsland },
+  // The order of the Islands of a forbidden gap doesn't matter
+  SmartConnector smartConnector(&game, middleIsland, forbiddenDomains(game, {
+    { rightIsland, middleIsland },
     { middleIsland, bottomIsland }
-  });
+  }));
   EXPECT_EQ(&game, smartConnector._game);
   EXPECT_EQ(middleIsland, smartConnector._island);
 
@@ -365,62 +1350,6 @@ TEST(SmartConnectorTest, constructor) {
 
 // _____________________________________________________________________________
 
-TEST(SmartConnectorTest, maxBandwidthRegardingForbidden) {
-  Game game({
-    Island(2, 0, 1),
-    Island(0, 2, 3),
-    Island(2, 2, 2)
-  });
-  auto middleIsland = game.getIsland(2, 2);
-  auto topIsland = game.getIsland(2, 0);
-  auto leftIsland = game.getIsland(0, 2);
-
-  SmartConnector smartConnector(&game, middleIsland, {});
-  EXPECT_EQ(0, smartConnector.maxBandwidthRegardingForbidden(
-    topIsland, middleIsland, { { topIsland, middleIsland } }));
-  EXPECT_EQ(1, smartConnector.maxBandwidthRegardingForbidden(
-    topIsland, middleIsland, { { middleIsland, topIsland } }));
-
-  EXPECT_EQ(0, smartConnector.maxBandwidthRegardingForbidden(
-    leftIsland, middleIsland, { { leftIsland, middleIsland } }));
-  EXPECT_EQ(2, smartConnector.maxBandwidthRegardingForbidden(
-    leftIsland, middleIsland, { { middleIsland, leftIsland } }));
-}
-
-// _____________________________________________________________________________
-
-TEST(SmartConnectorTest, createPair) {
-  Game game({
-    Island(2, 0, 1),
-    Island(0, 2, 3),
-    Island(2, 2, 2)
-  });
-  auto middleIsland = game.getIsland(2, 2);
-  auto topIsland = game.getIsland(2, 0);
-  auto leftIsland = game.getIsland(0, 2);
-
-  SmartConnector smartConnector(&game, middleIsland, {});
-  auto result1 = smartConnector.createPair(
-    topIsland, middleIsland, { { topIsland, middleIsland } });
-  EXPECT_EQ(topIsland, result1.first);
-  EXPECT_EQ(0, result1.second);
-  auto result2 = smartConnector.createPair(
-    middleIsland, topIsland, { { topIsland, middleIsland } });
-  EXPECT_EQ(topIsland, result2.first);
-  EXPECT_EQ(1, result2.second);
-
-  auto result3 = smartConnector.createPair(
-    leftIsland, middleIsland, { { leftIsland, middleIsland } });
-  EXPECT_EQ(leftIsland, result3.first);
-  EXPECT_EQ(0, result3.second);
-  auto result4 = smartConnector.createPair(
-    middleIsland, leftIsland, { { leftIsland, middleIsland } });
-  EXPECT_EQ(leftIsland, result4.first);
-  EXPECT_EQ(2, result4.second);
-}
-
-// _____________________________________________________________________________
-
 TEST(SmartConnectorTest, createNeighbours) {
   Game game({
     Island(2, 0, 2),
@@ -435,14 +1364,13 @@ TEST(SmartConnectorTest, createNeighbours) {
   auto rightIsland = game.getIsland(4, 2);
   auto bottomIsland = game.getIsland(2, 4);
 
-  SmartConnector smartConnector(&game, middleIsland, {});
+  SmartConnector smartConnector(&game, middleIsland,
+    forbiddenDomains(game, {}));
 
-  auto result = smartConnector.createNeighbours({
+  auto result = smartConnector.createNeighbours(forbiddenDomains(game, {
     { topIsland, middleIsland },
-    { leftIsland, middleIsland },
-    { rightIsland, middleIsland },
-    { bottomIsland, middleIsland }
-  });
+    { middleIsland, leftIsland }
+  }));
 
   ASSERT_EQ(4, result.size());
   EXPECT_EQ(topIsland, result[0].first);
@@ -475,27 +1403,28 @@ TEST(SmartConnectorTest, reversedFindConnection) {
 
   game.connect(topLeftIsland, topIsland, false);
 
-  SmartConnector smartConnector(&game, middleIsland, {});
+  SmartConnector smartConnector(&game, middleIsland,
+    forbiddenDomains(game, {}));
 
-  std::deque<std::pair<Bridge*, Bridge*>> steps;
+  Trail steps(8, 0);
   smartConnector.reversedFindConnection(5, &steps);
 
-  EXPECT_EQ(1, topLeftIsland->_bridges.size());
-  EXPECT_EQ(2, topIsland->_bridges.size());
-  EXPECT_EQ(2, middleIsland->_bridges.size());
-  EXPECT_EQ(0, leftIsland->_bridges.size());
-  EXPECT_EQ(1, rightIsland->_bridges.size());
-  EXPECT_EQ(0, bottomIsland->_bridges.size());
+  EXPECT_EQ(1, topLeftIsland->bridgeCount());
+  EXPECT_EQ(2, topIsland->bridgeCount());
+  EXPECT_EQ(2, middleIsland->bridgeCount());
+  EXPECT_EQ(0, leftIsland->bridgeCount());
+  EXPECT_EQ(1, rightIsland->bridgeCount());
+  EXPECT_EQ(0, bottomIsland->bridgeCount());
 
   ASSERT_EQ(2, steps.size());
-  EXPECT_EQ(middleIsland, steps[0].first->_one);
-  EXPECT_EQ(topIsland, steps[0].first->_two);
-  EXPECT_FALSE(steps[0].first->_doubleBridge);
-  EXPECT_EQ(nullptr, steps[0].second);
-  EXPECT_EQ(middleIsland, steps[1].first->_one);
-  EXPECT_EQ(rightIsland, steps[1].first->_two);
-  EXPECT_FALSE(steps[1].first->_doubleBridge);
-  EXPECT_EQ(nullptr, steps[1].second);
+  EXPECT_EQ(middleIsland, steps[0].bridge->_one);
+  EXPECT_EQ(topIsland, steps[0].bridge->_two);
+  EXPECT_FALSE(steps[0].bridge->_doubleBridge);
+  EXPECT_EQ(nullptr, steps[0].replaced);
+  EXPECT_EQ(middleIsland, steps[1].bridge->_one);
+  EXPECT_EQ(rightIsland, steps[1].bridge->_two);
+  EXPECT_FALSE(steps[1].bridge->_doubleBridge);
+  EXPECT_EQ(nullptr, steps[1].replaced);
 }
 
 // _____________________________________________________________________________
@@ -516,7 +1445,8 @@ TEST(SmartConnectorTest, findReverseConnectIslands) {
 
   game.connect(topLeftIsland, topIsland, false);
 
-  SmartConnector smartConnector(&game, middleIsland, {});
+  SmartConnector smartConnector(&game, middleIsland,
+    forbiddenDomains(game, {}));
 
   auto result = smartConnector.findReverseConnectIslands(4);
 
@@ -546,35 +1476,35 @@ TEST(SmartConnectorTest, connectSmart) {
 
   game.connect(i20, i50, true);
 
-  SmartConnector smartConnector(&game, middleIsland, {
+  SmartConnector smartConnector(&game, middleIsland, forbiddenDomains(game, {
     { middleIsland, i42 }
-  });
+  }));
 
-  std::deque<std::pair<Bridge*, Bridge*>> steps;
+  Trail steps(8, 0);
   EXPECT_TRUE(smartConnector.connectSmart(4, &steps));
 
   ASSERT_EQ(2, steps.size());
-  EXPECT_FALSE(steps[0].first->_doubleBridge);
-  EXPECT_EQ(middleIsland, steps[0].first->_one);
-  EXPECT_EQ(i24, steps[0].first->_two);
-  EXPECT_EQ(nullptr, steps[0].second);
-  EXPECT_FALSE(steps[1].first->_doubleBridge);
-  EXPECT_EQ(middleIsland, steps[1].first->_one);
-  EXPECT_EQ(i02, steps[1].first->_two);
-  EXPECT_EQ(nullptr, steps[1].second);
-
-  SmartConnector smartConnector2(&game, middleIsland, {
+  EXPECT_FALSE(steps[0].bridge->_doubleBridge);
+  EXPECT_EQ(middleIsland, steps[0].bridge->_one);
+  EXPECT_EQ(i24, steps[0].bridge->_two);
+  EXPECT_EQ(nullptr, steps[0].replaced);
+  EXPECT_FALSE(steps[1].bridge->_doubleBridge);
+  EXPECT_EQ(middleIsland, steps[1].bridge->_one);
+  EXPECT_EQ(i02, steps[1].bridge->_two);
+  EXPECT_EQ(nullptr, steps[1].replaced);
+
+  SmartConnector smartConnector2(&game, middleIsland, forbiddenDomains(game, {
     { middleIsland, i42 }
-  });
+  }));
 
-  std::deque<std::pair<Bridge*, Bridge*>> steps2;
+  Trail steps2(8, 0);
   EXPECT_TRUE(smartConnector2.connectSmart(2, &steps2));
 
   ASSERT_EQ(1, steps2.size());
-  EXPECT_FALSE(steps2[0].first->_doubleBridge);
-  EXPECT_EQ(middleIsland, steps2[0].first->_one);
-  EXPECT_EQ(i20, steps2[0].first->_two);
-  EXPECT_EQ(nullptr, steps2[0].second);
+  EXPECT_FALSE(steps2[0].bridge->_doubleBridge);
+  EXPECT_EQ(middleIsland, steps2[0].bridge->_one);
+  EXPECT_EQ(i20, steps2[0].bridge->_two);
+  EXPECT_EQ(nullptr, steps2[0].replaced);
 }
 
 // _____________________________________________________________________________
@@ -600,9 +1530,10 @@ TEST(SmartConnectorTest, availableConnections) {
   game.connect(i10, i13, false);
   game.connect(i20, i50, true);
 
-  SmartConnector smartConnector(&game, middleIsland, {
+  SmartConnector smartConnector(&game, middleIsland, forbiddenDomains(game, {
     { middleIsland, i42 }
-  });
+  }));
 
   ASSERT_EQ(2, smartConnector.availableConnections());
+  ASSERT_EQ(2, smartConnector.openGaps());
 }
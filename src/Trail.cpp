@@ -0,0 +1,90 @@
+#include <vector>
+#include "./Trail.h"
+
+// _____________________________________________________________________________
+
+Trail::Trail(size_t entries, size_t levels) {
+  _entries.reserve(entries);
+  _levels.reserve(levels);
+}
+
+// _____________________________________________________________________________
+
+void Trail::push(Bridge* bridge, Bridge* replaced) {
+  _entries.push_back({Kind::CONNECTION, 0, 0, bridge, replaced});
+}
+
+// _____________________________________________________________________________
+
+void Trail::pushForbidden(uint32_t edge, uint8_t domain) {
+  _entries.push_back({Kind::FORBIDDEN, domain, edge, nullptr, nullptr});
+}
+
+// _____________________________________________________________________________
+
+void Trail::pushDomain(uint32_t edge, uint8_t domain) {
+  _entries.push_back({Kind::DOMAIN, domain, edge, nullptr, nullptr});
+}
+
+// _____________________________________________________________________________
+
+Trail::Entry Trail::pop() {
+  Entry entry = _entries.back();
+  _entries.pop_back();
+  return entry;
+}
+
+// _____________________________________________________________________________
+
+void Trail::openLevel() {
+  _levels.push_back(_entries.size());
+}
+
+// _____________________________________________________________________________
+
+void Trail::closeLevel() {
+  _levels.pop_back();
+}
+
+// _____________________________________________________________________________
+
+bool Trail::isLevelEmpty() const {
+  return _entries.size() == levelStart();
+}
+
+// _____________________________________________________________________________
+
+size_t Trail::levelStart() const {
+  return _levels.empty() ? 0 : _levels.back();
+}
+
+// _____________________________________________________________________________
+
+size_t Trail::levelStart(size_t level) const {
+  return level == 0 ? 0 : _levels[level - 1];
+}
+
+// _____________________________________________________________________________
+
+size_t Trail::level() const {
+  return _levels.size();
+}
+
+// _____________________________________________________________________________
+
+size_t Trail::size() const {
+  return _entries.size();
+}
+
+// _____________________________________________________________________________
+
+const Trail::Entry& Trail::operator[](size_t position) const {
+  return _entries[position];
+}
+
+// _____________________________________________________________________________
+
+void Trail::clear() {
+  _entries.clear();
+  _levels.clear();
+}
@@ -0,0 +1,94 @@
+#ifndef TRAIL_H_
+#define TRAIL_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Forward declaration, see Game.h
+class Bridge;
+
+// _____________________________________________________________________________
+
+// Undo log of a single search. Every change of the Game is recorded as one
+// entry, every decision opens a new level that remembers where its entries
+// start, so undoing a decision is a loop over the entries above that mark.
+// The storage is reserved once up front, so recording and undoing never
+// allocates as long as the search stays within the reserved size
+class Trail {
+  FRIEND_TEST(TrailTest, constructor);
+  FRIEND_TEST(TrailTest, levels);
+
+ public:
+  // The kinds of changes the trail records
+  enum class Kind : uint8_t { CONNECTION, FORBIDDEN, DOMAIN };
+
+  // A single change of the search, either a connection with the Bridge
+  // that has been connected and the Bridge it replaced, or nullptr if
+  // there was none, or the id of a gap that has been forbidden or whose
+  // domain (see Domains) has been narrowed together with the domain it
+  // had before
+  struct Entry {
+    Kind kind;
+    uint8_t domain;
+    uint32_t edge;
+    Bridge* bridge;
+    Bridge* replaced;
+  };
+
+  // Creates an empty trail with room for the given amount of entries
+  // and levels
+  Trail(size_t, size_t);
+
+  // Records a connected Bridge and the Bridge it replaced, if any
+  void push(Bridge*, Bridge*);
+
+  // Records the id of a gap that has been forbidden and its domain
+  // before, forbidding a gap narrows its domain as well
+  void pushForbidden(uint32_t, uint8_t);
+
+  // Records the id of a gap whose domain has been narrowed and its
+  // domain before
+  void pushDomain(uint32_t, uint8_t);
+
+  // Removes the last entry and returns it
+  Entry pop();
+
+  // Opens a new decision level starting at the current end of the trail
+  void openLevel();
+
+  // Closes the current decision level, all of its entries must
+  // have been popped before
+  void closeLevel();
+
+  // Returns true if the current level contains no entries
+  bool isLevelEmpty() const;
+
+  // Returns the amount of currently open levels
+  size_t level() const;
+
+  // Returns the position of the first entry of the current level
+  size_t levelStart() const;
+
+  // Returns the position of the first entry of the given open level,
+  // level 0 holds the entries recorded before the first level was opened
+  size_t levelStart(size_t) const;
+
+  // Returns the amount of entries on the trail
+  size_t size() const;
+
+  // Returns the entry at the given position, starting with the oldest
+  const Entry& operator[](size_t) const;
+
+  // Removes all entries and levels but keeps the reserved storage
+  void clear();
+
+ private:
+  // all recorded entries, the oldest first
+  std::vector<Entry> _entries;
+  // the size of _entries at the moment every open level was opened
+  std::vector<size_t> _levels;
+};
+
+#endif  // TRAIL_H_
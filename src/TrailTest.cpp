@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "./Trail.h"
+
+// _____________________________________________________________________________
+
+// The trail never dereferences the Bridges, so any distinct addresses will do
+static char dummy[3];
+static Bridge* const ONE = reinterpret_cast<Bridge*>(&dummy[0]);
+static Bridge* const TWO = reinterpret_cast<Bridge*>(&dummy[1]);
+static Bridge* const THREE = reinterpret_cast<Bridge*>(&dummy[2]);
+
+// _____________________________________________________________________________
+
+TEST(TrailTest, constructor) {
+  Trail trail(16, 4);
+  EXPECT_EQ(0, trail.size());
+  EXPECT_EQ(0, trail.level());
+  EXPECT_TRUE(trail.isLevelEmpty());
+  EXPECT_LE(16, trail._entries.capacity());
+  EXPECT_LE(4, trail._levels.capacity());
+}
+
+// _____________________________________________________________________________
+
+TEST(TrailTest, push) {
+  Trail trail(16, 4);
+  trail.push(ONE, nullptr);
+  trail.push(TWO, ONE);
+  trail.pushForbidden(7, 3);
+  trail.pushDomain(5, 7);
+  ASSERT_EQ(4, trail.size());
+  EXPECT_EQ(Trail::Kind::CONNECTION, trail[0].kind);
+  EXPECT_EQ(ONE, trail[0].bridge);
+  EXPECT_EQ(nullptr, trail[0].replaced);
+  EXPECT_EQ(TWO, trail[1].bridge);
+  EXPECT_EQ(ONE, trail[1].replaced);
+  EXPECT_EQ(Trail::Kind::FORBIDDEN, trail[2].kind);
+  EXPECT_EQ(7, trail[2].edge);
+  EXPECT_EQ(3, trail[2].domain);
+  EXPECT_EQ(Trail::Kind::DOMAIN, trail[3].kind);
+  EXPECT_EQ(5, trail[3].edge);
+  EXPECT_EQ(7, trail[3].domain);
+
+  Trail::Entry entry = trail.pop();
+  EXPECT_EQ(Trail::Kind::DOMAIN, entry.kind);
+  entry = trail.pop();
+  EXPECT_EQ(Trail::Kind::FORBIDDEN, entry.kind);
+  entry = trail.pop();
+  EXPECT_EQ(TWO, entry.bridge);
+  EXPECT_EQ(ONE, entry.replaced);
+  EXPECT_EQ(1, trail.size());
+}
+
+// _____________________________________________________________________________
+
+TEST(TrailTest, levels) {
+  Trail trail(16, 4);
+  trail.push(ONE, nullptr);
+  EXPECT_FALSE(trail.isLevelEmpty());
+
+  EXPECT_EQ(0, trail.levelStart());
+  trail.openLevel();
+  EXPECT_EQ(1, trail.level());
+  EXPECT_EQ(1, trail.levelStart());
+  EXPECT_TRUE(trail.isLevelEmpty());
+  trail.push(TWO, nullptr);
+  trail.push(THREE, TWO);
+  EXPECT_FALSE(trail.isLevelEmpty());
+  EXPECT_EQ(0, trail.levelStart(0));
+  EXPECT_EQ(1, trail.levelStart(1));
+
+  // Undo the level, the entry below it stays
+  EXPECT_EQ(THREE, trail.pop().bridge);
+  EXPECT_EQ(TWO, trail.pop().bridge);
+  EXPECT_TRUE(trail.isLevelEmpty());
+  trail.closeLevel();
+  EXPECT_EQ(0, trail.level());
+  EXPECT_EQ(1, trail.size());
+  EXPECT_EQ(ONE, trail[0].bridge);
+
+  const Trail::Entry* data = trail._entries.data();
+  trail.clear();
+  EXPECT_EQ(0, trail.size());
+  EXPECT_EQ(0, trail.level());
+  // The reserved storage is kept
+  EXPECT_EQ(data, trail._entries.data());
+}
@@ -0,0 +1,56 @@
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include "./TranspositionTable.h"
+
+// _____________________________________________________________________________
+
+TranspositionTable::TranspositionTable(size_t bytes) {
+  size_t capacity = 0;
+  // A single slot couldn't tell the hash 0 from 1, see key
+  if (bytes >= 2 * sizeof(uint64_t)) {
+    capacity = 2;
+    while (capacity * 2 * sizeof(uint64_t) <= bytes) {
+      capacity *= 2;
+    }
+    _slots.reset(new std::atomic<uint64_t>[capacity]);
+    _mask = capacity - 1;
+  }
+  clear();
+}
+
+// _____________________________________________________________________________
+
+uint64_t TranspositionTable::key(uint64_t hash) {
+  // 0 and 1 always end up in different slots
+  return hash == 0 ? 1 : hash;
+}
+
+// _____________________________________________________________________________
+
+bool TranspositionTable::contains(uint64_t hash) const {
+  return _slots && _slots[hash & _mask].load(std::memory_order_relaxed)
+    == key(hash);
+}
+
+// _____________________________________________________________________________
+
+void TranspositionTable::insert(uint64_t hash) {
+  if (_slots) {
+    _slots[hash & _mask].store(key(hash), std::memory_order_relaxed);
+  }
+}
+
+// _____________________________________________________________________________
+
+void TranspositionTable::clear() {
+  for (size_t i = 0; i < capacity(); i++) {
+    _slots[i].store(0, std::memory_order_relaxed);
+  }
+}
+
+// _____________________________________________________________________________
+
+size_t TranspositionTable::capacity() const {
+  return _slots ? _mask + 1 : 0;
+}
@@ -0,0 +1,48 @@
+#ifndef TRANSPOSITIONTABLE_H_
+#define TRANSPOSITIONTABLE_H_
+
+#include <gtest/gtest_prod.h>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+
+// _____________________________________________________________________________
+
+// Fixed-size table of the hashes (see Game#hash) of states the search
+// has proven to have no solution. Every hash has exactly one slot, a
+// new state simply overwrites the one stored there before, so the table
+// may forget states, but never claims a state it hasn't seen. The slots
+// are atomic, so Solvers on clones of the same Game may share a table
+class TranspositionTable {
+  FRIEND_TEST(TranspositionTableTest, constructor);
+
+ public:
+  // Creates an empty table with the largest power of two of slots that
+  // fits into the given amount of bytes, less than 2 slots store
+  // nothing
+  explicit TranspositionTable(size_t);
+
+  // Returns true if the state with the given hash is stored
+  bool contains(uint64_t) const;
+
+  // Stores the state with the given hash
+  void insert(uint64_t);
+
+  // Removes all states
+  void clear();
+
+  // Returns the amount of slots
+  size_t capacity() const;
+
+ private:
+  // one hash per slot, 0 marks an empty one
+  std::unique_ptr<std::atomic<uint64_t>[]> _slots;
+  // capacity() - 1, the slot of a hash are its lowest bits
+  uint64_t _mask = 0;
+
+  // Returns the value stored for the given hash, which is never 0
+  static uint64_t key(uint64_t);
+};
+
+#endif  // TRANSPOSITIONTABLE_H_
@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "./TranspositionTable.h"
+
+// _____________________________________________________________________________
+
+TEST(TranspositionTableTest, constructor) {
+  // Rounded down to a power of two
+  TranspositionTable table(100);
+  EXPECT_EQ(8, table.capacity());
+  EXPECT_EQ(7, table._mask);
+  for (uint64_t hash = 0; hash < 16; hash++) {
+    EXPECT_FALSE(table.contains(hash));
+  }
+
+  TranspositionTable empty(0);
+  EXPECT_EQ(0, empty.capacity());
+  empty.insert(42);
+  EXPECT_FALSE(empty.contains(42));
+  EXPECT_EQ(0, TranspositionTable(sizeof(uint64_t)).capacity());
+  EXPECT_EQ(2, TranspositionTable(3 * sizeof(uint64_t)).capacity());
+}
+
+// _____________________________________________________________________________
+
+TEST(TranspositionTableTest, insert) {
+  TranspositionTable table(4 * sizeof(uint64_t));
+  table.insert(5);
+  EXPECT_TRUE(table.contains(5));
+  // Same slot, but another state
+  EXPECT_FALSE(table.contains(1));
+  EXPECT_FALSE(table.contains(9));
+  // The hash 0 can be stored as well
+  table.insert(0);
+  EXPECT_TRUE(table.contains(0));
+  EXPECT_TRUE(table.contains(5));
+
+  // A state in the same slot replaces the old one
+  table.insert(9);
+  EXPECT_TRUE(table.contains(9));
+  EXPECT_FALSE(table.contains(5));
+
+  table.clear();
+  EXPECT_FALSE(table.contains(9));
+  EXPECT_FALSE(table.contains(0));
+}
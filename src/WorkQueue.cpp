@@ -0,0 +1,52 @@
+#include <vector>
+#include <cstdint>
+#include "./WorkQueue.h"
+
+// _____________________________________________________________________________
+
+WorkQueue::WorkQueue(size_t count):
+  _elements(count, 0), _queued(count, false), _head(0), _size(0) {}
+
+// _____________________________________________________________________________
+
+bool WorkQueue::push(uint32_t element) {
+  if (_queued[element]) {
+    return false;
+  }
+  _queued[element] = true;
+  // Every element is queued at most once, so the buffer can't overflow
+  _elements[(_head + _size) % _elements.size()] = element;
+  _size++;
+  return true;
+}
+
+// _____________________________________________________________________________
+
+uint32_t WorkQueue::pop() {
+  uint32_t element = _elements[_head];
+  _head = (_head + 1) % _elements.size();
+  _size--;
+  _queued[element] = false;
+  return element;
+}
+
+// _____________________________________________________________________________
+
+bool WorkQueue::empty() const {
+  return _size == 0;
+}
+
+// _____________________________________________________________________________
+
+size_t WorkQueue::size() const {
+  return _size;
+}
+
+// _____________________________________________________________________________
+
+void WorkQueue::clear() {
+  while (!empty()) {
+    pop();
+  }
+  _head = 0;
+}
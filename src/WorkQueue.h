@@ -0,0 +1,48 @@
+#ifndef WORKQUEUE_H_
+#define WORKQUEUE_H_
+
+#include <gtest/gtest_prod.h>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// _____________________________________________________________________________
+
+// First-in-first-out queue over the elements 0 to n - 1 that contains
+// every element at most once. The elements are stored in a ring buffer
+// with room for all of them, so pushing and popping never allocates
+class WorkQueue {
+  FRIEND_TEST(WorkQueueTest, constructor);
+  FRIEND_TEST(WorkQueueTest, wrapAround);
+
+ public:
+  // Creates an empty queue for the elements 0 to n - 1
+  explicit WorkQueue(size_t);
+
+  // Appends the element, returns false if it already is queued
+  bool push(uint32_t);
+
+  // Removes the oldest element and returns it, the queue must not be empty
+  uint32_t pop();
+
+  // Returns true if no element is queued
+  bool empty() const;
+
+  // Returns the amount of queued elements
+  size_t size() const;
+
+  // Removes all elements
+  void clear();
+
+ private:
+  // ring buffer of the queued elements
+  std::vector<uint32_t> _elements;
+  // whether every element is currently queued
+  std::vector<bool> _queued;
+  // position of the oldest element in the ring buffer
+  size_t _head;
+  // amount of queued elements
+  size_t _size;
+};
+
+#endif  // WORKQUEUE_H_
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "./WorkQueue.h"
+
+// _____________________________________________________________________________
+
+TEST(WorkQueueTest, constructor) {
+  WorkQueue queue(5);
+  EXPECT_TRUE(queue.empty());
+  EXPECT_EQ(0, queue.size());
+  EXPECT_EQ(5, queue._elements.size());
+  EXPECT_EQ(5, queue._queued.size());
+}
+
+// _____________________________________________________________________________
+
+TEST(WorkQueueTest, pushPop) {
+  WorkQueue queue(5);
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_TRUE(queue.push(1));
+  EXPECT_FALSE(queue.push(3));
+  EXPECT_TRUE(queue.push(4));
+  EXPECT_EQ(3, queue.size());
+
+  EXPECT_EQ(3, queue.pop());
+  // Popped elements can be queued again
+  EXPECT_TRUE(queue.push(3));
+  EXPECT_EQ(1, queue.pop());
+  EXPECT_EQ(4, queue.pop());
+  EXPECT_EQ(3, queue.pop());
+  EXPECT_TRUE(queue.empty());
+
+  queue.push(0);
+  queue.push(2);
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_TRUE(queue.push(0));
+  EXPECT_EQ(0, queue.pop());
+}
+
+// _____________________________________________________________________________
+
+TEST(WorkQueueTest, wrapAround) {
+  WorkQueue queue(3);
+  for (uint32_t round = 0; round < 10; round++) {
+    EXPECT_TRUE(queue.push(round % 3));
+    EXPECT_TRUE(queue.push((round + 1) % 3));
+    EXPECT_EQ(round % 3, queue.pop());
+    EXPECT_EQ((round + 1) % 3, queue.pop());
+    EXPECT_LT(queue._head, 3);
+  }
+  EXPECT_TRUE(queue.empty());
+}